@@ -0,0 +1,237 @@
+// JSON 控制协议字段分发基准（主机上运行，不参与固件构建）
+//
+// 对比两种分发方式在同一批已解析文档上的耗时：
+//   legacy  - 原实现：按处理顺序对对象逐个 containsKey / operator[]（每次线性扫描），
+//             运动模式名先转小写再与名字表逐个比较
+//   fields  - cmdkeys::Fields 单遍收集 + 完美哈希（src/command_keys.h）
+// 消息组合模拟 Web 遥控的实际流量：摇杆/按钮指令为主，夹杂单动作、序列、单腿输入和停止。
+//
+// 编译运行（在 firmware 目录下）：
+//   g++ -std=gnu++11 -O2 -Isrc -Ilib/ArduinoJson/src -DARDUINOJSON_ENABLE_ARDUINO_STRING=0 bench/command_dispatch_bench.cpp src/command_keys.cpp -o /tmp/command_dispatch_bench
+//   /tmp/command_dispatch_bench
+
+#include <ArduinoJson.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "command_keys.h"
+
+namespace {
+
+struct Sample {
+  const char* json;
+  int weight;  // 每 100 条消息中的条数
+};
+
+const Sample kMix[] = {
+  {"{\"movementMode\":2,\"speed\":1.2}", 45},
+  {"{\"movementMode\":0}", 15},
+  {"{\"speedLevel\":2}", 10},
+  {"{\"movementMode\":\"turn_left\",\"angle\":90,\"priority\":\"user\"}", 10},
+  {"{\"sequence\":[{\"mode\":\"forward\",\"steps\":4},{\"mode\":\"TurnLeft\",\"angle\":45},"
+   "{\"mode\":\"shift_right\",\"distance\":0.2},{\"mode\":\"standby\",\"cycles\":1}],"
+   "\"sequenceId\":42,\"append\":false}", 5},
+  {"{\"singleLeg\":{\"op\":\"input\",\"lx\":0.1,\"ly\":-0.2,\"rz\":0}}", 10},
+  {"{\"stop\":true}", 5},
+};
+
+struct LegacyModeName {
+  const char* name;
+  hexapod::MovementMode mode;
+};
+
+const LegacyModeName kLegacyModeNames[] = {
+  {"standby", hexapod::MOVEMENT_STANDBY}, {"forward", hexapod::MOVEMENT_FORWARD},
+  {"forwardfast", hexapod::MOVEMENT_FORWARDFAST}, {"forward_fast", hexapod::MOVEMENT_FORWARDFAST},
+  {"backward", hexapod::MOVEMENT_BACKWARD}, {"turnleft", hexapod::MOVEMENT_TURNLEFT},
+  {"turn_left", hexapod::MOVEMENT_TURNLEFT}, {"turnright", hexapod::MOVEMENT_TURNRIGHT},
+  {"turn_right", hexapod::MOVEMENT_TURNRIGHT}, {"shiftleft", hexapod::MOVEMENT_SHIFTLEFT},
+  {"shift_left", hexapod::MOVEMENT_SHIFTLEFT}, {"shiftright", hexapod::MOVEMENT_SHIFTRIGHT},
+  {"shift_right", hexapod::MOVEMENT_SHIFTRIGHT}, {"climb", hexapod::MOVEMENT_CLIMB},
+  {"rotatex", hexapod::MOVEMENT_ROTATEX}, {"rotate_x", hexapod::MOVEMENT_ROTATEX},
+  {"rotatey", hexapod::MOVEMENT_ROTATEY}, {"rotate_y", hexapod::MOVEMENT_ROTATEY},
+  {"rotatez", hexapod::MOVEMENT_ROTATEZ}, {"rotate_z", hexapod::MOVEMENT_ROTATEZ},
+  {"twist", hexapod::MOVEMENT_TWIST}, {"beatsway", hexapod::MOVEMENT_BEATSWAY},
+  {"beat_sway", hexapod::MOVEMENT_BEATSWAY},
+};
+
+
+int legacyMode(JsonVariantConst value) {
+  if (value.is<int>()) {
+    return value.as<int>();
+  }
+  if (!value.is<const char*>()) {
+    return -1;
+  }
+  std::string lower = value.as<const char*>();  // 原实现为 String + toLowerCase()
+  std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+  for (const LegacyModeName& entry : kLegacyModeNames) {
+    if (lower == entry.name) {
+      return static_cast<int>(entry.mode);
+    }
+  }
+  return -1;
+}
+
+// 原 handleAdvancedMotionCommand + buildActionFromJson + 基础指令的探测顺序
+uint32_t legacyAction(JsonVariantConst obj) {
+  uint32_t acc = 0;
+  JsonVariantConst modeField = obj["movementMode"];
+  if (modeField.isNull()) {
+    modeField = obj["mode"];
+  }
+  acc += legacyMode(modeField);
+  if (obj.containsKey("speedOverride")) acc += obj["speedOverride"].as<int>();
+  if (obj.containsKey("durationMs")) return acc;
+  if (obj.containsKey("cycles")) acc += obj["cycles"].as<int>();
+  else if (obj.containsKey("steps")) acc += obj["steps"].as<int>();
+  else if (obj.containsKey("distance")) acc += 1;
+  else if (obj.containsKey("angle")) acc += obj["angle"].as<int>();
+  return acc;
+}
+
+uint32_t legacyDispatch(JsonVariantConst json) {
+  uint32_t acc = 0;
+  if (json.containsKey("stop") && json["stop"].as<bool>()) return 1;
+  if (json.containsKey("clearQueue") && json["clearQueue"].as<bool>()) return 2;
+  if (json.containsKey("cancelSequence")) return 3;
+  if (json.containsKey("singleLeg")) {
+    JsonObjectConst leg = json["singleLeg"];
+    return 4 + (leg["lx"] | 0.0f) * 10;
+  }
+  if (json.containsKey("performance")) return 5;
+  if (json.containsKey("sequence")) {
+    for (JsonVariantConst item : json["sequence"].as<JsonArrayConst>()) {
+      acc += legacyAction(item);
+    }
+    acc += json["priority"].isNull() ? 0 : 1;
+    acc += json["append"] | false;
+    acc += json["sequenceId"] | 0U;
+    return acc;
+  }
+  if (json.containsKey("cycles") || json.containsKey("steps") || json.containsKey("distance")
+      || json.containsKey("angle")) {
+    acc += legacyAction(json);
+    acc += json["priority"].isNull() ? 0 : 1;
+    acc += json.containsKey("sequenceId");
+    acc += json["append"] | false;
+    return acc;
+  }
+  if (json.containsKey("movementMode")) acc += json["movementMode"].as<int>();
+  if (json.containsKey("speed")) acc += json["speed"].as<int>();
+  if (json.containsKey("speedLevel")) acc += json["speedLevel"].as<int>();
+  if (json.containsKey("gaitMode")) acc += json["gaitMode"].as<int>();
+  return acc;
+}
+
+int fieldsMode(JsonVariantConst value) {
+  if (value.is<int>()) {
+    return value.as<int>();
+  }
+  hexapod::MovementMode mode;
+  return cmdkeys::lookupMovementMode(value.as<const char*>(), mode) ? static_cast<int>(mode) : -1;
+}
+
+uint32_t fieldsAction(const cmdkeys::Fields& f) {
+  using cmdkeys::Key;
+  uint32_t acc = 0;
+  JsonVariantConst modeField = f[Key::MovementMode];
+  if (modeField.isNull()) {
+    modeField = f[Key::Mode];
+  }
+  acc += fieldsMode(modeField);
+  if (f.has(Key::SpeedOverride)) acc += f[Key::SpeedOverride].as<int>();
+  if (f.has(Key::DurationMs)) return acc;
+  if (f.has(Key::Cycles)) acc += f[Key::Cycles].as<int>();
+  else if (f.has(Key::Steps)) acc += f[Key::Steps].as<int>();
+  else if (f.has(Key::Distance)) acc += 1;
+  else if (f.has(Key::Angle)) acc += f[Key::Angle].as<int>();
+  return acc;
+}
+
+uint32_t fieldsDispatch(JsonVariantConst json) {
+  using cmdkeys::Key;
+  const cmdkeys::Fields f(json.as<JsonObjectConst>());
+  uint32_t acc = 0;
+  if (f.has(Key::Stop) && f[Key::Stop].as<bool>()) return 1;
+  if (f.has(Key::ClearQueue) && f[Key::ClearQueue].as<bool>()) return 2;
+  if (f.has(Key::CancelSequence)) return 3;
+  if (f.has(Key::SingleLeg)) {
+    JsonObjectConst leg = f[Key::SingleLeg];
+    return 4 + (leg["lx"] | 0.0f) * 10;
+  }
+  if (f.has(Key::Performance)) return 5;
+  if (f.has(Key::Sequence)) {
+    for (JsonVariantConst item : f[Key::Sequence].as<JsonArrayConst>()) {
+      acc += fieldsAction(cmdkeys::Fields(item.as<JsonObjectConst>()));
+    }
+    acc += f[Key::Priority].isNull() ? 0 : 1;
+    acc += f[Key::Append] | false;
+    acc += f[Key::SequenceId] | 0U;
+    return acc;
+  }
+  if (f.has(Key::Cycles) || f.has(Key::Steps) || f.has(Key::Distance) || f.has(Key::Angle)) {
+    acc += fieldsAction(f);
+    acc += f[Key::Priority].isNull() ? 0 : 1;
+    acc += f.has(Key::SequenceId);
+    acc += f[Key::Append] | false;
+    return acc;
+  }
+  if (f.has(Key::MovementMode)) acc += f[Key::MovementMode].as<int>();
+  if (f.has(Key::Speed)) acc += f[Key::Speed].as<int>();
+  if (f.has(Key::SpeedLevel)) acc += f[Key::SpeedLevel].as<int>();
+  if (f.has(Key::GaitMode)) acc += f[Key::GaitMode].as<int>();
+  return acc;
+}
+
+template <typename Fn>
+double run(const std::vector<DynamicJsonDocument>& docs, const std::vector<size_t>& order,
+           int rounds, Fn fn, uint32_t& checksum) {
+  checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (size_t i : order) {
+      checksum += fn(docs[i].as<JsonVariantConst>());
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / (double(rounds) * order.size());
+}
+
+}  // namespace
+
+int main() {
+  std::vector<DynamicJsonDocument> docs;
+  std::vector<size_t> order;
+  for (size_t i = 0; i < sizeof(kMix) / sizeof(kMix[0]); ++i) {
+    docs.emplace_back(2048);
+    deserializeJson(docs.back(), kMix[i].json);
+    for (int w = 0; w < kMix[i].weight; ++w) {
+      order.push_back(i);
+    }
+  }
+  // 固定种子打乱，避免同类消息连续出现
+  uint32_t rng = 12345;
+  for (size_t i = order.size() - 1; i > 0; --i) {
+    rng = rng * 1664525u + 1013904223u;
+    std::swap(order[i], order[rng % (i + 1)]);
+  }
+
+  const int rounds = 20000;
+  uint32_t legacySum = 0;
+  uint32_t fieldsSum = 0;
+  const double legacyNs = run(docs, order, rounds, legacyDispatch, legacySum);
+  const double fieldsNs = run(docs, order, rounds, fieldsDispatch, fieldsSum);
+
+  printf("messages/round: %zu, rounds: %d\n", order.size(), rounds);
+  printf("legacy : %7.1f ns/msg (checksum %u)\n", legacyNs, legacySum);
+  printf("fields : %7.1f ns/msg (checksum %u)\n", fieldsNs, fieldsSum);
+  printf("speedup: %.2fx\n", legacyNs / fieldsNs);
+  return legacySum == fieldsSum ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+// JSON 与 MessagePack 指令格式对比基准（主机上运行，不参与固件构建）
+//
+// 对同一条指令比较两种格式：
+//   bytes - 报文字节数（WebSocket 帧 / JsonCommand 报文的 payload）
+//   parse - 拷贝到接收缓冲后就地解析进与 jsonpool 的 WebSocket 指令文档同等容量的 StaticJsonDocument 的耗时
+// MessagePack 报文按 data/msgpack.js 的编码规则生成：整数取最短编码，小数为 float32。
+// 两种格式解析出的文档逐项比较（JSON 侧同样把小数截为 float），不一致时返回非 0。
+//
+// 编译运行（在 firmware 目录下）：
+//   g++ -std=gnu++11 -O2 -Ilib/ArduinoJson/src -DARDUINOJSON_ENABLE_ARDUINO_STRING=0 bench/msgpack_bench.cpp -o /tmp/msgpack_bench
+//   /tmp/msgpack_bench
+
+#include <ArduinoJson.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// jsonpool 的 WebSocket 指令文档为 3072 字节（ESP32 上指针 4 字节），主机上按指针宽度放大
+constexpr size_t kCommandDocSize = 3072 * sizeof(void*) / 4;
+
+struct Sample {
+  const char* name;
+  std::string json;
+};
+
+// 单腿摇杆输入（single_leg_panel.js 约 80ms 一条）
+const char kSingleLeg[] = "{\"singleLeg\":{\"op\":\"input\",\"lx\":0.35,\"ly\":-0.62,\"rz\":0.18}}";
+
+// 运动规划页下发的序列（actionToPayload 的结构，sequenceId 为用户填写的编号）
+std::string plannerSequence(int count) {
+  static const char* const kActions[] = {
+    "{\"movementMode\":\"forward\",\"steps\":4,\"speedOverride\":1.2}",
+    "{\"movementMode\":\"turn_left\",\"angle\":45}",
+    "{\"movementMode\":\"shift_right\",\"distance\":0.25,\"speedOverride\":0.8}",
+    "{\"movementMode\":\"twist\",\"cycles\":2}",
+  };
+  std::string out = "{\"sequenceId\":1024,\"sequence\":[";
+  for (int i = 0; i < count; ++i) {
+    if (i) {
+      out += ",";
+    }
+    out += kActions[i % 4];
+  }
+  out += "],\"append\":true}";
+  return out;
+}
+
+// 与 msgpack.js 一致：小数以 float32 发送
+void quantizeFloats(JsonVariant value) {
+  if (value.is<JsonObject>()) {
+    for (JsonPair kv : value.as<JsonObject>()) {
+      quantizeFloats(kv.value());
+    }
+  } else if (value.is<JsonArray>()) {
+    for (JsonVariant item : value.as<JsonArray>()) {
+      quantizeFloats(item);
+    }
+  } else if (value.is<double>() && !value.is<long>()) {
+    value.set(static_cast<float>(value.as<double>()));
+  }
+}
+
+template <typename Parse>
+double timeParse(const std::vector<char>& payload, int rounds, Parse parse) {
+  std::vector<char> work(payload.size() + 1);
+  StaticJsonDocument<kCommandDocSize> doc;
+  size_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    // 就地解析会改写输入，每轮重新拷贝（模拟新到达的一帧）
+    memcpy(work.data(), payload.data(), payload.size());
+    if (parse(doc, work.data(), payload.size())) {
+      return -1.0;
+    }
+    checksum += doc.memoryUsage();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (checksum == 0) {
+    return -1.0;
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Sample> samples;
+  samples.push_back({"singleLeg input", kSingleLeg});
+  samples.push_back({"sequence x4", plannerSequence(4)});
+  samples.push_back({"sequence x32", plannerSequence(32)});
+
+  const int rounds = 200000;
+  int rc = 0;
+  printf("%-16s %10s %10s %8s %12s %12s %8s\n", "message", "json B", "msgpack B", "ratio", "json ns", "msgpack ns", "speedup");
+  for (const Sample& sample : samples) {
+    DynamicJsonDocument reference(kCommandDocSize);
+    if (deserializeJson(reference, sample.json)) {
+      printf("%s: invalid sample\n", sample.name);
+      return 1;
+    }
+    quantizeFloats(reference.as<JsonVariant>());
+
+    const std::vector<char> json(sample.json.begin(), sample.json.end());
+    std::vector<char> msgpack(measureMsgPack(reference));
+    serializeMsgPack(reference, msgpack.data(), msgpack.size());
+
+    const double jsonNs = timeParse(json, rounds, [](JsonDocument& doc, char* input, size_t length) {
+      return static_cast<bool>(deserializeJson(doc, input, length));
+    });
+    const double msgpackNs = timeParse(msgpack, rounds, [](JsonDocument& doc, char* input, size_t length) {
+      return static_cast<bool>(deserializeMsgPack(doc, input, length));
+    });
+
+    // 两种格式解析结果一致
+    std::vector<char> jsonWork(json.begin(), json.end());
+    std::vector<char> msgpackWork(msgpack.begin(), msgpack.end());
+    DynamicJsonDocument fromJson(kCommandDocSize);
+    DynamicJsonDocument fromMsgPack(kCommandDocSize);
+    deserializeJson(fromJson, jsonWork.data(), jsonWork.size());
+    deserializeMsgPack(fromMsgPack, msgpackWork.data(), msgpackWork.size());
+    quantizeFloats(fromJson.as<JsonVariant>());
+    const bool same = fromJson.as<JsonVariantConst>() == fromMsgPack.as<JsonVariantConst>();
+    if (!same || jsonNs < 0 || msgpackNs < 0) {
+      rc = 1;
+    }
+
+    printf("%-16s %10zu %10zu %7.2fx %12.1f %12.1f %7.2fx%s\n", sample.name, json.size(), msgpack.size(),
+           double(json.size()) / msgpack.size(), jsonNs, msgpackNs, jsonNs / msgpackNs, same ? "" : "  MISMATCH");
+  }
+  return rc;
+}
@@ -0,0 +1,206 @@
+(function(global) {
+  // /cmd WebSocket 的 MessagePack 编解码（与 JSON 指令结构相同，以二进制帧发送）
+  // 固件按帧类型识别格式，并以同一格式回送应答与事件（sequenceComplete、lowBattery 等）。
+  // 启用方式：页面地址加 ?wire=msgpack，或 localStorage.setItem('nodehexa.wire', 'msgpack')
+  const STORAGE_KEY = 'nodehexa.wire';
+  const textEncoder = new TextEncoder();
+  const textDecoder = new TextDecoder();
+
+  function isPreferred() {
+    try {
+      const params = new URLSearchParams(global.location.search);
+      if (params.has('wire')) {
+        return params.get('wire') === 'msgpack';
+      }
+      return global.localStorage.getItem(STORAGE_KEY) === 'msgpack';
+    } catch (_) {
+      return false;
+    }
+  }
+
+  function createWriter() {
+    let buffer = new Uint8Array(64);
+    let view = new DataView(buffer.buffer);
+    let length = 0;
+
+    function ensure(extra) {
+      if (length + extra <= buffer.length) return;
+      let size = buffer.length * 2;
+      while (size < length + extra) size *= 2;
+      const next = new Uint8Array(size);
+      next.set(buffer.subarray(0, length));
+      buffer = next;
+      view = new DataView(buffer.buffer);
+    }
+
+    return {
+      u8(value) { ensure(1); view.setUint8(length, value); length += 1; },
+      u16(value) { ensure(2); view.setUint16(length, value); length += 2; },
+      u32(value) { ensure(4); view.setUint32(length, value); length += 4; },
+      i8(value) { ensure(1); view.setInt8(length, value); length += 1; },
+      i16(value) { ensure(2); view.setInt16(length, value); length += 2; },
+      i32(value) { ensure(4); view.setInt32(length, value); length += 4; },
+      f32(value) { ensure(4); view.setFloat32(length, value); length += 4; },
+      f64(value) { ensure(8); view.setFloat64(length, value); length += 8; },
+      bytes(data) { ensure(data.length); buffer.set(data, length); length += data.length; },
+      result() { return buffer.slice(0, length); }
+    };
+  }
+
+  function writeHeader(w, size, fixBase, fixMax, code16, code32) {
+    if (size <= fixMax) {
+      w.u8(fixBase | size);
+    } else if (size <= 0xffff) {
+      w.u8(code16);
+      w.u16(size);
+    } else {
+      w.u8(code32);
+      w.u32(size);
+    }
+  }
+
+  function writeNumber(w, value) {
+    if (Number.isInteger(value) && value >= -0x80000000 && value <= 0xffffffff) {
+      if (value >= 0) {
+        if (value < 0x80) w.u8(value);
+        else if (value <= 0xff) { w.u8(0xcc); w.u8(value); }
+        else if (value <= 0xffff) { w.u8(0xcd); w.u16(value); }
+        else { w.u8(0xce); w.u32(value); }
+      } else {
+        if (value >= -32) w.i8(value);
+        else if (value >= -0x80) { w.u8(0xd0); w.i8(value); }
+        else if (value >= -0x8000) { w.u8(0xd1); w.i16(value); }
+        else { w.u8(0xd2); w.i32(value); }
+      }
+      return;
+    }
+    // 固件内部以 float 存储数值，小数用 float32 即可；超出 float32 精度的整数才用 float64
+    if (Number.isInteger(value) || !Number.isFinite(value)) {
+      w.u8(0xcb);
+      w.f64(value);
+    } else {
+      w.u8(0xca);
+      w.f32(value);
+    }
+  }
+
+  function writeValue(w, value) {
+    if (value === null || value === undefined) {
+      w.u8(0xc0);
+    } else if (value === false) {
+      w.u8(0xc2);
+    } else if (value === true) {
+      w.u8(0xc3);
+    } else if (typeof value === 'number') {
+      writeNumber(w, value);
+    } else if (typeof value === 'string') {
+      const data = textEncoder.encode(value);
+      if (data.length <= 31) w.u8(0xa0 | data.length);
+      else if (data.length <= 0xff) { w.u8(0xd9); w.u8(data.length); }
+      else writeHeader(w, data.length, 0, -1, 0xda, 0xdb);
+      w.bytes(data);
+    } else if (Array.isArray(value)) {
+      writeHeader(w, value.length, 0x90, 15, 0xdc, 0xdd);
+      value.forEach((item) => writeValue(w, item));
+    } else if (typeof value === 'object') {
+      const keys = Object.keys(value).filter((key) => value[key] !== undefined);
+      writeHeader(w, keys.length, 0x80, 15, 0xde, 0xdf);
+      keys.forEach((key) => {
+        writeValue(w, key);
+        writeValue(w, value[key]);
+      });
+    } else {
+      w.u8(0xc0);
+    }
+  }
+
+  function encode(value) {
+    const w = createWriter();
+    writeValue(w, value);
+    return w.result();
+  }
+
+  function decode(input) {
+    const bytes = input instanceof Uint8Array ? input : new Uint8Array(input);
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    let pos = 0;
+
+    function take(size) {
+      if (pos + size > bytes.length) throw new Error('msgpack: truncated');
+      const at = pos;
+      pos += size;
+      return at;
+    }
+    function str(size) {
+      const at = take(size);
+      return textDecoder.decode(bytes.subarray(at, at + size));
+    }
+    function array(size) {
+      const out = new Array(size);
+      for (let i = 0; i < size; i++) out[i] = read();
+      return out;
+    }
+    function map(size) {
+      const out = {};
+      for (let i = 0; i < size; i++) {
+        const key = read();
+        out[key] = read();
+      }
+      return out;
+    }
+    function read() {
+      const code = view.getUint8(take(1));
+      if (code < 0x80) return code;
+      if (code < 0x90) return map(code & 0x0f);
+      if (code < 0xa0) return array(code & 0x0f);
+      if (code < 0xc0) return str(code & 0x1f);
+      if (code >= 0xe0) return code - 0x100;
+      switch (code) {
+        case 0xc0: return null;
+        case 0xc2: return false;
+        case 0xc3: return true;
+        case 0xc4: { const n = view.getUint8(take(1)); const at = take(n); return bytes.slice(at, at + n); }
+        case 0xc5: { const n = view.getUint16(take(2)); const at = take(n); return bytes.slice(at, at + n); }
+        case 0xc6: { const n = view.getUint32(take(4)); const at = take(n); return bytes.slice(at, at + n); }
+        case 0xca: return view.getFloat32(take(4));
+        case 0xcb: return view.getFloat64(take(8));
+        case 0xcc: return view.getUint8(take(1));
+        case 0xcd: return view.getUint16(take(2));
+        case 0xce: return view.getUint32(take(4));
+        case 0xcf: { const at = take(8); return view.getUint32(at) * 0x100000000 + view.getUint32(at + 4); }
+        case 0xd0: return view.getInt8(take(1));
+        case 0xd1: return view.getInt16(take(2));
+        case 0xd2: return view.getInt32(take(4));
+        case 0xd3: { const at = take(8); return view.getInt32(at) * 0x100000000 + view.getUint32(at + 4); }
+        case 0xd9: return str(view.getUint8(take(1)));
+        case 0xda: return str(view.getUint16(take(2)));
+        case 0xdb: return str(view.getUint32(take(4)));
+        case 0xdc: return array(view.getUint16(take(2)));
+        case 0xdd: return array(view.getUint32(take(4)));
+        case 0xde: return map(view.getUint16(take(2)));
+        case 0xdf: return map(view.getUint32(take(4)));
+        default: throw new Error('msgpack: unsupported type 0x' + code.toString(16));
+      }
+    }
+
+    return read();
+  }
+
+  // 按选择的格式编码指令：MessagePack 返回 Uint8Array（WebSocket 以二进制帧发送），否则为 JSON 文本
+  function serialize(payload, useMsgPack) {
+    return useMsgPack ? encode(payload) : JSON.stringify(payload);
+  }
+
+  // 解析 /cmd 推送：文本帧为 JSON，二进制帧（需设置 binaryType = 'arraybuffer'）为 MessagePack
+  function parseMessage(data) {
+    return typeof data === 'string' ? JSON.parse(data) : decode(data);
+  }
+
+  global.NodeMsgPack = {
+    encode: encode,
+    decode: decode,
+    isPreferred: isPreferred,
+    serialize: serialize,
+    parseMessage: parseMessage
+  };
+})(window);
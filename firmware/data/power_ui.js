@@ -4,7 +4,10 @@
     lowBatteryLatched: false,
     lowBatteryProtectionEnabled: true,
     voltageMv: 0,
+    openCircuitMv: 0,
     percentEstimate: 0,
+    runtimeMin: 0,
+    throttlePercent: 0,
     lowBatteryThresholdMv: 7200
   };
 
@@ -65,14 +68,19 @@
       if (isLowBatteryWarning()) {
         return 'power-low';
       }
-      if (state.voltageMv < 7800) {
+      if (getLevelMv() < 7800) {
         return 'power-warn';
       }
       return 'power-good';
     }
 
+    // 运动中带载电压会跌落，优先使用固件补偿后的开路电压判断电量
+    function getLevelMv() {
+      return state.openCircuitMv > 0 ? state.openCircuitMv : state.voltageMv;
+    }
+
     function isLowBatteryWarning() {
-      return state.voltageMv <= state.lowBatteryThresholdMv;
+      return getLevelMv() <= state.lowBatteryThresholdMv;
     }
 
     function isLowBatteryBlocked() {
@@ -107,7 +115,9 @@
       const percentText = String(state.percentEstimate) + '%';
       const lowText = getLang() === 'en' ? 'Low' : '低电量';
       const label = getLang() === 'en' ? 'Battery' : '电池';
-      const text = label + ' ' + voltageText + ' · ' + percentText + (state.lowBatteryLatched ? (' · ' + lowText) : '');
+      const runtimeText = state.runtimeMin > 0 ? (' · ~' + state.runtimeMin + (getLang() === 'en' ? ' min' : '分钟')) : '';
+      const throttleText = state.throttlePercent > 0 ? (' · ' + (getLang() === 'en' ? 'Throttled ' : '限速 ') + state.throttlePercent + '%') : '';
+      const text = label + ' ' + voltageText + ' · ' + percentText + runtimeText + throttleText + (state.lowBatteryLatched ? (' · ' + lowText) : '');
 
       badge.className = 'power-badge ' + getBadgeLevel();
       const textEl = badge.querySelector('.power-badge-text');
@@ -125,6 +135,15 @@
         if (typeof data.power.voltageMv === 'number') {
           state.voltageMv = data.power.voltageMv;
         }
+        if (typeof data.power.openCircuitMv === 'number') {
+          state.openCircuitMv = data.power.openCircuitMv;
+        }
+        if (typeof data.power.runtimeMin === 'number') {
+          state.runtimeMin = data.power.runtimeMin;
+        }
+        if (typeof data.power.throttlePercent === 'number') {
+          state.throttlePercent = data.power.throttlePercent;
+        }
         if (typeof data.power.percentEstimate === 'number') {
           state.percentEstimate = data.power.percentEstimate;
         }
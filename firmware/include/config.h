@@ -1,5 +1,33 @@
 #pragma once
 
+// ---- 可通过 platformio.ini 的 build_flags 覆盖的编译期参数 ----
+// 舵机 PWM 刷新频率（Hz）。模拟舵机一般只能用 50Hz，数字舵机通常可到 100~333Hz。
+// 六足两块驱动板可分别设置（LEFT=0x41，RIGHT=0x40），四足单板使用 SERVO_PWM_FREQUENCY_HZ。
+#ifndef SERVO_PWM_FREQUENCY_HZ
+#define SERVO_PWM_FREQUENCY_HZ 50
+#endif
+#ifndef SERVO_PWM_FREQUENCY_LEFT_HZ
+#define SERVO_PWM_FREQUENCY_LEFT_HZ SERVO_PWM_FREQUENCY_HZ
+#endif
+#ifndef SERVO_PWM_FREQUENCY_RIGHT_HZ
+#define SERVO_PWM_FREQUENCY_RIGHT_HZ SERVO_PWM_FREQUENCY_HZ
+#endif
+
+// 舵机脉冲错相输出（1=开启）：各通道上升沿在 PWM 周期内均匀错开，降低电流尖峰叠加
+#ifndef SERVO_PWM_STAGGER
+#define SERVO_PWM_STAGGER 1
+#endif
+
+// PCA9685 内部振荡器实测频率（Hz），用于校正 us->tick 换算
+#ifndef PCA9685_OSCILLATOR_HZ
+#define PCA9685_OSCILLATOR_HZ 25000000
+#endif
+
+// 控制循环周期（ms）。提高 PWM 频率后可同步减小，例如 100Hz 对应 10ms
+#ifndef CONTROL_PERIOD_MS
+#define CONTROL_PERIOD_MS 20
+#endif
+
 namespace hexapod { 
 
     namespace config {
@@ -25,13 +53,41 @@ namespace hexapod {
 
 
         // timing setting. unit: ms
-        const int movementInterval = 20;
+        const int movementInterval = CONTROL_PERIOD_MS;
         const int movementSwitchDuration = 150;
+        // 过渡时各关节（coxa/femur/tibia）的限速（1.0 倍速，°/s），过渡时长按关节角度差计算（见 transition_timing.h）；
+        // 四足机体轻，每个舵机的负载小于六足
+        const float jointSpeedLimitDegPerSec[3] = {360, 300, 300};
+        const float quadJointSpeedLimitDegPerSec[3] = {540, 450, 450};
+
+        // servo pwm setting
+        const int servoPwmFrequencyLeft = SERVO_PWM_FREQUENCY_LEFT_HZ;
+        const int servoPwmFrequencyRight = SERVO_PWM_FREQUENCY_RIGHT_HZ;
+        const int servoPwmFrequency = SERVO_PWM_FREQUENCY_HZ;
+        const unsigned long pca9685OscillatorHz = PCA9685_OSCILLATOR_HZ;
+        const bool servoPwmStagger = SERVO_PWM_STAGGER != 0;
+        // 相同 tick 会跳过 I2C 写入；已输出的舵机在该时长内逐路重发一轮（每次一路，分散到各控制周期），
+        // 每轮开始时读回驱动板 MODE1/PRE_SCALE，因电压跌落复位后重新初始化并立即重发全部舵机
+        const int servoRefreshIntervalMs = 1000;
+
+        // 一个 PWM 周期必须能容纳最大脉宽 2500us，否则舵机无法到达行程端点
+        static_assert(SERVO_PWM_FREQUENCY_LEFT_HZ >= 24 && SERVO_PWM_FREQUENCY_LEFT_HZ <= 333, "servo pwm frequency out of range (24~333Hz)");
+        static_assert(SERVO_PWM_FREQUENCY_RIGHT_HZ >= 24 && SERVO_PWM_FREQUENCY_RIGHT_HZ <= 333, "servo pwm frequency out of range (24~333Hz)");
+        static_assert(SERVO_PWM_FREQUENCY_HZ >= 24 && SERVO_PWM_FREQUENCY_HZ <= 333, "servo pwm frequency out of range (24~333Hz)");
+        // 控制周期短于 PWM 周期没有意义：舵机一个周期内只会采样一次脉宽
+        static_assert(CONTROL_PERIOD_MS > 0 && CONTROL_PERIOD_MS * SERVO_PWM_FREQUENCY_HZ >= 1000, "control period shorter than servo pwm period");
+        static_assert(CONTROL_PERIOD_MS * SERVO_PWM_FREQUENCY_LEFT_HZ >= 1000, "control period shorter than left servo pwm period");
+        static_assert(CONTROL_PERIOD_MS * SERVO_PWM_FREQUENCY_RIGHT_HZ >= 1000, "control period shorter than right servo pwm period");
 
         // speed control. range: 0.25 - 1.0 (1.0 is fastest)
         const float defaultSpeed = 0.5;
         const float minSpeed = 0.25;
         const float maxSpeed = 1.0;
+
+        // 四足自动步态（gaitMode=4）：速度升高时 creep -> walk -> trot，阈值两侧各留回差，避免在阈值附近来回切换
+        const float quadAutoGaitWalkSpeed = 0.4;
+        const float quadAutoGaitTrotSpeed = 0.75;
+        const float quadAutoGaitHysteresis = 0.05;
     }
 
     // Speed level enumeration
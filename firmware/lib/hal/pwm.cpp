@@ -1,4 +1,4 @@
-
+#include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_PWMServoDriver.h>
 
@@ -6,8 +6,69 @@
 
 namespace hexapod { namespace hal {
 
+    namespace {
+        const static uint32_t kDefaultOscillatorHz = 25000000;
+        const static int kPwmResolution = 4096;
+        const static int kChannelCount = 16;
+        const static int kPrescaleMin = 3;
+        const static int kPrescaleMax = 255;
+
+        // PCA9685 寄存器
+        const static uint8_t kRegMode1 = 0x00;
+        const static uint8_t kRegPrescale = 0xFE;
+        const static uint8_t kMode1Sleep = 0x10;
+
+        const static uint32_t kStatsWindowMs = 1000;
+
+        uint32_t totalWrites = 0;
+        uint32_t totalSkipped = 0;
+        uint32_t windowStartMs = 0;
+        uint32_t windowWrites = 0;
+        uint32_t windowSkipped = 0;
+        uint32_t lastWritesPerSec = 0;
+        uint32_t lastSkippedPerSec = 0;
+
+        // 滚动 1s 统计窗口（只在写入/查询时顺带推进，不需要额外定时器）
+        void rollStatsWindow() {
+            uint32_t now = millis();
+            uint32_t elapsed = now - windowStartMs;
+            if (elapsed < kStatsWindowMs)
+                return;
+            if (elapsed < 2 * kStatsWindowMs) {
+                lastWritesPerSec = windowWrites;
+                lastSkippedPerSec = windowSkipped;
+            }
+            else {
+                // 超过一个窗口没有任何写入：上一窗口的数据已过期
+                lastWritesPerSec = 0;
+                lastSkippedPerSec = 0;
+            }
+            windowWrites = 0;
+            windowSkipped = 0;
+            windowStartMs = now;
+        }
+
+        bool readRegister(int address, uint8_t reg, uint8_t& value) {
+            Wire.beginTransmission((uint8_t)address);
+            Wire.write(reg);
+            if (Wire.endTransmission() != 0)
+                return false;
+            if (Wire.requestFrom((uint8_t)address, (uint8_t)1) != 1)
+                return false;
+            value = (uint8_t)Wire.read();
+            return true;
+        }
+    }
+
     PCA9685::PCA9685(int i2cAddress) {
         obj_ = (void*)new Adafruit_PWMServoDriver(i2cAddress);
+        address_ = i2cAddress;
+        frequency_ = 50;
+        oscillatorHz_ = kDefaultOscillatorHz;
+        prescale_ = 121;    // 25MHz/50Hz 对应的预分频
+        tickUs_ = (prescale_ + 1) * 1000000.0f / (float)oscillatorHz_;
+        stagger_ = false;
+        boardOffsetTicks_ = 0;
     }
 
     PCA9685::~PCA9685() {
@@ -18,12 +79,104 @@ namespace hexapod { namespace hal {
         ((Adafruit_PWMServoDriver*)obj_)->begin();
     }
 
+    void PCA9685::setOscillatorFrequency(uint32_t hz) {
+        oscillatorHz_ = hz;
+        tickUs_ = (prescale_ + 1) * 1000000.0f / (float)oscillatorHz_;
+        ((Adafruit_PWMServoDriver*)obj_)->setOscillatorFrequency(hz);
+    }
+
     void PCA9685::setPWMFreq(int freq) {
         ((Adafruit_PWMServoDriver*)obj_)->setPWMFreq(freq);
+        frequency_ = freq;
+
+        // 与 Adafruit 驱动相同的取整方式：prescale = osc/(4096*freq) - 1，四舍五入后限幅
+        float prescale = ((float)oscillatorHz_ / ((float)freq * kPwmResolution)) + 0.5f - 1.0f;
+        if (prescale < kPrescaleMin)
+            prescale = kPrescaleMin;
+        else if (prescale > kPrescaleMax)
+            prescale = kPrescaleMax;
+        prescale_ = (int)prescale;
+        tickUs_ = (prescale_ + 1) * 1000000.0f / (float)oscillatorHz_;
+    }
+
+    bool PCA9685::recoverFromReset() {
+        uint8_t mode1 = 0;
+        uint8_t prescale = 0;
+        if (!readRegister(address_, kRegMode1, mode1) || !readRegister(address_, kRegPrescale, prescale))
+            return false;
+        if ((mode1 & kMode1Sleep) == 0 && prescale == prescale_)
+            return false;
+
+        begin();
+        setOscillatorFrequency(oscillatorHz_);
+        setPWMFreq(frequency_);
+        return true;
+    }
+
+    float PCA9685::actualFrequency() const {
+        return (float)oscillatorHz_ / ((float)kPwmResolution * (prescale_ + 1));
+    }
+
+    float PCA9685::tickUs() const {
+        return tickUs_;
+    }
+
+    int PCA9685::usToTicks(float us) const {
+        int ticks = (int)(us / tickUs_ + 0.5f);
+        if (ticks < 0)
+            ticks = 0;
+        else if (ticks > kPwmResolution - 1)
+            ticks = kPwmResolution - 1;
+        return ticks;
     }
 
     void PCA9685::setPWM(int index, int on, int off) {
         ((Adafruit_PWMServoDriver*)obj_)->setPWM(index, (uint16_t)on, (uint16_t)off);
+
+        rollStatsWindow();
+        totalWrites++;
+        windowWrites++;
+    }
+
+    void PCA9685::setStagger(bool enabled, int boardOffsetTicks) {
+        stagger_ = enabled;
+        boardOffsetTicks_ = boardOffsetTicks % kPwmResolution;
+        if (boardOffsetTicks_ < 0)
+            boardOffsetTicks_ += kPwmResolution;
+    }
+
+    int PCA9685::phaseOf(int index) const {
+        if (!stagger_)
+            return 0;
+        // 16 个通道均分一个 PWM 周期（每槽 256 tick，50Hz 时约 1.25ms）
+        return (index * (kPwmResolution / kChannelCount) + boardOffsetTicks_) % kPwmResolution;
+    }
+
+    void PCA9685::setPulseTicks(int index, int ticks) {
+        int on = phaseOf(index);
+        // off 越过周期末尾时回绕，芯片会输出跨越计数器回零点的同宽脉冲
+        int off = (on + ticks) % kPwmResolution;
+        setPWM(index, on, off);
+    }
+
+    void recordPwmSkip() {
+        rollStatsWindow();
+        totalSkipped++;
+        windowSkipped++;
+    }
+
+    void getPwmWriteStats(PwmWriteStats& stats) {
+        // 可能在 Web 任务中调用：只读，不推进窗口（窗口由控制循环的写入推进）
+        stats.writes = totalWrites;
+        stats.skipped = totalSkipped;
+        if (millis() - windowStartMs >= 2 * kStatsWindowMs) {
+            stats.writesPerSec = 0;
+            stats.skippedPerSec = 0;
+        }
+        else {
+            stats.writesPerSec = lastWritesPerSec;
+            stats.skippedPerSec = lastSkippedPerSec;
+        }
     }
 
-}}
\ No newline at end of file
+}}
@@ -1,18 +1,59 @@
 #pragma once
 
+#include <cstdint>
+
 namespace hexapod { namespace hal {
 
+    // PWM 写入统计：跨所有 PCA9685 实例累计，用于评估 I2C 带宽占用以及脏标记节省下来的写入
+    struct PwmWriteStats {
+        uint32_t writes;          // 累计实际下发次数
+        uint32_t skipped;         // 累计因 tick 未变化而跳过的次数
+        uint32_t writesPerSec;    // 最近一个完整 1s 窗口内的下发次数
+        uint32_t skippedPerSec;   // 最近一个完整 1s 窗口内的跳过次数
+    };
+
     class PCA9685 {
     public:
         PCA9685(int i2cAddress = 0x40);
         ~PCA9685();
 
         void begin();
+        // 内部振荡器频率（标称 25MHz，实测各芯片有数个百分点偏差），需在 setPWMFreq 之前设置
+        void setOscillatorFrequency(uint32_t hz);
         void setPWMFreq(int freq);
         void setPWM(int index, int on, int off);
 
+        // 错相输出：各通道脉冲起点按通道号均匀错开（boardOffsetTicks 为整板额外偏移），
+        // 避免所有舵机在同一时刻上升沿、电流尖峰叠加。关闭时所有通道 on=0（旧行为）。
+        void setStagger(bool enabled, int boardOffsetTicks = 0);
+        int phaseOf(int index) const;
+        // 以 tick 为单位输出脉宽，on 相位由 phaseOf 决定，脉宽保持不变
+        void setPulseTicks(int index, int ticks);
+
+        // 读回 MODE1 / PRE_SCALE 与配置比对：芯片因电压跌落上电复位后 MODE1.SLEEP 置位、PRE_SCALE 回到默认值，
+        // 此时按原参数重新初始化（begin/振荡器/频率，错相设置保存在本对象中不受影响）并返回 true，
+        // 调用方需重发所有通道。读失败（板子无应答）时返回 false，不做处理
+        bool recoverFromReset();
+
+        // 由实际预分频值反推的 PWM 参数（预分频只能取整数，实际频率与请求值略有差异）
+        float actualFrequency() const;
+        float tickUs() const;
+        // 脉宽(us) -> tick，四舍五入到最近的 tick
+        int usToTicks(float us) const;
+
     private:
         void* obj_;
+        int address_;
+        int frequency_;
+        uint32_t oscillatorHz_;
+        int prescale_;
+        float tickUs_;
+        bool stagger_;
+        int boardOffsetTicks_;
     };
 
-}}
\ No newline at end of file
+    // 由上层（舵机关节）在判定数值未变化、跳过写入时调用
+    void recordPwmSkip();
+    void getPwmWriteStats(PwmWriteStats& stats);
+
+}}
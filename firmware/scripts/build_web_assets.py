@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+Web UI 静态资源预处理（压缩 + gzip + ETag 清单）
+
+把 data/ 下的网页资源（.html/.js/.css）做保守压缩（去掉行首尾空白与空行，保留换行，
+不改动脚本语义）后 gzip，输出到 .pio/webdata/ 作为 SPIFFS 镜像目录；其余文件原样复制。
+同时生成 /web_assets.idx 清单，每行：<请求路径> <ETag> <gzip 字节数>，固件启动时加载，
+用于 Content-Encoding: gzip、强 ETag 与 304 Not Modified。
+
+可选的内嵌模式（build_flags 中 -D WEB_ASSETS_EMBEDDED=1）：同时把 gzip 后的内容生成为
+src/generated/web_assets_data.h 中的 PROGMEM 数组（含长度与 ETag），固件直接从映射的 flash 发送，
+请求路径上不再访问 SPIFFS。
+
+PlatformIO 中作为 pre 脚本自动执行（见 platformio.ini 的 extra_scripts 与 data_dir）；
+也可以单独运行：
+    python scripts/build_web_assets.py
+    python scripts/build_web_assets.py --no-minify --out .pio/webdata
+    python scripts/build_web_assets.py --embed src/generated/web_assets_data.h
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import re
+import shutil
+
+WEB_EXTENSIONS = (".html", ".js", ".css")
+MANIFEST_NAME = "web_assets.idx"
+
+
+def minify_text(text):
+    """保守压缩：去掉每行首尾空白和空行。保留换行以免影响 JS 自动分号插入。"""
+    lines = (line.strip() for line in text.splitlines())
+    return "\n".join(line for line in lines if line) + "\n"
+
+
+def gzip_bytes(raw):
+    # mtime=0 保证相同输入得到相同输出（ETag 稳定）
+    return gzip.compress(raw, compresslevel=9, mtime=0)
+
+
+def etag_of(payload):
+    return '"' + hashlib.sha256(payload).hexdigest()[:16] + '"'
+
+
+def collect_assets(data_dir, minify=True):
+    """返回 [(name, raw_size, payload, etag)]，payload 为 gzip 后的内容"""
+    assets = []
+    for name in sorted(os.listdir(data_dir)):
+        path = os.path.join(data_dir, name)
+        if not os.path.isfile(path) or not name.endswith(WEB_EXTENSIONS):
+            continue
+        with open(path, "rb") as fp:
+            raw = fp.read()
+        content = raw
+        if minify:
+            content = minify_text(raw.decode("utf-8")).encode("utf-8")
+        payload = gzip_bytes(content)
+        assets.append((name, len(raw), payload, etag_of(payload)))
+    return assets
+
+
+def build(data_dir, out_dir, minify=True, verbose=True):
+    if os.path.isdir(out_dir):
+        shutil.rmtree(out_dir)
+    os.makedirs(out_dir)
+
+    assets = collect_assets(data_dir, minify)
+    web_names = set(a[0] for a in assets)
+    for name in sorted(os.listdir(data_dir)):
+        path = os.path.join(data_dir, name)
+        if os.path.isfile(path) and name not in web_names:
+            shutil.copyfile(path, os.path.join(out_dir, name))
+
+    total_raw = 0
+    total_gz = 0
+    lines = []
+    for name, raw_size, payload, etag in assets:
+        with open(os.path.join(out_dir, name + ".gz"), "wb") as fp:
+            fp.write(payload)
+        lines.append("/%s %s %d" % (name, etag, len(payload)))
+        total_raw += raw_size
+        total_gz += len(payload)
+        if verbose:
+            print("  %-24s %7d -> %6d bytes" % (name, raw_size, len(payload)))
+
+    with open(os.path.join(out_dir, MANIFEST_NAME), "w", newline="\n") as fp:
+        fp.write("\n".join(lines) + "\n")
+
+    if verbose and total_gz:
+        print("  total %d -> %d bytes (%.1fx)" % (total_raw, total_gz, float(total_raw) / total_gz))
+    return assets
+
+
+def c_identifier(name):
+    return "k" + "".join(part.capitalize() for part in re.split(r"[^0-9A-Za-z]+", name) if part)
+
+
+def render_header(assets):
+    out = [
+        "//",
+        "// This file is generated by scripts/build_web_assets.py, dont directly modify content...",
+        "//",
+        "#pragma once",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "namespace webassets {",
+        "namespace embedded {",
+        "",
+        "struct EmbeddedAsset {",
+        "  const char* path;",
+        "  const char* etag;",
+        "  const uint8_t* data;  // gzip 内容（PROGMEM）",
+        "  uint32_t size;",
+        "};",
+        "",
+    ]
+    for name, _, payload, _ in assets:
+        out.append("const uint8_t %s[] PROGMEM = {" % c_identifier(name))
+        for i in range(0, len(payload), 16):
+            out.append("  " + ", ".join("0x%02x" % b for b in payload[i:i + 16]) + ",")
+        out.append("};")
+        out.append("")
+    out.append("const EmbeddedAsset kAssets[] = {")
+    for name, _, payload, etag in assets:
+        out.append('  {"/%s", "%s", %s, %d},' % (name, etag.replace('"', '\\"'), c_identifier(name), len(payload)))
+    out.append("};")
+    out.append("")
+    out.append("const size_t kAssetCount = sizeof(kAssets) / sizeof(kAssets[0]);")
+    out.append("")
+    out.append("}  // namespace embedded")
+    out.append("}  // namespace webassets")
+    return "\n".join(out) + "\n"
+
+
+def write_header(assets, header_path, verbose=True):
+    content = render_header(assets)
+    # 内容未变化时不重写，避免触发重新编译
+    if os.path.isfile(header_path):
+        with open(header_path, "r", encoding="utf-8") as fp:
+            if fp.read() == content:
+                return
+    os.makedirs(os.path.dirname(header_path), exist_ok=True)
+    with open(header_path, "w", encoding="utf-8", newline="\n") as fp:
+        fp.write(content)
+    if verbose:
+        print("  embedded %d assets -> %s" % (len(assets), header_path))
+
+
+def embedded_enabled(build_flags):
+    if isinstance(build_flags, str):
+        build_flags = [build_flags]
+    for flag in build_flags:
+        for token in flag.split():
+            if "WEB_ASSETS_EMBEDDED" in token and not token.endswith("=0"):
+                return True
+    return False
+
+
+def main():
+    project_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    parser = argparse.ArgumentParser(description="Minify + gzip web UI assets for the SPIFFS image")
+    parser.add_argument("--data", default=os.path.join(project_dir, "data"), help="source data directory")
+    parser.add_argument("--out", default=os.path.join(project_dir, ".pio", "webdata"), help="output directory")
+    parser.add_argument("--no-minify", action="store_true", help="only gzip, keep whitespace")
+    parser.add_argument("--embed", metavar="HEADER", help="also generate PROGMEM header (WEB_ASSETS_EMBEDDED)")
+    args = parser.parse_args()
+    assets = build(args.data, args.out, minify=not args.no_minify)
+    if args.embed:
+        write_header(assets, args.embed)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    # PlatformIO extra_scripts（pre:）入口
+    try:
+        Import("env")  # noqa: F821
+    except NameError:
+        env = None
+    if env is not None:
+        _source_dir = os.path.join(env.subst("$PROJECT_DIR"), "data")
+        _output_dir = env.subst("$PROJECT_DATA_DIR")
+        # data_dir 未改到生成目录时不做任何处理，避免覆盖源文件
+        if os.path.abspath(_output_dir) != os.path.abspath(_source_dir):
+            print("[web assets] data -> %s" % _output_dir)
+            _assets = build(_source_dir, _output_dir)
+            if embedded_enabled(env.GetProjectOption("build_flags", [])):
+                write_header(_assets, os.path.join(env.subst("$PROJECT_SRC_DIR"), "generated", "web_assets_data.h"))
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+舵机 PWM 错相输出电流仿真
+
+按固件中 hal::PCA9685::phaseOf 的错相规则（16 通道均分一个 PWM 周期，六足左板额外偏移 128 tick）
+计算每个 PWM 周期内的总电流波形，对比"全部通道 on=0 同时上升沿"与"错相输出"两种情况下的
+峰值电流与电池端压降。
+
+电流模型（一阶近似）：舵机在收到脉冲上升沿后驱动电机一段时间（burst），期间电流为 burst 电流，
+其余时间为静态电流。实际舵机的电流与负载、位置误差相关，这里只用于比较两种相位分配的相对差异。
+
+用法：
+    python scripts/pwm_stagger_sim.py
+    python scripts/pwm_stagger_sim.py --freq 100 --burst-ms 1.5 --csv stagger.csv
+"""
+
+import argparse
+import csv
+
+PWM_RESOLUTION = 4096
+CHANNEL_COUNT = 16
+OSCILLATOR_HZ = 25000000
+
+# 与 servo.cpp / quad_servo.cpp 的通道映射保持一致：(板号, 通道)
+HEXAPOD_CHANNELS = [(0, c) for c in range(2, 11)] + [(1, c) for c in range(2, 11)]
+QUAD_CHANNELS = [(0, c) for c in (13, 14, 15, 12, 11, 10, 3, 4, 5, 2, 1, 0)]
+HEXAPOD_BOARD_OFFSET = {0: 0, 1: 128}
+QUAD_BOARD_OFFSET = {0: 0}
+
+
+def tick_us(freq):
+    """与 hal::PCA9685::setPWMFreq 相同的预分频取整"""
+    prescale = OSCILLATOR_HZ / (freq * PWM_RESOLUTION) + 0.5 - 1.0
+    prescale = int(min(max(prescale, 3), 255))
+    return (prescale + 1) * 1e6 / OSCILLATOR_HZ
+
+
+def phase_of(channel, board_offset, stagger):
+    if not stagger:
+        return 0
+    return (channel * (PWM_RESOLUTION // CHANNEL_COUNT) + board_offset) % PWM_RESOLUTION
+
+
+def simulate(channels, board_offsets, freq, stagger, burst_ms, burst_a, idle_a, samples):
+    """返回一个 PWM 周期内 samples 个采样点的总电流（A）"""
+    period_us = 1e6 / freq
+    tick = tick_us(freq)
+    burst_us = burst_ms * 1000.0
+    current = [idle_a * len(channels)] * samples
+    for board, channel in channels:
+        start_us = phase_of(channel, board_offsets[board], stagger) * tick
+        for i in range(samples):
+            t = i * period_us / samples
+            # 周期性：上升沿之后 burst_us 内（可能跨越周期末尾）
+            dt = (t - start_us) % period_us
+            if dt < burst_us:
+                current[i] += burst_a - idle_a
+    return current
+
+
+def summarize(current):
+    peak = max(current)
+    mean = sum(current) / len(current)
+    return peak, mean
+
+
+def run_case(name, channels, board_offsets, args, writer=None):
+    rows = []
+    for stagger in (False, True):
+        current = simulate(channels, board_offsets, args.freq, stagger,
+                           args.burst_ms, args.burst_a, args.idle_a, args.samples)
+        peak, mean = summarize(current)
+        rows.append((stagger, peak, mean))
+        if writer:
+            period_us = 1e6 / args.freq
+            for i, value in enumerate(current):
+                writer.writerow([name, int(stagger), round(i * period_us / args.samples, 1), round(value, 4)])
+
+    # 两块板振荡器不同步：扫描板间相对相位，取错相情况下的最坏峰值
+    worst_peak = rows[1][1]
+    if len(board_offsets) > 1:
+        for shift in range(0, PWM_RESOLUTION, 32):
+            offsets = {b: (o + (shift if b == 1 else 0)) % PWM_RESOLUTION for b, o in board_offsets.items()}
+            peak, _ = summarize(simulate(channels, offsets, args.freq, True,
+                                         args.burst_ms, args.burst_a, args.idle_a, args.samples))
+            worst_peak = max(worst_peak, peak)
+
+    (_, peak_sync, mean_sync), (_, peak_stag, mean_stag) = rows
+    print("[%s] %d ch @ %dHz, burst %.1fms x %.2fA" % (name, len(channels), args.freq, args.burst_ms, args.burst_a))
+    print("  同相  peak %.2fA  mean %.2fA  压降 %.2fV -> %.2fV" % (
+        peak_sync, mean_sync, peak_sync * args.r_int, args.v_batt - peak_sync * args.r_int))
+    print("  错相  peak %.2fA  mean %.2fA  压降 %.2fV -> %.2fV" % (
+        peak_stag, mean_stag, peak_stag * args.r_int, args.v_batt - peak_stag * args.r_int))
+    if len(board_offsets) > 1:
+        print("  错相(板间相位最坏) peak %.2fA" % worst_peak)
+    print("  峰值电流降低 %.0f%%" % (100.0 * (1.0 - peak_stag / peak_sync)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="PWM stagger current simulation")
+    parser.add_argument("--freq", type=int, default=50, help="PWM frequency (Hz)")
+    parser.add_argument("--burst-ms", type=float, default=2.0, help="motor drive burst after each rising edge (ms)")
+    parser.add_argument("--burst-a", type=float, default=0.7, help="current during burst (A)")
+    parser.add_argument("--idle-a", type=float, default=0.01, help="idle current per servo (A)")
+    parser.add_argument("--r-int", type=float, default=0.15, help="battery + wiring resistance (ohm)")
+    parser.add_argument("--v-batt", type=float, default=7.4, help="open circuit battery voltage (V)")
+    parser.add_argument("--samples", type=int, default=2000, help="samples per PWM period")
+    parser.add_argument("--csv", help="write per-sample current waveform to CSV")
+    args = parser.parse_args()
+
+    writer = None
+    fp = None
+    if args.csv:
+        fp = open(args.csv, "w", newline="")
+        writer = csv.writer(fp)
+        writer.writerow(["case", "stagger", "time_us", "current_a"])
+
+    run_case("hexapod", HEXAPOD_CHANNELS, HEXAPOD_BOARD_OFFSET, args, writer)
+    run_case("quad", QUAD_CHANNELS, QUAD_BOARD_OFFSET, args, writer)
+
+    if fp:
+        fp.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -39,7 +39,7 @@ SUPPORTED_ENVS = {
     }
 }
 RELEASE_DIR = PROJECT_ROOT / "release"
-BIN_FILES = ["bootloader.bin", "firmware.bin", "partitions.bin", "spiffs.bin"]
+BIN_FILES = ["bootloader.bin", "firmware.bin", "partitions.bin", "littlefs.bin"]
 
 class ReleaseManager:
     def __init__(self, build_envs=None):
@@ -150,10 +150,10 @@ class ReleaseManager:
             print(f"  ✓ [{env_name}] 固件构建成功")
             
             # 构建文件系统镜像
-            print(f"  📁 构建 SPIFFS 文件系统镜像 [{env_name}]...")
+            print(f"  📁 构建 LittleFS 文件系统镜像 [{env_name}]...")
             result = subprocess.run([self.platformio_cmd, 'run', '-e', env_name, '--target', 'buildfs'], 
                                   check=True, capture_output=True, text=True)
-            print(f"  ✓ [{env_name}] SPIFFS 文件系统镜像构建成功")
+            print(f"  ✓ [{env_name}] LittleFS 文件系统镜像构建成功")
             
             return True
         except subprocess.CalledProcessError as e:
@@ -183,7 +183,7 @@ class ReleaseManager:
 | `bootloader.bin` | 引导加载程序 | 0x1000 |
 | `partitions.bin` | 分区表 | 0x8000 |
 | `firmware.bin` | 主应用程序固件 | 0x10000 (app0分区) |
-| `spiffs.bin` | SPIFFS 文件系统映像 | 0x290000 (spiffs分区) |
+| `littlefs.bin` | LittleFS 文件系统映像 | 0x290000 (spiffs分区) |
 
 ## 烧录步骤
 
@@ -207,7 +207,7 @@ class ReleaseManager:
 | `bootloader.bin` | 0x1000 | 自动检测 |
 | `partitions.bin` | 0x8000 | 自动检测 |
 | `firmware.bin` | 0x10000 | 自动检测 |
-| `spiffs.bin` | 0x290000 | 自动检测 |
+| `littlefs.bin` | 0x290000 | 自动检测 |
 
 ### 5. 烧录设置
 - **波特率**: 115200 (推荐)
@@ -389,7 +389,7 @@ class ReleaseManager:
 - bootloader.bin → 0x1000
 - partitions.bin → 0x8000  
 - firmware.bin → 0x10000
-- spiffs.bin → 0x290000
+- littlefs.bin → 0x290000
 
 ### 技术支持
 如有问题，请提交 Issue 或联系开发团队。
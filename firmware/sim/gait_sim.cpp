@@ -0,0 +1,619 @@
+// 步态离线仿真（主机上运行，不参与固件构建）
+//
+// 以仿真时间驱动固件中真实的 HexapodClass / QuadRobot（含 Movement / QuadMovement、逆运动学、
+// 舵机限幅与稳定裕度），对每个 机型 × 步态 × 模式 × 速度 组合（四足步态含 auto，即自动步态）执行：
+//   standby -> 目标模式（进入过渡）-> 运行 --cycles 个周期 -> standby（退出过渡）
+// 记录足端轨迹、关节角度与角速度、Servo::setAngle 的限幅事件、稳定裕度与过渡时长，
+// 输出汇总表；可选输出每个组合的逐帧 CSV 与汇总 JSON。
+// 出现限幅事件、过渡超时，或过渡期间关节角速度超过关节限速（config::jointSpeedLimitDegPerSec /
+// quadJointSpeedLimitDegPerSec，按速度倍率缩放；过渡中仍在播放原步态表时以运行阶段的峰值为上限）时返回 1，
+// 步态表修改后可以直接在 CI 中运行校验。
+// 已知的步态表问题记录在 kKnownFailures 中：这些组合只要限幅次数不超过记录值、没有其他失败，
+// 就报告为 KNOWN 而不计入失败；问题修复后会提示从列表中删除。
+//
+// 编译运行（在 firmware 目录下，sim/host 提供最小的 Arduino / PCA9685 / 存储层替身）：
+//   g++ -std=gnu++11 -O2 -DROBOT_MODEL_NODEQUADMINI -Isim/host -Iinclude -Isrc -Ilib/hal -Ilib/ArduinoJson/src sim/gait_sim.cpp sim/host/host_runtime.cpp lib/hal/pwm.cpp src/debug.cpp src/command_keys.cpp src/servo.cpp src/servo_calibration.cpp src/leg.cpp src/movement.cpp src/movements.cpp src/hexapod.cpp src/quad_servo.cpp src/quad_leg.cpp src/quad_movement.cpp src/quad_movements.cpp src/quad_robot.cpp src/stability.cpp src/rng.cpp src/transition_timing.cpp -o /tmp/gait_sim
+//   /tmp/gait_sim                                   # 全部组合，只输出汇总表
+//   /tmp/gait_sim --model quad --gait creep --speed 1 --csv /tmp/sim --json /tmp/sim/summary.json
+//
+// ROBOT_MODEL_NODEQUADMINI 只决定四足源码是否参与编译，两种机型在同一个程序里仿真。
+
+#ifndef ROBOT_MODEL_NODEQUADMINI
+#error "build with -DROBOT_MODEL_NODEQUADMINI so that the quad sources are compiled in"
+#endif
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "command_keys.h"
+#include "config.h"
+#include "debug.h"
+#include "hexapod.h"
+#include "quad_robot.h"
+#include "rng.h"
+
+namespace {
+
+using hexapod::MovementMode;
+
+constexpr int kTickMs = hexapod::config::movementInterval;
+constexpr int kMaxLegs = 6;
+constexpr uint32_t kTransitionTimeoutMs = 10000;
+constexpr int kRunTimeoutFactor = 20;  // 运行阶段最多为名义时长的倍数（稳定裕度停顿不会超过）
+constexpr float kTransitionSpeedTolerance = 1.05f;  // 过渡角速度相对上限的容差（时长取整到控制周期后只会更慢）
+
+const char* const kModeNames[hexapod::MOVEMENT_TOTAL] = {
+  "standby", "forward", "forwardfast", "backward", "turnleft", "turnright", "shiftleft",
+  "shiftright", "climb", "rotatex", "rotatey", "rotatez", "twist", "beatsway",
+};
+// 四足 setGaitMode 的取值；最后一项为自动步态（RobotBase::kAutoGaitMode），按速度与模式选择步态
+constexpr int kQuadGaitCount = hexapod::RobotBase::kAutoGaitMode + 1;
+const char* const kGaitNames[kQuadGaitCount] = {"trot", "walk", "gallop", "creep", "auto"};
+const char* const kJointNames[3] = {"coxa", "femur", "tibia"};
+
+// 已知失败：四足 creep 表由 pathTool 生成（src/generated/movement_table_quad.h），
+// forwardfast 的步幅超出舵机行程（运行中限幅），shiftleft/shiftright 的进出对齐越限。
+// 自动步态在这些模式下不选 creep（见 QuadRobot::autoGaitFor）。clamps 为默认 --cycles 3 时的次数，
+// 周期数更多时按比例放宽；重新生成步态表后应随之更新或删除
+struct KnownFailure {
+  const char* combo;
+  uint32_t clamps;
+};
+constexpr KnownFailure kKnownFailures[] = {
+  {"quad_creep_forwardfast_0.25", 516}, {"quad_creep_shiftleft_0.25", 56}, {"quad_creep_shiftright_0.25", 56},
+  {"quad_creep_forwardfast_0.33", 494}, {"quad_creep_shiftleft_0.33", 44}, {"quad_creep_shiftright_0.33", 44},
+  {"quad_creep_forwardfast_0.50", 264}, {"quad_creep_shiftleft_0.50", 30}, {"quad_creep_shiftright_0.50", 30},
+  {"quad_creep_forwardfast_1.00", 126}, {"quad_creep_shiftleft_1.00", 16}, {"quad_creep_shiftright_1.00", 16},
+};
+constexpr float kKnownFailureCycles = 3.0f;
+
+struct Options {
+  bool hexapod = true;
+  bool quad = true;
+  int gait = -1;  // -1 表示全部
+  int mode = -1;
+  std::vector<float> speeds;
+  float cycles = 3.0f;
+  std::string csvDir;
+  std::string jsonPath;
+  bool verbose = false;
+};
+
+struct Combo {
+  bool quad;
+  int gait;  // 六足为 -1
+  MovementMode mode;
+  float speed;
+};
+
+struct Report {
+  Combo combo;
+  float cycleMs = 0.0f;
+  uint32_t enterMs = 0;
+  uint32_t runMs = 0;
+  uint32_t exitMs = 0;
+  bool enterTimeout = false;
+  bool runTimeout = false;
+  bool exitTimeout = false;
+  float cyclesDone = 0.0f;
+  bool marginValid = false;
+  float minMarginMm = 0.0f;
+  bool transitionMarginValid = false;
+  float minTransitionMarginMm = 0.0f;
+  uint32_t runTicks = 0;
+  uint32_t slowedTicks = 0;
+  uint32_t pauses = 0;
+  float maxVelocity[3] = {0.0f, 0.0f, 0.0f};  // 度/秒
+  float maxRunVelocity[3] = {0.0f, 0.0f, 0.0f};
+  float maxTransitionVelocity[3] = {0.0f, 0.0f, 0.0f};
+  bool transitionTooFast = false;
+  std::string fastJoint;
+  float minAngle[3] = {1e9f, 1e9f, 1e9f};
+  float maxAngle[3] = {-1e9f, -1e9f, -1e9f};
+  uint32_t clamps = 0;
+  std::string firstClamp;
+};
+
+// Servo::setAngle / ServoQuad::setAngle 限幅时输出 "exceed[关节][角度]"，经日志钩子统计
+uint32_t clampEvents = 0;
+std::string firstClampLine;
+bool echoLog = false;
+
+void onLog(const char* line) {
+  if (strstr(line, "exceed[")) {
+    ++clampEvents;
+    if (firstClampLine.empty()) {
+      firstClampLine = line;
+    }
+  }
+  if (echoLog) {
+    fprintf(stderr, "%s\n", line);
+  }
+}
+
+std::string comboName(const Combo& combo) {
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer), "%s_%s_%s_%.2f", combo.quad ? "quad" : "hexapod",
+           combo.quad ? kGaitNames[combo.gait] : "tripod", kModeNames[combo.mode], combo.speed);
+  return buffer;
+}
+
+const KnownFailure* findKnownFailure(const std::string& name) {
+  for (const KnownFailure& known : kKnownFailures) {
+    if (name == known.combo) {
+      return &known;
+    }
+  }
+  return nullptr;
+}
+
+// 逐帧 CSV：时间、阶段、实际模式、推进时间、足端位置、关节角度、触地数与稳定裕度
+class Recorder {
+public:
+  Recorder(const std::string& path, int legs) : legs_(legs) {
+    file_ = fopen(path.c_str(), "w");
+    if (!file_) {
+      fprintf(stderr, "cannot write %s\n", path.c_str());
+      return;
+    }
+    fprintf(file_, "t_ms,phase,executed_mode,transitioning,advanced_ms");
+    for (int i = 0; i < legs_; ++i) {
+      fprintf(file_, ",leg%d_x,leg%d_y,leg%d_z", i, i, i);
+    }
+    for (int i = 0; i < legs_; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        fprintf(file_, ",leg%d_%s", i, kJointNames[j]);
+      }
+    }
+    fprintf(file_, ",contacts,margin_valid,margin_mm,time_scale\n");
+  }
+
+  ~Recorder() {
+    if (file_) {
+      fclose(file_);
+    }
+  }
+
+  void row(uint32_t t, const char* phase, const hexapod::RobotBase& robot, MovementMode requested, int advancedMs) {
+    if (!file_) {
+      return;
+    }
+    fprintf(file_, "%u,%s,%s,%d,%d", t, phase, kModeNames[robot.executedMovementMode(requested)],
+            robot.isTransitioning() ? 1 : 0, advancedMs);
+    for (int i = 0; i < legs_; ++i) {
+      hexapod::Point3D tip(0, 0, 0);
+      robot.footTip(i, tip);
+      fprintf(file_, ",%.2f,%.2f,%.2f", tip.x_, tip.y_, tip.z_);
+    }
+    for (int i = 0; i < legs_; ++i) {
+      float angles[3] = {0.0f, 0.0f, 0.0f};
+      robot.jointAngles(i, angles);
+      fprintf(file_, ",%.2f,%.2f,%.2f", angles[0], angles[1], angles[2]);
+    }
+    const stability::Stats stats = robot.stabilityStats();
+    fprintf(file_, ",%u,%d,%.2f,%.2f\n", stats.last.contacts, stats.last.valid ? 1 : 0, stats.last.marginMm,
+            stats.timeScale);
+  }
+
+private:
+  FILE* file_ = nullptr;
+  int legs_;
+};
+
+class Simulation {
+public:
+  Simulation(hexapod::RobotBase& robot, const Combo& combo, Recorder* recorder)
+      : robot_(robot), combo_(combo), recorder_(recorder), legs_(robot.legCount()) {}
+
+  Report run(float cycles) {
+    report_.combo = combo_;
+    report_.cycleMs = robot_.getMovementCycleDurationMs(combo_.mode);
+
+    report_.enterTimeout = !transition(combo_.mode, "enter", report_.enterMs);
+
+    // 与 MotionController 一致：按实际推进时间累计周期数
+    const float targetMs = report_.cycleMs * cycles;
+    const uint32_t limitMs = static_cast<uint32_t>(targetMs) * kRunTimeoutFactor + kTickMs;
+    float advancedMs = 0.0f;
+    while (advancedMs < targetMs) {
+      const int advanced = tick(combo_.mode, "run", true);
+      advancedMs += advanced;
+      report_.runMs += kTickMs;
+      ++report_.runTicks;
+      if (advanced < kTickMs) {
+        ++report_.slowedTicks;
+      }
+      if (report_.runMs >= limitMs) {
+        report_.runTimeout = true;
+        break;
+      }
+    }
+    report_.cyclesDone = report_.cycleMs > 0.0f ? advancedMs / report_.cycleMs : 0.0f;
+
+    report_.exitTimeout = !transition(hexapod::MOVEMENT_STANDBY, "exit", report_.exitMs);
+    report_.pauses = robot_.stabilityStats().pauses;
+    checkTransitionSpeed();
+    return report_;
+  }
+
+private:
+  // 过渡插值按关节限速计时，角速度不应超过 限速 × 速度倍率；等待 entry 时仍按原步态表运动，
+  // 此时以运行阶段的峰值为准
+  void checkTransitionSpeed() {
+    const float* limits = combo_.quad ? hexapod::config::quadJointSpeedLimitDegPerSec
+                                      : hexapod::config::jointSpeedLimitDegPerSec;
+    for (int j = 0; j < 3; ++j) {
+      float allowed = limits[j] * combo_.speed;
+      if (report_.maxRunVelocity[j] > allowed) {
+        allowed = report_.maxRunVelocity[j];
+      }
+      if (report_.maxTransitionVelocity[j] > allowed * kTransitionSpeedTolerance && !report_.transitionTooFast) {
+        char buffer[96];
+        snprintf(buffer, sizeof(buffer), "%s %.0f > %.0f deg/s", kJointNames[j], report_.maxTransitionVelocity[j],
+                 allowed);
+        report_.transitionTooFast = true;
+        report_.fastJoint = buffer;
+      }
+    }
+  }
+
+  // 请求 mode 直到实际执行 mode 一致且不再处于切换过渡；超时返回 false
+  bool transition(MovementMode mode, const char* phase, uint32_t& elapsedMs) {
+    elapsedMs = 0;
+    while (elapsedMs < kTransitionTimeoutMs) {
+      tick(mode, phase, false);
+      elapsedMs += kTickMs;
+      if (robot_.executedMovementMode(mode) == mode && !robot_.isTransitioning()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int tick(MovementMode mode, const char* phase, bool running) {
+    const uint32_t evaluationsBefore = robot_.stabilityStats().evaluations;
+    robot_.processMovement(mode, kTickMs);
+    hostsim::advanceMillis(kTickMs);
+    timeMs_ += kTickMs;
+    const int advanced = robot_.lastMovementAdvanceMs(kTickMs);
+
+    for (int i = 0; i < legs_; ++i) {
+      float angles[3];
+      if (!robot_.jointAngles(i, angles)) {
+        continue;
+      }
+      for (int j = 0; j < 3; ++j) {
+        if (hasPrevious_) {
+          const float velocity = std::fabs(angles[j] - previous_[i][j]) * 1000.0f / kTickMs;
+          if (velocity > report_.maxVelocity[j]) {
+            report_.maxVelocity[j] = velocity;
+          }
+          float& phaseMax = running ? report_.maxRunVelocity[j] : report_.maxTransitionVelocity[j];
+          if (velocity > phaseMax) {
+            phaseMax = velocity;
+          }
+        }
+        if (angles[j] < report_.minAngle[j]) {
+          report_.minAngle[j] = angles[j];
+        }
+        if (angles[j] > report_.maxAngle[j]) {
+          report_.maxAngle[j] = angles[j];
+        }
+        previous_[i][j] = angles[j];
+      }
+    }
+    hasPrevious_ = true;
+
+    // 只统计本帧新算出的裕度（动态步态不计算，last 保留的是旧值），且只看有摆动腿的支撑相
+    const stability::Stats stats = robot_.stabilityStats();
+    if (stats.evaluations != evaluationsBefore && stats.last.valid && stats.last.contacts < legs_) {
+      bool& valid = running ? report_.marginValid : report_.transitionMarginValid;
+      float& margin = running ? report_.minMarginMm : report_.minTransitionMarginMm;
+      if (!valid || stats.last.marginMm < margin) {
+        margin = stats.last.marginMm;
+        valid = true;
+      }
+    }
+
+    if (recorder_) {
+      recorder_->row(timeMs_, phase, robot_, mode, advanced);
+    }
+    return advanced;
+  }
+
+  hexapod::RobotBase& robot_;
+  Combo combo_;
+  Recorder* recorder_;
+  int legs_;
+  Report report_;
+  uint32_t timeMs_ = 0;
+  float previous_[kMaxLegs][3] = {};
+  bool hasPrevious_ = false;
+};
+
+Report simulate(const Combo& combo, const Options& options) {
+  // 每个组合使用新的机器人实例与固定随机种子（六足入场帧随机选取），结果可复现
+  rng::seedAll(1);
+  hostsim::resetMillis();
+  clampEvents = 0;
+  firstClampLine.clear();
+
+  hexapod::HexapodClass hexapodRobot;
+  quadruped::QuadRobot quadRobot;
+  hexapod::RobotBase& robot = combo.quad ? static_cast<hexapod::RobotBase&>(quadRobot)
+                                         : static_cast<hexapod::RobotBase&>(hexapodRobot);
+  robot.init(false);
+  if (combo.quad) {
+    robot.setGaitMode(combo.gait);
+  }
+  robot.setMovementSpeed(combo.speed);
+
+  Recorder* recorder = nullptr;
+  if (!options.csvDir.empty()) {
+    recorder = new Recorder(options.csvDir + "/" + comboName(combo) + ".csv", robot.legCount());
+  }
+  Simulation simulation(robot, combo, recorder);
+  Report report = simulation.run(options.cycles);
+  delete recorder;
+
+  report.clamps = clampEvents;
+  report.firstClamp = firstClampLine;
+  return report;
+}
+
+void printSummary(const std::vector<Report>& reports) {
+  printf("%-8s %-7s %-11s %5s %7s %7s %6s %7s %7s %6s %6s %7s %7s %7s %6s\n", "model", "gait", "mode", "speed",
+         "cycleMs", "enterMs", "exitMs", "margin", "transMg", "slow%", "pauses", "coxa/s", "femur/s", "tibia/s",
+         "clamps");
+  for (const Report& r : reports) {
+    char margin[16] = "-";
+    char transitionMargin[16] = "-";
+    if (r.marginValid) {
+      snprintf(margin, sizeof(margin), "%.1f", r.minMarginMm);
+    }
+    if (r.transitionMarginValid) {
+      snprintf(transitionMargin, sizeof(transitionMargin), "%.1f", r.minTransitionMarginMm);
+    }
+    char enter[16];
+    char exit[16];
+    snprintf(enter, sizeof(enter), r.enterTimeout ? ">%u" : "%u", r.enterMs);
+    snprintf(exit, sizeof(exit), r.exitTimeout ? ">%u" : "%u", r.exitMs);
+    printf("%-8s %-7s %-11s %5.2f %7.0f %7s %6s %7s %7s %6.1f %6u %7.0f %7.0f %7.0f %6u%s\n",
+           r.combo.quad ? "quad" : "hexapod", r.combo.quad ? kGaitNames[r.combo.gait] : "tripod",
+           kModeNames[r.combo.mode], r.combo.speed, r.cycleMs, enter, exit, margin, transitionMargin,
+           r.runTicks ? 100.0f * r.slowedTicks / r.runTicks : 0.0f, r.pauses, r.maxVelocity[0], r.maxVelocity[1],
+           r.maxVelocity[2], r.clamps, r.runTimeout ? "  (run timeout)" : "");
+  }
+}
+
+bool writeJson(const std::vector<Report>& reports, const std::string& path) {
+  DynamicJsonDocument doc(2048 + reports.size() * 1536);
+  JsonArray runs = doc.createNestedArray("runs");
+  for (const Report& r : reports) {
+    JsonObject run = runs.createNestedObject();
+    run["model"] = r.combo.quad ? "quad" : "hexapod";
+    run["gait"] = r.combo.quad ? kGaitNames[r.combo.gait] : "tripod";
+    run["mode"] = kModeNames[r.combo.mode];
+    run["speed"] = r.combo.speed;
+    run["cycleMs"] = r.cycleMs;
+    run["cycles"] = r.cyclesDone;
+    run["enterMs"] = r.enterMs;
+    run["runMs"] = r.runMs;
+    run["exitMs"] = r.exitMs;
+    run["enterTimeout"] = r.enterTimeout;
+    run["runTimeout"] = r.runTimeout;
+    run["exitTimeout"] = r.exitTimeout;
+    if (r.marginValid) {
+      run["minMarginMm"] = r.minMarginMm;
+    }
+    if (r.transitionMarginValid) {
+      run["minTransitionMarginMm"] = r.minTransitionMarginMm;
+    }
+    run["slowedTicks"] = r.slowedTicks;
+    run["runTicks"] = r.runTicks;
+    run["pauses"] = r.pauses;
+    JsonObject joints = run.createNestedObject("joints");
+    for (int j = 0; j < 3; ++j) {
+      JsonObject joint = joints.createNestedObject(kJointNames[j]);
+      joint["maxVelocityDegS"] = r.maxVelocity[j];
+      joint["maxTransitionVelocityDegS"] = r.maxTransitionVelocity[j];
+      joint["minDeg"] = r.minAngle[j];
+      joint["maxDeg"] = r.maxAngle[j];
+    }
+    run["clamps"] = r.clamps;
+    run["transitionTooFast"] = r.transitionTooFast;
+    if (!r.firstClamp.empty()) {
+      run["firstClamp"] = r.firstClamp;
+    }
+  }
+  if (doc.overflowed()) {
+    fprintf(stderr, "json document overflowed\n");
+    return false;
+  }
+
+  std::string output;
+  serializeJsonPretty(doc, output);
+  FILE* file = fopen(path.c_str(), "w");
+  if (!file) {
+    fprintf(stderr, "cannot write %s\n", path.c_str());
+    return false;
+  }
+  fwrite(output.data(), 1, output.size(), file);
+  fputc('\n', file);
+  fclose(file);
+  return true;
+}
+
+void usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  --model hexapod|quad|all   机型（默认 all）\n"
+          "  --gait trot|walk|gallop|creep|auto|all  四足步态（默认 all）\n"
+          "  --mode <name>|all          运动模式（默认：六足全部 14 种，四足 7 种行走模式）\n"
+          "  --speed a,b,...            速度倍率（默认为 4 个速度档位）\n"
+          "  --cycles N                 每个组合运行的周期数（默认 3）\n"
+          "  --csv DIR                  每个组合输出逐帧 CSV 到已存在的目录\n"
+          "  --json FILE                输出汇总 JSON\n"
+          "  --verbose                  固件日志输出到 stderr\n",
+          program);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (arg == "--verbose") {
+      options.verbose = true;
+      continue;
+    }
+    if (arg == "--help" || !value) {
+      return false;
+    }
+    ++i;
+    if (arg == "--model") {
+      const std::string model = value;
+      options.hexapod = model == "hexapod" || model == "all";
+      options.quad = model == "quad" || model == "all";
+      if (!options.hexapod && !options.quad) {
+        return false;
+      }
+    } else if (arg == "--gait") {
+      options.gait = -1;
+      for (int g = 0; g < kQuadGaitCount; ++g) {
+        if (strcmp(value, kGaitNames[g]) == 0) {
+          options.gait = g;
+        }
+      }
+      if (options.gait < 0 && strcmp(value, "all") != 0) {
+        return false;
+      }
+    } else if (arg == "--mode") {
+      MovementMode mode;
+      if (strcmp(value, "all") == 0) {
+        options.mode = -1;
+      } else if (cmdkeys::lookupMovementMode(value, mode)) {
+        options.mode = mode;
+      } else {
+        return false;
+      }
+    } else if (arg == "--speed") {
+      options.speeds.clear();
+      const char* p = value;
+      while (*p) {
+        char* end = nullptr;
+        const float speed = strtof(p, &end);
+        if (end == p || speed < hexapod::config::minSpeed || speed > hexapod::config::maxSpeed) {
+          return false;
+        }
+        options.speeds.push_back(speed);
+        p = *end == ',' ? end + 1 : end;
+      }
+    } else if (arg == "--cycles") {
+      options.cycles = strtof(value, nullptr);
+      if (options.cycles <= 0.0f) {
+        return false;
+      }
+    } else if (arg == "--csv") {
+      options.csvDir = value;
+    } else if (arg == "--json") {
+      options.jsonPath = value;
+    } else {
+      return false;
+    }
+  }
+  if (options.speeds.empty()) {
+    for (float speed : hexapod::speedLevelMultipliers) {
+      options.speeds.push_back(speed);
+    }
+  }
+  return true;
+}
+
+std::vector<Combo> buildCombos(const Options& options) {
+  std::vector<Combo> combos;
+  for (float speed : options.speeds) {
+    if (options.hexapod) {
+      for (int m = hexapod::MOVEMENT_STANDBY; m < hexapod::MOVEMENT_TOTAL; ++m) {
+        if (options.mode < 0 || options.mode == m) {
+          combos.push_back({false, -1, static_cast<MovementMode>(m), speed});
+        }
+      }
+    }
+    if (options.quad) {
+      for (int g = 0; g < kQuadGaitCount; ++g) {
+        if (options.gait >= 0 && options.gait != g) {
+          continue;
+        }
+        for (int m = hexapod::MOVEMENT_FORWARD; m < hexapod::MOVEMENT_TOTAL; ++m) {
+          const bool selected = options.mode < 0 ? hexapod::isLocomotionMode(static_cast<MovementMode>(m))
+                                                 : options.mode == m;
+          if (selected) {
+            combos.push_back({true, g, static_cast<MovementMode>(m), speed});
+          }
+        }
+      }
+    }
+  }
+  return combos;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+  echoLog = options.verbose;
+  hostsim::setSerialEcho(options.verbose);
+  hexapod::initLogOutput(onLog, nullptr);
+
+  std::vector<Report> reports;
+  for (const Combo& combo : buildCombos(options)) {
+    reports.push_back(simulate(combo, options));
+  }
+  printSummary(reports);
+  fflush(stdout);
+
+  if (!options.jsonPath.empty() && !writeJson(reports, options.jsonPath)) {
+    return 2;
+  }
+
+  int failures = 0;
+  int known = 0;
+  for (const Report& r : reports) {
+    const std::string name = comboName(r.combo);
+    const KnownFailure* knownFailure = findKnownFailure(name);
+    const bool otherFailure = r.enterTimeout || r.runTimeout || r.exitTimeout || r.transitionTooFast;
+    if (knownFailure && !otherFailure) {
+      const float scale = options.cycles > kKnownFailureCycles ? options.cycles / kKnownFailureCycles : 1.0f;
+      const uint32_t allowed = static_cast<uint32_t>(knownFailure->clamps * scale + 0.5f);
+      if (r.clamps == 0) {
+        fprintf(stderr, "FIXED %s: no longer fails, remove it from kKnownFailures\n", name.c_str());
+        continue;
+      }
+      if (r.clamps <= allowed) {
+        ++known;
+        fprintf(stderr, "KNOWN %s: clamps %u (<= %u)\n", name.c_str(), r.clamps, allowed);
+        continue;
+      }
+    }
+    if (r.clamps > 0 || otherFailure) {
+      ++failures;
+      fprintf(stderr, "FAIL %s: clamps %u%s%s%s%s%s%s%s\n", name.c_str(), r.clamps,
+              r.firstClamp.empty() ? "" : " (first: ", r.firstClamp.c_str(), r.firstClamp.empty() ? "" : ")",
+              r.enterTimeout || r.exitTimeout ? ", transition timeout" : "", r.runTimeout ? ", run timeout" : "",
+              r.transitionTooFast ? ", transition too fast: " : "", r.fastJoint.c_str());
+    }
+  }
+  printf("%zu runs, %d failed, %d known\n", reports.size(), failures, known);
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+// 主机仿真：PCA9685 驱动替身，记录最后一次写入的通道值；设置 writeHook 后每次写入都会回调（回放输出舵机帧用）
+#pragma once
+
+#include <cstdint>
+
+class Adafruit_PWMServoDriver {
+public:
+  typedef void (*WriteHook)(uint8_t address, uint8_t channel, uint16_t on, uint16_t off);
+
+  static WriteHook& writeHook() {
+    static WriteHook hook = nullptr;
+    return hook;
+  }
+
+  explicit Adafruit_PWMServoDriver(uint8_t address = 0x40) : address_(address) {}
+
+  void begin() {}
+  void setOscillatorFrequency(uint32_t hz) { (void)hz; }
+  void setPWMFreq(float freq) { (void)freq; }
+  void setPWM(uint8_t channel, uint16_t on, uint16_t off) {
+    if (channel < 16) {
+      on_[channel] = on;
+      off_[channel] = off;
+      if (writeHook()) {
+        writeHook()(address_, channel, on, off);
+      }
+    }
+  }
+
+  uint8_t address() const { return address_; }
+
+private:
+  uint8_t address_;
+  uint16_t on_[16] = {};
+  uint16_t off_[16] = {};
+};
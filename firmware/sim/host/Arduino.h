@@ -0,0 +1,55 @@
+// 主机仿真用的最小 Arduino 运行时：只覆盖 sim/ 下主机程序链接的固件源码用到的部分
+// - String 退化为 std::string（与 calibration.h 的非 Arduino 分支一致）
+// - millis() 返回仿真时间，由仿真程序推进
+// - Serial 输出默认丢弃，避免固件日志混进汇总表
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+using String = std::string;
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+// newlib 与 BSD/macOS 提供；glibc 2.38 起才有
+#if defined(__GLIBC__) && !defined(__APPLE__)
+#if !__GLIBC_PREREQ(2, 38)
+#define HOSTSIM_NEEDS_STRLCPY
+#endif
+#endif
+#ifdef HOSTSIM_NEEDS_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+class HostSerial {
+public:
+  size_t write(uint8_t c);
+  size_t write(const uint8_t* buffer, size_t length);
+
+  size_t print(const char* text);
+  size_t print(const std::string& text) { return print(text.c_str()); }
+  size_t print(int value);
+  size_t println() { return print("\n"); }
+  size_t println(const char* text);
+  size_t println(const std::string& text) { return println(text.c_str()); }
+  size_t println(int value);
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HostSerial Serial;
+
+namespace hostsim {
+
+// 推进 / 重置仿真时钟
+void advanceMillis(uint32_t ms);
+void resetMillis();
+
+// Serial 输出转到 stderr（调试用）
+void setSerialEcho(bool enabled);
+
+}  // namespace hostsim
@@ -0,0 +1,8 @@
+// 主机仿真：storage.h 只需要 fs::FS 的声明
+#pragma once
+
+namespace fs {
+
+class FS {};
+
+}  // namespace fs
@@ -0,0 +1,23 @@
+// 主机仿真：PCA9685 不经过 I2C，读寄存器一律无应答（hal::PCA9685::recoverFromReset 不做处理）
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class TwoWire {
+public:
+  void beginTransmission(uint8_t address) { (void)address; }
+  size_t write(uint8_t value) {
+    (void)value;
+    return 1;
+  }
+  uint8_t endTransmission() { return 2; }  // 地址无应答
+  uint8_t requestFrom(uint8_t address, uint8_t length) {
+    (void)address;
+    (void)length;
+    return 0;
+  }
+  int read() { return -1; }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,21 @@
+// 主机仿真：FreeRTOS 替身（单线程运行，只覆盖固件源码用到的类型与宏）
+#pragma once
+
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+
+// 临界区（单线程运行，进入/退出均为空操作）
+struct portMUX_TYPE {
+  uint32_t owner;
+  uint32_t count;
+};
+#define portMUX_INITIALIZER_UNLOCKED {0xB33FFFFF, 0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
@@ -0,0 +1,22 @@
+// 主机仿真：互斥量替身（单线程，获取总是成功）
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  static int handle = 0;
+  return &handle;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+  (void)mutex;
+  (void)ticks;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  (void)mutex;
+  return pdTRUE;
+}
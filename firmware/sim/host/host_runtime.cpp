@@ -0,0 +1,145 @@
+// 主机仿真运行时：仿真时钟、Serial / Wire 与存储层替身
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <cstdarg>
+
+#include "storage.h"
+
+HostSerial Serial;
+TwoWire Wire;
+
+namespace {
+
+uint32_t nowMs = 0;
+bool serialEcho = false;
+
+}  // namespace
+
+uint32_t millis() {
+  return nowMs;
+}
+
+uint32_t micros() {
+  return nowMs * 1000u;
+}
+
+void delay(uint32_t ms) {
+  nowMs += ms;
+}
+
+#ifdef HOSTSIM_NEEDS_STRLCPY
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  const size_t length = strlen(src);
+  if (size > 0) {
+    const size_t count = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, count);
+    dst[count] = '\0';
+  }
+  return length;
+}
+#endif
+
+size_t HostSerial::write(uint8_t c) {
+  if (serialEcho) {
+    fputc(c, stderr);
+  }
+  return 1;
+}
+
+size_t HostSerial::write(const uint8_t* buffer, size_t length) {
+  if (serialEcho) {
+    fwrite(buffer, 1, length, stderr);
+  }
+  return length;
+}
+
+size_t HostSerial::print(const char* text) {
+  return write(reinterpret_cast<const uint8_t*>(text), strlen(text));
+}
+
+size_t HostSerial::print(int value) {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%d", value);
+  return print(buffer);
+}
+
+size_t HostSerial::println(const char* text) {
+  return print(text) + print("\n");
+}
+
+size_t HostSerial::println(int value) {
+  return print(value) + print("\n");
+}
+
+size_t HostSerial::printf(const char* format, ...) {
+  char buffer[256];
+  va_list ap;
+  va_start(ap, format);
+  const int length = vsnprintf(buffer, sizeof(buffer), format, ap);
+  va_end(ap);
+  return length > 0 ? print(buffer) : 0;
+}
+
+namespace hostsim {
+
+void advanceMillis(uint32_t ms) {
+  nowMs += ms;
+}
+
+void resetMillis() {
+  nowMs = 0;
+}
+
+void setSerialEcho(bool enabled) {
+  serialEcho = enabled;
+}
+
+}  // namespace hostsim
+
+// 仿真不读写 flash：校准文件视为不存在，舵机使用零偏移
+namespace storage {
+
+namespace {
+
+fs::FS hostFs;
+
+}  // namespace
+
+bool begin() {
+  return true;
+}
+
+bool isMounted() {
+  return true;
+}
+
+fs::FS& filesystem() {
+  return hostFs;
+}
+
+bool exists(const char* path) {
+  (void)path;
+  return false;
+}
+
+bool writeRecord(const char* path, const String& payload, String& error) {
+  (void)path;
+  (void)payload;
+  error = "read-only in simulation";
+  return false;
+}
+
+bool readRecord(const char* path, String& payload, String& error) {
+  (void)path;
+  payload.clear();
+  error = "no file in simulation";
+  return false;
+}
+
+Timings getTimings() {
+  return Timings();
+}
+
+}  // namespace storage
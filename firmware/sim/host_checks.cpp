@@ -0,0 +1,398 @@
+// 与平台无关模块的主机自检（主机上运行，不参与固件构建）
+//
+// 对下列模块的纯计算部分做固定输入 -> 期望输出的检查，任一项不符时打印 FAIL 并返回 1，可直接在 CI 中运行：
+//   rng          - PCG32 参考序列（pcg32_srandom(42, 54)）、below() 的边界、子系统序列互不影响
+//   transition   - durationMs 的倍速换算与向上取整到控制周期、按最慢关节 / 最慢路径段计时
+//   stability    - 支撑多边形裕度（四足站立正方形、三腿支撑三角形、重心偏移、双腿支撑无静态裕度）
+//   battery      - 开路电压 -> SoC 查表、首次采样的 IR 补偿与续航、负载电流估算
+//   powergovernor - 电流预算与限速收敛点、电池估计无效时放开限速
+//   motion       - clearLane 连续清除相邻序列后空闲槽位数不变（不重复释放）
+//   serialframe  - 文本帧组装：起始符前的垃圾、CR/LF/CRLF、超长帧丢弃、超时复位；并输出组帧吞吐（帧/秒）
+//   serialpacket - CRC-16/CCITT-FALSE 校验值、COBS 往返（含内嵌 0x00、254 字节无零段）、报文经 COBS 组帧后解码
+//
+// 编译运行（在 firmware 目录下，sim/host 提供最小的 Arduino / FreeRTOS / 存储层替身）：
+//   g++ -std=gnu++11 -O2 -DROBOT_MODEL_NODEQUADMINI -Isim/host -Iinclude -Isrc -Ilib/hal -Ilib/ArduinoJson/src sim/host_checks.cpp sim/host/host_runtime.cpp src/debug.cpp src/movement_profile.cpp src/motion_controller.cpp src/rng.cpp src/transition_timing.cpp src/stability.cpp src/battery_estimator.cpp src/power_governor.cpp src/serial_frame.cpp src/serial_packet.cpp -o /tmp/host_checks
+//   /tmp/host_checks
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "battery_estimator.h"
+#include "config.h"
+#include "motion_controller.h"
+#include "power_governor.h"
+#include "rng.h"
+#include "robot.h"
+#include "serial_frame.h"
+#include "serial_packet.h"
+#include "stability.h"
+#include "transition_timing.h"
+
+namespace hexapod {
+
+// 固件中由 hexapod.cpp / robot_quad_entry.cpp 按机型定义；这里只检查 MotionController 的队列，不需要机器人实例
+RobotBase* Robot = nullptr;
+
+}  // namespace hexapod
+
+namespace {
+
+int failures = 0;
+int checks = 0;
+
+void expectTrue(bool ok, const char* name) {
+  ++checks;
+  if (!ok) {
+    ++failures;
+    fprintf(stderr, "FAIL %s\n", name);
+  }
+}
+
+void expectEq(long long actual, long long expected, const char* name) {
+  ++checks;
+  if (actual != expected) {
+    ++failures;
+    fprintf(stderr, "FAIL %s: got %lld, expected %lld\n", name, actual, expected);
+  }
+}
+
+void expectNear(double actual, double expected, double tolerance, const char* name) {
+  ++checks;
+  if (!(std::fabs(actual - expected) <= tolerance)) {
+    ++failures;
+    fprintf(stderr, "FAIL %s: got %.4f, expected %.4f (+-%.4f)\n", name, actual, expected, tolerance);
+  }
+}
+
+void checkRng() {
+  // PCG 参考实现 pcg32-global-demo 的前 6 个输出
+  static const uint32_t kReference[] = {0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu};
+  rng::Pcg32 pcg;
+  pcg.seed(42u, 54u);
+  bool match = true;
+  for (uint32_t expected : kReference) {
+    match = match && pcg.next() == expected;
+  }
+  expectTrue(match, "rng: pcg32 reference vector");
+
+  expectEq(pcg.below(0), 0, "rng: below(0)");
+  expectEq(pcg.below(1), 0, "rng: below(1)");
+  bool inRange = true;
+  for (int i = 0; i < 1000; ++i) {
+    inRange = inRange && pcg.below(7) < 7;
+  }
+  expectTrue(inRange, "rng: below(7) in range");
+
+  // 同一种子下，一个子系统多取数不改变另一个子系统的序列
+  rng::seedAll(1234);
+  const uint32_t first = rng::next(rng::Subsystem::MovementEntry);
+  const uint32_t second = rng::next(rng::Subsystem::MovementEntry);
+  rng::seedAll(1234);
+  rng::next(rng::Subsystem::Performance);
+  rng::next(rng::Subsystem::Performance);
+  expectTrue(rng::next(rng::Subsystem::MovementEntry) == first && rng::next(rng::Subsystem::MovementEntry) == second,
+             "rng: subsystem streams independent");
+  expectTrue(rng::isSeeded() && rng::lastSeed() == 1234, "rng: lastSeed");
+}
+
+void checkTransition() {
+  const int period = hexapod::config::movementInterval;
+  expectEq(transition::durationMs(0.0f, 1.0f, 0), period, "transition: at least one period");
+  expectEq(transition::durationMs(period * 2.0f, 1.0f, 0), period * 2, "transition: exact multiple");
+  expectEq(transition::durationMs(period * 2.0f + 0.1f, 1.0f, 0), period * 3, "transition: rounds up");
+  expectEq(transition::durationMs(period * 2.0f, 0.5f, 0), period * 4, "transition: half speed doubles");
+  expectEq(transition::durationMs(period * 2.0f, 0.0f, 0), period * 2, "transition: speed 0 treated as 1");
+  expectEq(transition::durationMs(1.0f, 1.0f, period * 3 + 1), period * 4, "transition: minMs rounds up");
+
+  // 最慢的关节决定时长；限速为 0 的关节不参与
+  const float limits[3] = {100.0f, 200.0f, 0.0f};
+  const float from[3] = {0.0f, 0.0f, 0.0f};
+  const float to[3] = {10.0f, -40.0f, 90.0f};
+  expectNear(transition::jointTravelMs(from, to, limits), 200.0, 1e-3, "transition: slowest joint");
+
+  // 起止相同、中段绕开：按最慢一段乘以段数，而不是起止角度差
+  const float path[5][3] = {{0, 0, 0}, {5, 0, 0}, {20, 0, 0}, {5, 0, 0}, {0, 0, 0}};
+  expectNear(transition::pathTravelMs(path, 4, limits), 600.0, 1e-3, "transition: path slowest segment");
+}
+
+void checkStability() {
+  const hexapod::Point3D feet[4] = {
+    hexapod::Point3D(-50, -50, -80), hexapod::Point3D(50, -50, -80),
+    hexapod::Point3D(-50, 50, -80), hexapod::Point3D(50, 50, -80),
+  };
+  stability::Config config;
+
+  bool all[4] = {true, true, true, true};
+  stability::Result r = stability::evaluate(feet, all, 4, config);
+  expectTrue(r.valid && r.contacts == 4, "stability: four contacts valid");
+  expectNear(r.marginMm, 50.0, 0.01, "stability: square margin");
+
+  // 抬起右前腿：重心正好落在对角线上
+  bool three[4] = {true, true, true, false};
+  r = stability::evaluate(feet, three, 4, config);
+  expectTrue(r.valid, "stability: three contacts valid");
+  expectNear(r.marginMm, 0.0, 0.01, "stability: diagonal margin");
+
+  // 重心移向支撑三角形内部 (-10, -10)：到对角线的距离为 20 / sqrt(2)
+  config.comOffsetXMm = -10.0f;
+  config.comOffsetYMm = -10.0f;
+  r = stability::evaluate(feet, three, 4, config);
+  expectNear(r.marginMm, 20.0 / std::sqrt(2.0), 0.01, "stability: shifted com margin");
+
+  bool two[4] = {true, false, false, true};
+  r = stability::evaluate(feet, two, 4, config);
+  expectTrue(!r.valid, "stability: two contacts have no static margin");
+}
+
+void checkBattery() {
+  expectNear(battery::Estimator::socFromCellVoltage(2.5f), 0.0, 1e-4, "battery: soc below curve");
+  expectNear(battery::Estimator::socFromCellVoltage(3.82f), 50.0, 1e-3, "battery: soc at anchor");
+  expectNear(battery::Estimator::socFromCellVoltage(3.845f), 55.0, 1e-3, "battery: soc interpolated");
+  expectNear(battery::Estimator::socFromCellVoltage(4.3f), 100.0, 1e-4, "battery: soc above curve");
+
+  // 首次采样：7.64V 带载、0.6A、内阻初值 0.25Ω -> 开路 7.79V（单节 3.895V，SoC 65%）
+  battery::Config config;
+  battery::Estimator estimator(config);
+  const battery::State& s = estimator.update(7.64f, 0.6f, 1.0f);
+  expectTrue(s.valid, "battery: first sample valid");
+  expectEq(s.openCircuitMv, 7790, "battery: ir compensation");
+  expectNear(s.socPercent, 65.0, 0.01, "battery: first sample soc");
+  const double usable = 65.0 - battery::Estimator::socFromCellVoltage(config.floorCellVoltage);
+  expectNear(s.runtimeSec, usable / 100.0 * config.capacityAh / 0.6 * 3600.0, 1.0, "battery: runtime");
+
+  expectNear(battery::estimateLoadCurrent(config, false, 1.0f), config.idleCurrentA, 1e-6, "battery: idle current");
+  expectNear(battery::estimateLoadCurrent(config, true, 1.0f), config.idleCurrentA + config.activeCurrentA, 1e-6,
+             "battery: moving current");
+  expectNear(battery::estimateLoadCurrent(config, true, 0.0f), config.idleCurrentA + config.activeCurrentA * 0.1f, 1e-6,
+             "battery: speed clamped");
+}
+
+void checkPowerGovernor() {
+  powergovernor::Config config;
+  powergovernor::Governor governor(config);
+  // 开路 8.0V、内阻 0.25Ω、下限 7.0V -> 预算 4A；不限速时动态电流 4.25A。
+  // 收紧不超过 (4 - 0.6) / 4.25 = 0.8，回差（预算 3.4A）以上才放开：停在 [(3.4 - 0.6) / 4.25, 0.8] 之间
+  governor.setBattery(8.0f, 0.25f, true);
+  const int tickMs = hexapod::config::movementInterval;
+  const float dynamicA = 4.25f;
+  for (int t = 0; t < 10000; t += tickMs) {
+    const float stanceDeg = dynamicA * governor.limits().speedScale * (tickMs / 1000.0f) / config.stanceAmpsPerDegS;
+    governor.update(stanceDeg, 0.0f, tickMs);
+  }
+  expectNear(governor.stats().budgetA, 4.0, 1e-3, "governor: budget");
+  const float scale = governor.limits().speedScale;
+  expectTrue(scale >= 2.8f / dynamicA - 0.005f && scale <= 3.4f / dynamicA + 0.005f, "governor: speed scale in hysteresis band");
+  expectNear(governor.limits().liftScale, config.minLiftScale + (1.0f - config.minLiftScale) * (scale - config.minSpeedScale) /
+             (1.0f - config.minSpeedScale), 1e-4, "governor: lift follows speed");
+  // 再运行一段时间，限速保持不变（不在边界上来回切换）
+  for (int t = 0; t < 5000; t += tickMs) {
+    const float stanceDeg = dynamicA * governor.limits().speedScale * (tickMs / 1000.0f) / config.stanceAmpsPerDegS;
+    governor.update(stanceDeg, 0.0f, tickMs);
+  }
+  expectNear(governor.limits().speedScale, scale, 1e-3, "governor: steady");
+  expectTrue(governor.stats().engaged && governor.stats().engageCount == 1, "governor: engaged once");
+
+  governor.setBattery(0.0f, 0.0f, false);
+  for (int t = 0; t < 5000; t += tickMs) {
+    governor.update(0.0f, 0.0f, tickMs);
+  }
+  expectNear(governor.limits().speedScale, 1.0, 1e-6, "governor: released without battery");
+  expectEq(static_cast<long long>(governor.stats().budgetA * 1000), 0, "governor: no budget without battery");
+}
+
+void checkMotionController() {
+  motion::MotionController& controller = motion::MotionController::instance();
+  controller.begin();
+  motion::Action hold;
+  hold.mode = hexapod::MOVEMENT_FORWARD;
+  controller.enqueue(hold);
+  const size_t freeBefore = controller.freeSlots();
+
+  motion::Action actions[2];
+  for (motion::Action& a : actions) {
+    a.mode = hexapod::MOVEMENT_FORWARD;
+    a.unit = motion::Unit::Cycles;
+    a.value = 1;
+    a.priority = motion::Priority::Performance;
+  }
+  actions[1].sequenceTail = true;
+  // 两个序列占用相邻的槽位：清除第一个后第二个移到同一槽位，必须重新检查该槽位
+  actions[0].sequenceId = actions[1].sequenceId = 15;
+  expectTrue(controller.enqueueSequence(actions, 2), "motion: enqueue sequence 15");
+  actions[0].sequenceId = actions[1].sequenceId = 30;
+  expectTrue(controller.enqueueSequence(actions, 2), "motion: enqueue sequence 30");
+  controller.clearLane(motion::Priority::Performance);
+  expectEq(controller.freeSlots(), freeBefore, "motion: clearLane frees each slot once");
+
+  expectTrue(controller.enqueueSequence(actions, 2), "motion: enqueue after clear");
+  expectTrue(controller.cancelSequence(30), "motion: cancel sequence");
+  expectEq(controller.freeSlots(), freeBefore, "motion: cancel frees each slot once");
+}
+
+void collectFrame(char* frame, size_t length, void* context) {
+  static_cast<std::vector<std::string>*>(context)->push_back(std::string(frame, length));
+}
+
+void countFrame(char* frame, size_t length, void* context) {
+  (void)frame;
+  *static_cast<size_t*>(context) += length;
+}
+
+size_t feedText(seriallink::FrameAssembler& assembler, const char* text, std::vector<std::string>& frames) {
+  return assembler.feed(reinterpret_cast<const uint8_t*>(text), strlen(text), collectFrame, &frames);
+}
+
+void checkSerialFrame() {
+  seriallink::FrameAssembler assembler;
+  std::vector<std::string> frames;
+
+  // 起始符之前的字节（上电噪声、半条旧帧）丢弃，CR / LF / CRLF 都结束一帧，CRLF 不产生空帧
+  expectEq(feedText(assembler, "noise}\n\r$a\n$b\r$c\r\n", frames), 3, "serialframe: garbage and line endings");
+  expectTrue(frames.size() == 3 && frames[0] == "a" && frames[1] == "b" && frames[2] == "c",
+             "serialframe: frame contents");
+
+  // 一帧分多次到达
+  frames.clear();
+  feedText(assembler, "$mo", frames);
+  expectTrue(assembler.inFrame() && assembler.pendingLength() == 2, "serialframe: partial frame pending");
+  feedText(assembler, "ve\n", frames);
+  expectTrue(frames.size() == 1 && frames[0] == "move", "serialframe: split frame");
+
+  // 超长帧丢弃到行尾，不影响下一帧
+  frames.clear();
+  std::string oversize = "$" + std::string(seriallink::FrameAssembler::kMaxFrameLength + 1, 'x') + "\n$ok\n";
+  const uint32_t overflowsBefore = assembler.overflowCount();
+  feedText(assembler, oversize.c_str(), frames);
+  expectTrue(frames.size() == 1 && frames[0] == "ok", "serialframe: oversize frame dropped");
+  expectEq(assembler.overflowCount() - overflowsBefore, 1, "serialframe: overflow counted");
+  std::string full = "$" + std::string(seriallink::FrameAssembler::kMaxFrameLength, 'y') + "\n";
+  frames.clear();
+  feedText(assembler, full.c_str(), frames);
+  expectTrue(frames.size() == 1 && frames[0].size() == seriallink::FrameAssembler::kMaxFrameLength,
+             "serialframe: max length frame kept");
+
+  // 超时（serial_link 的链路任务在半帧空闲超过 idleTimeoutMs 时调用 reset）：残余的后半截没有起始符，被丢弃
+  frames.clear();
+  feedText(assembler, "$stal", frames);
+  assembler.reset();
+  expectTrue(!assembler.inFrame() && assembler.pendingLength() == 0, "serialframe: reset drops partial frame");
+  feedText(assembler, "e\n$fresh\n", frames);
+  expectTrue(frames.size() == 1 && frames[0] == "fresh", "serialframe: tail after timeout ignored");
+
+  // 吞吐：典型的短 JSON 指令反复组帧（只输出，不作为检查项）
+  const char* command = "${\"type\":\"command\",\"command\":\"forward\",\"speed\":0.5}\n";
+  std::string stream;
+  for (int i = 0; i < 1000; ++i) {
+    stream += command;
+  }
+  size_t bytes = 0;
+  size_t total = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 200; ++round) {
+    total += assembler.feed(reinterpret_cast<const uint8_t*>(stream.data()), stream.size(), countFrame, &bytes);
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  expectEq(total, 200 * 1000, "serialframe: throughput frames complete");
+  printf("serialframe: %.0f frames/s (%zu-byte frames)\n", 200 * 1000 / (seconds > 0 ? seconds : 1e-9),
+         strlen(command));
+}
+
+bool cobsRoundTrip(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> encoded(data.size() + data.size() / 254 + 1);
+  const size_t length = seriallink::cobsEncode(data.data(), data.size(), encoded.data());
+  if (length > encoded.size() || std::find(encoded.begin(), encoded.begin() + length, 0) != encoded.begin() + length) {
+    return false;
+  }
+  size_t decoded = 0;
+  return seriallink::cobsDecode(encoded.data(), length, decoded) && decoded == data.size() &&
+         std::equal(data.begin(), data.end(), encoded.begin());
+}
+
+std::vector<uint8_t> nonZeroRun(size_t length) {
+  std::vector<uint8_t> data(length);
+  for (size_t i = 0; i < length; ++i) {
+    data[i] = static_cast<uint8_t>(i % 255 + 1);
+  }
+  return data;
+}
+
+void checkSerialPacket() {
+  const char* reference = "123456789";
+  expectEq(seriallink::crc16(reinterpret_cast<const uint8_t*>(reference), 9), 0x29B1, "serialpacket: crc16 check value");
+
+  expectTrue(cobsRoundTrip({}), "serialpacket: cobs empty");
+  expectTrue(cobsRoundTrip({0}), "serialpacket: cobs single zero");
+  expectTrue(cobsRoundTrip({0, 0, 0}), "serialpacket: cobs zeros only");
+  expectTrue(cobsRoundTrip({1, 0, 2, 0, 0, 3}), "serialpacket: cobs embedded zeros");
+  // 254 字节无零段正好填满一个编码块（code 0xFF），前后各差一个字节与紧跟 0x00 的情况最容易出错
+  bool runs = true;
+  for (size_t length : {253u, 254u, 255u, 508u, 509u}) {
+    runs = runs && cobsRoundTrip(nonZeroRun(length));
+    std::vector<uint8_t> withZero = nonZeroRun(length);
+    withZero.push_back(0);
+    runs = runs && cobsRoundTrip(withZero);
+    withZero.insert(withZero.begin(), 0);
+    runs = runs && cobsRoundTrip(withZero);
+  }
+  expectTrue(runs, "serialpacket: cobs 254-byte runs");
+  std::vector<uint8_t> exact = nonZeroRun(254);
+  std::vector<uint8_t> encoded(exact.size() + 2);
+  const size_t length = seriallink::cobsEncode(exact.data(), exact.size(), encoded.data());
+  expectTrue(length == 256 && encoded[0] == 0xFF && encoded[255] == 0x01, "serialpacket: cobs 254-byte block layout");
+
+  // 报文 -> COBS 帧 -> 组帧 -> 解码，payload 含 0x00 与 254 字节无零段
+  std::vector<uint8_t> payload = nonZeroRun(300);
+  payload[0] = 0;
+  payload[100] = 0;
+  std::vector<uint8_t> wire(seriallink::encodedPacketSize(payload.size()));
+  const size_t wireLength = seriallink::encodePacket(seriallink::MessageId::JsonCommand, 7, payload.data(),
+                                                     payload.size(), wire.data(), wire.size());
+  expectTrue(wireLength > 0 && wire[wireLength - 1] == 0, "serialpacket: encode terminated");
+
+  seriallink::FrameAssembler assembler;
+  assembler.setFraming(seriallink::Framing::Cobs);
+  std::vector<std::string> frames;
+  assembler.feed(wire.data(), wireLength, collectFrame, &frames);
+  bool decoded = false;
+  if (frames.size() == 1) {
+    seriallink::Packet packet;
+    seriallink::NackReason reason;
+    std::vector<uint8_t> frame(frames[0].begin(), frames[0].end());
+    decoded = seriallink::decodePacket(frame.data(), frame.size(), packet, reason) &&
+              packet.id == seriallink::MessageId::JsonCommand && packet.seq == 7 &&
+              packet.payloadLength == payload.size() && std::equal(payload.begin(), payload.end(), packet.payload);
+
+    // 改动一个字节：COBS 结构仍然有效时应报 CRC 错误
+    frame = std::vector<uint8_t>(frames[0].begin(), frames[0].end());
+    frame[frame.size() / 2] ^= 0x01;
+    const bool corrupted = seriallink::decodePacket(frame.data(), frame.size(), packet, reason);
+    expectTrue(!corrupted && reason == seriallink::NackReason::Crc, "serialpacket: corrupted byte rejected by crc");
+  }
+  expectTrue(decoded, "serialpacket: packet round trip through assembler");
+
+  seriallink::NackReason reason;
+  seriallink::Packet packet;
+  uint8_t shortFrame[] = {0x02, 0x01};
+  expectTrue(!seriallink::decodePacket(shortFrame, sizeof(shortFrame), packet, reason) &&
+             reason == seriallink::NackReason::Framing, "serialpacket: short frame rejected");
+}
+
+}  // namespace
+
+int main() {
+  checkRng();
+  checkTransition();
+  checkStability();
+  checkBattery();
+  checkPowerGovernor();
+  checkMotionController();
+  checkSerialFrame();
+  checkSerialPacket();
+  printf("%d checks, %d failed\n", checks, failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,403 @@
+// 控制会话回放（主机上运行，不参与固件构建）
+//
+// 读取设备录制的会话（GET /api/session 下载，格式见 src/session_recorder.h），以录制时的机型、速度与步态
+// 构造机器人并设置录制的随机数种子（rng::seedAll），按控制周期序号把指令送回固件同一套执行代码（command_dispatch.cpp 的 handleAdvanced /
+// applyMovementMode / runTick，以及 motion / performance / singleleg 控制器），每个周期记录一帧全部 PCA9685
+// 通道的输出（on/off tick）。不同固件版本回放同一会话得到的帧文件可以逐位比较，定位行为变化出现的周期与通道。
+//
+// 回放不模拟电池与功率调节（设备上可能降速），因此比较的是固件版本之间的差异，而不是设备与主机之间。
+//
+// 编译运行（在 firmware 目录下）：
+//   g++ -std=gnu++11 -O2 -DROBOT_MODEL_NODEQUADMINI -Isim/host -Iinclude -Isrc -Ilib/hal -Ilib/ArduinoJson/src sim/replay.cpp sim/host/host_runtime.cpp lib/hal/pwm.cpp src/debug.cpp src/command_keys.cpp src/command_dispatch.cpp src/session_recorder.cpp src/rng.cpp src/transition_timing.cpp src/motion_controller.cpp src/movement_profile.cpp src/performance_controller.cpp src/single_leg_controller.cpp src/servo.cpp src/servo_calibration.cpp src/leg.cpp src/movement.cpp src/movements.cpp src/hexapod.cpp src/quad_servo.cpp src/quad_leg.cpp src/quad_movement.cpp src/quad_movements.cpp src/quad_robot.cpp src/stability.cpp -o /tmp/replay
+//   /tmp/replay session.nhsr --frames /tmp/a.frames      # 回放并输出帧文件（另一个版本输出 /tmp/b.frames）
+//   /tmp/replay --compare /tmp/a.frames /tmp/b.frames    # 逐位比较，不一致时返回 1
+
+#ifndef ROBOT_MODEL_NODEQUADMINI
+#error "build with -DROBOT_MODEL_NODEQUADMINI so that the quad sources are compiled in"
+#endif
+
+#include <Adafruit_PWMServoDriver.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "command_dispatch.h"
+#include "command_keys.h"
+#include "debug.h"
+#include "hexapod.h"
+#include "motion_controller.h"
+#include "performance_controller.h"
+#include "quad_robot.h"
+#include "rng.h"
+#include "serial_packet.h"
+#include "session_recorder.h"
+#include "single_leg_controller.h"
+#include "transition_timing.h"
+
+namespace hexapod {
+
+// 固件中由 hexapod.cpp / robot_quad_entry.cpp 按机型定义；回放按录制的机型指向对应实例
+RobotBase* Robot = nullptr;
+
+}  // namespace hexapod
+
+namespace {
+
+constexpr int kChannels = 16;
+constexpr int kDefaultTailTicks = 50;
+constexpr char kFramesMagic[4] = {'N', 'H', 'F', 'R'};
+
+struct Options {
+  std::string sessionPath;
+  std::string framesPath;
+  std::string compareA;
+  std::string compareB;
+  int tailTicks = kDefaultTailTicks;
+  bool verbose = false;
+};
+
+// 帧：按板地址升序，每板 16 通道的 (on, off)
+std::map<uint8_t, std::vector<uint16_t>> boards;
+
+void onPwmWrite(uint8_t address, uint8_t channel, uint16_t on, uint16_t off) {
+  std::vector<uint16_t>& board = boards[address];
+  if (board.empty()) {
+    board.assign(kChannels * 2, 0);
+  }
+  board[channel * 2] = on;
+  board[channel * 2 + 1] = off;
+}
+
+void captureFrame(std::vector<uint16_t>& frames) {
+  for (const auto& board : boards) {
+    frames.insert(frames.end(), board.second.begin(), board.second.end());
+  }
+}
+
+void onLog(const char* line) {
+  fprintf(stderr, "%s\n", line);
+}
+
+void onSequenceComplete(uint32_t sequenceId) {
+  // 与 main.cpp 的 handleSequenceComplete 相同：表演按序列完成推进下一轮
+  performance::controller().onSequenceComplete(sequenceId);
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    fprintf(stderr, "cannot open %s\n", path.c_str());
+    return false;
+  }
+  uint8_t buffer[4096];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + count);
+  }
+  fclose(file);
+  return true;
+}
+
+uint32_t fnv1a(const std::vector<uint16_t>& frames) {
+  uint32_t hash = 2166136261u;
+  for (uint16_t value : frames) {
+    hash = (hash ^ (value & 0xFF)) * 16777619u;
+    hash = (hash ^ (value >> 8)) * 16777619u;
+  }
+  return hash;
+}
+
+// 帧文件：magic "NHFR" | words u32（每帧的 u16 个数）| frames u32 | 帧数据（小端 u16）
+bool writeFrames(const std::string& path, const std::vector<uint16_t>& frames, uint32_t words) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    fprintf(stderr, "cannot write %s\n", path.c_str());
+    return false;
+  }
+  const uint32_t count = words ? static_cast<uint32_t>(frames.size() / words) : 0;
+  std::vector<uint8_t> out(kFramesMagic, kFramesMagic + 4);
+  for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(words >> (8 * i)));
+  for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(count >> (8 * i)));
+  for (uint16_t value : frames) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+  }
+  const bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+  fclose(file);
+  return ok;
+}
+
+bool readFrames(const std::string& path, std::vector<uint16_t>& frames, uint32_t& words) {
+  std::vector<uint8_t> data;
+  if (!readFile(path, data)) {
+    return false;
+  }
+  if (data.size() < 12 || memcmp(data.data(), kFramesMagic, 4) != 0) {
+    fprintf(stderr, "%s: not a frames file\n", path.c_str());
+    return false;
+  }
+  words = data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<uint32_t>(data[7]) << 24);
+  for (size_t i = 12; i + 1 < data.size(); i += 2) {
+    frames.push_back(static_cast<uint16_t>(data[i] | (data[i + 1] << 8)));
+  }
+  return true;
+}
+
+int compareFrames(const Options& options) {
+  std::vector<uint16_t> a, b;
+  uint32_t wordsA = 0, wordsB = 0;
+  if (!readFrames(options.compareA, a, wordsA) || !readFrames(options.compareB, b, wordsB)) {
+    return 2;
+  }
+  if (wordsA != wordsB || wordsA == 0) {
+    printf("frame layout differs: %u vs %u values per frame\n", wordsA, wordsB);
+    return 1;
+  }
+  const size_t framesA = a.size() / wordsA;
+  const size_t framesB = b.size() / wordsB;
+  const size_t common = framesA < framesB ? framesA : framesB;
+  size_t differing = 0;
+  size_t first = common;
+  size_t firstWord = 0;
+  for (size_t f = 0; f < common; ++f) {
+    for (size_t w = 0; w < wordsA; ++w) {
+      if (a[f * wordsA + w] != b[f * wordsA + w]) {
+        if (first == common) {
+          first = f;
+          firstWord = w;
+        }
+        ++differing;
+        break;
+      }
+    }
+  }
+  if (differing == 0 && framesA == framesB) {
+    printf("identical: %zu frames, hash %08x\n", framesA, fnv1a(a));
+    return 0;
+  }
+  if (framesA != framesB) {
+    printf("frame count differs: %zu vs %zu\n", framesA, framesB);
+  }
+  if (differing > 0) {
+    const size_t board = firstWord / (kChannels * 2);
+    const size_t channel = (firstWord % (kChannels * 2)) / 2;
+    printf("%zu of %zu frames differ; first at tick %zu, board %zu channel %zu (%s %u vs %u)\n", differing, common,
+           first + 1, board, channel, firstWord % 2 ? "off" : "on", a[first * wordsA + firstWord],
+           b[first * wordsA + firstWord]);
+  }
+  return 1;
+}
+
+// 与 main.cpp 中 WebSocket / 串口通道在解析之后的处理顺序一致（低电量拦截与应答除外）
+void applyJsonCommand(const sessionrec::Command& command, const char* logTag) {
+  std::vector<char> input(command.payload, command.payload + command.length);
+  DynamicJsonDocument doc(4096);
+  const DeserializationError err = command.kind == 1
+      ? deserializeMsgPack(doc, input.data(), input.size())
+      : deserializeJson(doc, input.data(), input.size());
+  if (err) {
+    return;
+  }
+  const cmdkeys::Fields fields(doc.as<JsonObjectConst>());
+  if (fields.has(cmdkeys::Key::Link)) {
+    return;  // 串口链路协商，与运动无关
+  }
+  if (cmddispatch::handleAdvanced(fields).handled) {
+    return;
+  }
+  if (fields.has(cmdkeys::Key::MovementMode)) {
+    int16_t movementMode = fields[cmdkeys::Key::MovementMode];
+    cmddispatch::applyMovementMode(movementMode, logTag);
+  }
+  if (fields.has(cmdkeys::Key::Speed)) {
+    float speed = fields[cmdkeys::Key::Speed];
+    hexapod::Robot->setMovementSpeed(speed);
+  }
+  if (fields.has(cmdkeys::Key::SpeedLevel)) {
+    int level = fields[cmdkeys::Key::SpeedLevel];
+    if (level >= hexapod::SPEED_SLOWEST && level <= hexapod::SPEED_FAST) {
+      hexapod::Robot->setMovementSpeedLevel(static_cast<hexapod::SpeedLevel>(level));
+    }
+  }
+  if (fields.has(cmdkeys::Key::GaitMode)) {
+    int gaitMode = fields[cmdkeys::Key::GaitMode];
+    hexapod::Robot->setGaitMode(gaitMode);
+  }
+}
+
+// 与 main.cpp 的 handleSerialPacket 一致
+void applySerialPacket(const sessionrec::Command& command) {
+  const seriallink::MessageId id = static_cast<seriallink::MessageId>(command.kind);
+  if (id == seriallink::MessageId::Stop) {
+    cmddispatch::stopAll("[SerialLink] stop");
+    return;
+  }
+  if (id != seriallink::MessageId::SetMovement || (command.length != 2 && command.length != 6)) {
+    return;
+  }
+  int16_t movementMode;
+  memcpy(&movementMode, command.payload, sizeof(movementMode));
+  const cmddispatch::MovementResult result = cmddispatch::applyMovementMode(movementMode, "UART2");
+  if (result == cmddispatch::MovementResult::Busy || result == cmddispatch::MovementResult::Invalid) {
+    return;
+  }
+  if (command.length == 6) {
+    float speed;
+    memcpy(&speed, command.payload + 2, sizeof(speed));
+    hexapod::Robot->setMovementSpeed(speed);
+  }
+}
+
+void applyCommand(const sessionrec::Command& command) {
+  switch (command.source) {
+    case sessionrec::Source::WebSocket:
+      applyJsonCommand(command, "WebSocket");
+      break;
+    case sessionrec::Source::Serial:
+      applyJsonCommand(command, "UART2");
+      break;
+    case sessionrec::Source::SerialPacket:
+      applySerialPacket(command);
+      break;
+  }
+}
+
+// 回放中各模式对的切换延迟（与设备 GET /api/transitions 相同的统计）
+void printTransitions() {
+  for (auto from = hexapod::MOVEMENT_STANDBY; from < hexapod::MOVEMENT_TOTAL; from++) {
+    for (auto to = hexapod::MOVEMENT_STANDBY; to < hexapod::MOVEMENT_TOTAL; to++) {
+      transition::PairStats stats;
+      if (!transition::pairStats(from, to, stats)) {
+        continue;
+      }
+      printf("  %-11s -> %-11s count %u, interrupted %u, min %u ms, avg %u ms, max %u ms\n",
+             cmdkeys::movementModeName(from), cmdkeys::movementModeName(to), stats.count, stats.interrupted,
+             stats.minMs, stats.count > 0 ? stats.totalMs / stats.count : 0, stats.maxMs);
+    }
+  }
+}
+
+int replaySession(const Options& options) {
+  std::vector<uint8_t> data;
+  if (!readFile(options.sessionPath, data)) {
+    return 2;
+  }
+  sessionrec::Reader reader;
+  String error;
+  if (!reader.open(data.data(), data.size(), error)) {
+    fprintf(stderr, "%s: %s\n", options.sessionPath.c_str(), error.c_str());
+    return 2;
+  }
+  const sessionrec::Header& header = reader.header();
+  if (header.flags & sessionrec::kFlagOverflow) {
+    fprintf(stderr, "warning: %u commands were dropped on the device, replay diverges after the buffer filled\n",
+            header.droppedCommands);
+  }
+  const int tickMs = header.tickMs ? header.tickMs : hexapod::config::movementInterval;
+
+  Adafruit_PWMServoDriver::writeHook() = onPwmWrite;
+  hexapod::HexapodClass hexapodRobot;
+  quadruped::QuadRobot quadRobot;
+  const bool quad = header.model == sessionrec::Model::Quad;
+  hexapod::Robot = quad ? static_cast<hexapod::RobotBase*>(&quadRobot) : static_cast<hexapod::RobotBase*>(&hexapodRobot);
+
+  // 与 main.cpp 的 setup() 相同的初始化顺序，再恢复录制开始时的状态
+  hexapod::Robot->init(false);
+  motion::controller().begin();
+  performance::controller().begin();
+  singleleg::controller().begin();
+  motion::controller().setSequenceCallback(onSequenceComplete);
+  cmddispatch::begin();
+  hexapod::Robot->setGaitMode(header.gaitMode);
+  hexapod::Robot->setMovementSpeed(header.speed);
+  if (header.flags & sessionrec::kFlagAutoGait) {
+    // 自动步态的回差以当前步态为起点：先恢复步态与速度再打开，与设备上的选择一致
+    hexapod::Robot->setGaitMode(hexapod::RobotBase::kAutoGaitMode);
+  }
+  rng::seedAll(header.seed);
+
+  // 设备在第 k 个控制周期开始后收到的指令（tick=k）最早在第 k+1 个周期生效
+  std::vector<uint16_t> frames;
+  sessionrec::Command command;
+  bool hasCommand = reader.next(command);
+  uint32_t applied = 0;
+  const uint32_t totalTicks = header.endTick + static_cast<uint32_t>(options.tailTicks);
+  for (uint32_t tick = 1; tick <= totalTicks; ++tick) {
+    while (hasCommand && command.tick < tick) {
+      applyCommand(command);
+      ++applied;
+      hasCommand = reader.next(command);
+    }
+    cmddispatch::runTick(tickMs);
+    hostsim::advanceMillis(tickMs);
+    captureFrame(frames);
+  }
+
+  const uint32_t words = static_cast<uint32_t>(boards.size() * kChannels * 2);
+  printf("model %s, seed %u, speed %.2f, gait %u%s\n", quad ? "quad" : "hexapod", header.seed, header.speed,
+         header.gaitMode, (header.flags & sessionrec::kFlagAutoGait) ? " (auto)" : "");
+  printf("%u commands over %u ticks (+%d tail), %zu boards, hash %08x\n", applied, header.endTick,
+         options.tailTicks, boards.size(), fnv1a(frames));
+  printTransitions();
+  if (!options.framesPath.empty() && !writeFrames(options.framesPath, frames, words)) {
+    return 2;
+  }
+  return 0;
+}
+
+void usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s SESSION [--frames FILE] [--tail-ticks N] [--verbose]\n"
+          "       %s --compare A.frames B.frames\n"
+          "  --frames FILE     输出逐周期舵机帧，供 --compare 比较\n"
+          "  --tail-ticks N    会话结束后继续运行的控制周期数（默认 %d）\n"
+          "  --verbose         固件日志输出到 stderr\n",
+          program, program, kDefaultTailTicks);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--frames" && hasValue) {
+      options.framesPath = argv[++i];
+    } else if (arg == "--tail-ticks" && hasValue) {
+      options.tailTicks = atoi(argv[++i]);
+      if (options.tailTicks < 0) {
+        return false;
+      }
+    } else if (arg == "--compare" && i + 2 < argc) {
+      options.compareA = argv[++i];
+      options.compareB = argv[++i];
+    } else if (arg == "--verbose") {
+      options.verbose = true;
+    } else if (arg[0] != '-' && options.sessionPath.empty()) {
+      options.sessionPath = arg;
+    } else {
+      return false;
+    }
+  }
+  return options.compareA.empty() != options.sessionPath.empty();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (!options.compareA.empty()) {
+    return compareFrames(options);
+  }
+  hostsim::setSerialEcho(options.verbose);
+  hexapod::initLogOutput(options.verbose ? onLog : [](const char*) {}, nullptr);
+  return replaySession(options);
+}
@@ -0,0 +1,78 @@
+// 电池电压采样（ADC1 + eFuse 校准）
+
+#include "battery_adc.h"
+
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+
+namespace batteryadc {
+
+namespace {
+
+static constexpr uint32_t kDefaultVrefMv = 1100;
+static constexpr adc_atten_t kAtten = ADC_ATTEN_DB_11;
+static constexpr adc_bits_width_t kWidth = ADC_WIDTH_BIT_12;
+
+esp_adc_cal_characteristics_t characteristics;
+adc1_channel_t channel = ADC1_CHANNEL_0;
+CalibrationSource source = CalibrationSource::None;
+
+}  // namespace
+
+bool begin(uint8_t pin) {
+  // ADC2 与 WiFi 冲突，电池采样只支持 ADC1（GPIO32~39）
+  const int8_t analogChannel = digitalPinToAnalogChannel(pin);
+  if (analogChannel < 0 || analogChannel >= ADC1_CHANNEL_MAX) {
+    source = CalibrationSource::None;
+    return false;
+  }
+  channel = static_cast<adc1_channel_t>(analogChannel);
+  adc1_config_width(kWidth);
+  adc1_config_channel_atten(channel, kAtten);
+
+  const esp_adc_cal_value_t value = esp_adc_cal_characterize(ADC_UNIT_1, kAtten, kWidth, kDefaultVrefMv, &characteristics);
+  if (value == ESP_ADC_CAL_VAL_EFUSE_TP) {
+    source = CalibrationSource::EfuseTwoPoint;
+  } else if (value == ESP_ADC_CAL_VAL_EFUSE_VREF) {
+    source = CalibrationSource::EfuseVref;
+  } else {
+    source = CalibrationSource::DefaultVref;
+  }
+  return true;
+}
+
+uint32_t readPinMv(uint8_t samples) {
+  if (source == CalibrationSource::None) {
+    return 0;
+  }
+  if (samples < 3) {
+    samples = 3;
+  }
+  uint32_t sum = 0;
+  int minRaw = 4095;
+  int maxRaw = 0;
+  for (uint8_t i = 0; i < samples; ++i) {
+    const int raw = adc1_get_raw(channel);
+    sum += raw;
+    if (raw < minRaw) minRaw = raw;
+    if (raw > maxRaw) maxRaw = raw;
+  }
+  sum -= minRaw + maxRaw;
+  const uint32_t average = (sum + (samples - 2) / 2) / (samples - 2);
+  return esp_adc_cal_raw_to_voltage(average, &characteristics);
+}
+
+CalibrationSource calibrationSource() {
+  return source;
+}
+
+const char* calibrationSourceName() {
+  switch (source) {
+    case CalibrationSource::EfuseTwoPoint: return "efuse_tp";
+    case CalibrationSource::EfuseVref: return "efuse_vref";
+    case CalibrationSource::DefaultVref: return "default";
+    default: return "none";
+  }
+}
+
+}  // namespace batteryadc
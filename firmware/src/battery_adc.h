@@ -0,0 +1,27 @@
+// 电池电压采样（ADC1 + eFuse 校准）
+// - 使用 esp_adc_cal 按芯片 eFuse 中的 Two Point / Vref 校准值把原始读数换算为毫伏，
+//   代替 analogRead() * 3.3 / 4095 的线性假设（ESP32 ADC 在 11dB 衰减下非线性明显）
+// - 每次读取连续过采样，去掉最大/最小值后取平均，抑制舵机 PWM 与电源纹波带来的毛刺
+#pragma once
+
+#include <Arduino.h>
+
+namespace batteryadc {
+
+enum class CalibrationSource : uint8_t {
+  None = 0,
+  DefaultVref,  // eFuse 无校准值，使用默认 1100mV
+  EfuseVref,
+  EfuseTwoPoint,
+};
+
+// 配置引脚所在的 ADC1 通道（12 位、11dB 衰减）并读取校准参数；引脚不属于 ADC1 时返回 false
+bool begin(uint8_t pin);
+
+// 过采样读取引脚电压（mV），samples 至少为 3
+uint32_t readPinMv(uint8_t samples);
+
+CalibrationSource calibrationSource();
+const char* calibrationSourceName();
+
+}  // namespace batteryadc
@@ -0,0 +1,119 @@
+// 电池状态估计
+
+#include "battery_estimator.h"
+
+#include <cmath>
+
+namespace battery {
+
+namespace {
+
+struct SocPoint {
+  float cellVoltage;
+  float percent;
+};
+
+// 锂电池（LiPo / 18650）单节静置开路电压曲线
+const SocPoint kSocCurve[] = {
+  {3.00f, 0.0f},  {3.45f, 5.0f},  {3.68f, 10.0f}, {3.74f, 20.0f},
+  {3.77f, 30.0f}, {3.79f, 40.0f}, {3.82f, 50.0f}, {3.87f, 60.0f},
+  {3.92f, 70.0f}, {3.98f, 80.0f}, {4.06f, 90.0f}, {4.20f, 100.0f},
+};
+const size_t kSocPoints = sizeof(kSocCurve) / sizeof(kSocCurve[0]);
+
+const float kVoltageFilterAlpha = 0.3f;
+const float kAverageCurrentTauSec = 60.0f;
+const float kMaxStepSec = 5.0f;  // 任务被长时间阻塞后不按整段时间积分
+
+float clampf(float value, float low, float high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+uint16_t toMillivolts(float volts) {
+  return volts <= 0.0f ? 0 : static_cast<uint16_t>(volts * 1000.0f + 0.5f);
+}
+
+}  // namespace
+
+Estimator::Estimator(const Config& config) : config_(config) {
+  reset();
+}
+
+void Estimator::reset() {
+  state_ = State();
+  state_.resistanceOhm = config_.initialResistanceOhm;
+}
+
+float Estimator::socFromCellVoltage(float cellVoltage) {
+  if (cellVoltage <= kSocCurve[0].cellVoltage) {
+    return 0.0f;
+  }
+  for (size_t i = 1; i < kSocPoints; ++i) {
+    if (cellVoltage <= kSocCurve[i].cellVoltage) {
+      const SocPoint& a = kSocCurve[i - 1];
+      const SocPoint& b = kSocCurve[i];
+      return a.percent + (cellVoltage - a.cellVoltage) * (b.percent - a.percent) / (b.cellVoltage - a.cellVoltage);
+    }
+  }
+  return 100.0f;
+}
+
+const State& Estimator::update(float loadedVoltage, float loadCurrentA, float dtSeconds) {
+  const float cells = config_.cellCount > 0 ? config_.cellCount : 1;
+  const float dt = clampf(dtSeconds, 0.0f, kMaxStepSec);
+
+  if (!state_.valid) {
+    filteredLoaded_ = loadedVoltage;
+    filteredOpenCircuit_ = loadedVoltage + loadCurrentA * state_.resistanceOhm;
+    state_.averageCurrentA = loadCurrentA;
+    state_.socPercent = socFromCellVoltage(filteredOpenCircuit_ / cells);
+    state_.valid = true;
+  } else {
+    // 内阻：负载阶跃前后的电压差（使用未滤波的测量值）
+    const float deltaCurrent = loadCurrentA - lastCurrent_;
+    if (std::fabs(deltaCurrent) >= config_.resistanceStepA) {
+      const float sample = (lastVoltage_ - loadedVoltage) / deltaCurrent;
+      if (sample >= config_.minResistanceOhm && sample <= config_.maxResistanceOhm) {
+        state_.resistanceOhm += config_.resistanceGain * (sample - state_.resistanceOhm);
+      }
+    }
+
+    // 先补偿再滤波：负载切换时开路电压估计保持连续
+    const float openCircuit = loadedVoltage + loadCurrentA * state_.resistanceOhm;
+    filteredLoaded_ += kVoltageFilterAlpha * (loadedVoltage - filteredLoaded_);
+    filteredOpenCircuit_ += kVoltageFilterAlpha * (openCircuit - filteredOpenCircuit_);
+
+    // 库仑积分 + 开路电压校正
+    const float capacityAh = config_.capacityAh > 0.0f ? config_.capacityAh : 1.0f;
+    state_.socPercent -= loadCurrentA * dt / 3600.0f / capacityAh * 100.0f;
+    const float socFromVoltage = socFromCellVoltage(filteredOpenCircuit_ / cells);
+    state_.socPercent += config_.socCorrectionGain * (socFromVoltage - state_.socPercent);
+    state_.socPercent = clampf(state_.socPercent, 0.0f, 100.0f);
+
+    state_.averageCurrentA += dt / (kAverageCurrentTauSec + dt) * (loadCurrentA - state_.averageCurrentA);
+  }
+
+  lastVoltage_ = loadedVoltage;
+  lastCurrent_ = loadCurrentA;
+
+  state_.loadedMv = toMillivolts(filteredLoaded_);
+  state_.openCircuitMv = toMillivolts(filteredOpenCircuit_);
+  state_.currentA = loadCurrentA;
+
+  const float usablePercent = state_.socPercent - socFromCellVoltage(config_.floorCellVoltage);
+  if (usablePercent > 0.0f && state_.averageCurrentA > 0.01f) {
+    state_.runtimeSec = static_cast<uint32_t>(usablePercent / 100.0f * config_.capacityAh / state_.averageCurrentA * 3600.0f);
+  } else {
+    state_.runtimeSec = 0;
+  }
+  return state_;
+}
+
+float estimateLoadCurrent(const Config& config, bool moving, float speed) {
+  if (!moving) {
+    return config.idleCurrentA;
+  }
+  return config.idleCurrentA + config.activeCurrentA * clampf(speed, 0.1f, 3.0f);
+}
+
+}  // namespace battery
@@ -0,0 +1,64 @@
+// 电池状态估计（与平台无关，可在主机上直接编译）
+// - 负载电流按运动状态估算（待机保持力矩 + 行走随速度增加），用内阻把带载电压折算为开路电压（IR 压降补偿），
+//   行走时的电压跌落不再被当作电量耗尽
+// - 内阻在线估计：相邻两次采样的负载电流变化足够大时，以 ΔV/ΔI 更新（EMA + 限幅）
+// - SoC：按估算电流做库仑积分，再以开路电压查表结果缓慢校正（互补滤波），不随负载跳变
+// - 续航：高于保护阈值的剩余容量 / 平均电流
+#pragma once
+
+#include <cstdint>
+
+namespace battery {
+
+struct Config {
+  uint8_t cellCount = 2;
+  float capacityAh = 2.2f;
+  float idleCurrentA = 0.6f;       // 舵机保持站立姿态的电流
+  float activeCurrentA = 2.4f;     // 运动（速度倍率 1.0）时相对待机增加的电流
+  float initialResistanceOhm = 0.25f;  // 电池 + 线路内阻初值
+  float minResistanceOhm = 0.03f;
+  float maxResistanceOhm = 1.0f;
+  float resistanceStepA = 0.5f;    // 估计内阻所需的最小电流变化
+  float resistanceGain = 0.2f;
+  float socCorrectionGain = 0.02f;  // 每次采样向开路电压查表 SoC 校正的比例
+  float floorCellVoltage = 3.6f;   // 保护阈值（单节开路电压），续航计算到此为止
+};
+
+struct State {
+  bool valid = false;
+  uint16_t loadedMv = 0;        // 带载端电压（滤波后）
+  uint16_t openCircuitMv = 0;   // IR 补偿后的开路电压（滤波后）
+  float currentA = 0.0f;        // 本次估算的负载电流
+  float averageCurrentA = 0.0f;  // 约 1 分钟时间常数的平均电流
+  float resistanceOhm = 0.0f;
+  float socPercent = 0.0f;
+  uint32_t runtimeSec = 0;      // 以平均电流计，降到保护阈值前的剩余时间
+};
+
+class Estimator {
+public:
+  explicit Estimator(const Config& config);
+
+  void reset();
+  // 输入一次测量：带载电压、估算负载电流、距上次测量的时间
+  const State& update(float loadedVoltage, float loadCurrentA, float dtSeconds);
+
+  const State& state() const { return state_; }
+  const Config& config() const { return config_; }
+
+  // 单节开路电压 -> SoC（0~100，锂电池静置曲线分段线性插值）
+  static float socFromCellVoltage(float cellVoltage);
+
+private:
+  Config config_;
+  State state_;
+  float lastVoltage_ = 0.0f;
+  float lastCurrent_ = 0.0f;
+  float filteredLoaded_ = 0.0f;
+  float filteredOpenCircuit_ = 0.0f;
+};
+
+// 由运动状态估算负载电流：moving 为是否在执行运动/表演/单腿控制，speed 为速度倍率
+float estimateLoadCurrent(const Config& config, bool moving, float speed);
+
+}  // namespace battery
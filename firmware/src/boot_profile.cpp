@@ -0,0 +1,61 @@
+// 启动阶段计时
+
+#include "boot_profile.h"
+
+namespace bootprofile {
+
+namespace {
+
+static constexpr size_t kPhaseCount = static_cast<size_t>(Phase::Count);
+
+static const char* const kPhaseNames[kPhaseCount] = {
+  "serialReady",
+  "storageMounted",
+  "settingsLoaded",
+  "standing",
+  "tasksStarted",
+  "wifiReady",
+  "webReady",
+  "firstWebSocket",
+};
+
+// 0 表示未到达（millis() 在 setup 入口处已大于 0）
+volatile uint32_t phaseMs[kPhaseCount] = {};
+
+}  // namespace
+
+void mark(Phase phase) {
+  const size_t index = static_cast<size_t>(phase);
+  if (index >= kPhaseCount || phaseMs[index] != 0) {
+    return;
+  }
+  const uint32_t now = millis();
+  phaseMs[index] = now ? now : 1;
+}
+
+bool isMarked(Phase phase) {
+  return elapsedMs(phase) != 0;
+}
+
+uint32_t elapsedMs(Phase phase) {
+  const size_t index = static_cast<size_t>(phase);
+  return index < kPhaseCount ? phaseMs[index] : 0;
+}
+
+const char* phaseName(Phase phase) {
+  const size_t index = static_cast<size_t>(phase);
+  return index < kPhaseCount ? kPhaseNames[index] : "unknown";
+}
+
+void printSummary(Print& out) {
+  out.print("[Boot]");
+  for (size_t i = 0; i < kPhaseCount; ++i) {
+    if (phaseMs[i] == 0) {
+      continue;
+    }
+    out.printf(" %s=%ums", kPhaseNames[i], static_cast<unsigned>(phaseMs[i]));
+  }
+  out.println();
+}
+
+}  // namespace bootprofile
@@ -0,0 +1,32 @@
+// 启动阶段计时
+// - 各阶段首次到达时记录距上电的毫秒数（只记录一次），用于评估"上电到站立"与"上电到首个 WebSocket 连接"
+// - 通过串口日志与 /api/diag 的 boot 字段输出
+#pragma once
+
+#include <Arduino.h>
+
+namespace bootprofile {
+
+enum class Phase : uint8_t {
+  SerialReady = 0,    // 串口可用（setup 入口）
+  StorageMounted,     // LittleFS 挂载完成
+  SettingsLoaded,     // NVS 设置读取完成
+  Standing,           // 舵机初始化并输出站立姿态
+  TasksStarted,       // 电池/LED/串口任务已创建
+  WifiReady,          // AP 启动完成（后台任务）
+  WebReady,           // HTTP/WebSocket 服务开始监听（后台任务）
+  FirstWebSocket,     // 第一个 WebSocket 客户端连上
+  Count,
+};
+
+// 记录阶段时间（重复调用只保留第一次）
+void mark(Phase phase);
+bool isMarked(Phase phase);
+// 距上电的毫秒数，未到达时返回 0
+uint32_t elapsedMs(Phase phase);
+const char* phaseName(Phase phase);
+
+// 串口输出全部已记录阶段
+void printSummary(Print& out);
+
+}  // namespace bootprofile
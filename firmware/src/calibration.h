@@ -12,6 +12,8 @@ struct CalibrationData {
     int legIndex;  // 腿的索引
     int partIndex; // 关节的索引
     int offset;    // 偏移量
+    int curvePoint; // 多点校准曲线锚点索引，-1 表示仅调整偏移量
+    int curveValue; // 锚点脉宽修正量（us）
     
     bool modeChanged;
     String operation;
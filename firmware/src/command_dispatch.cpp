@@ -0,0 +1,549 @@
+// 控制指令的执行层
+
+#include "command_dispatch.h"
+
+#include <cstdio>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "motion_controller.h"
+#include "name_hash.h"
+#include "performance_controller.h"
+#include "rng.h"
+#include "robot.h"
+#include "single_leg_controller.h"
+#include "transition_timing.h"
+
+namespace cmddispatch {
+
+namespace {
+
+enum class SingleLegOp : uint8_t { Start, Input, Stop, Unknown };
+
+int16_t flag = 0;  // 运动模式标志：按位对应 hexapod::MovementMode，取最低的置位
+SemaphoreHandle_t flagMutex = nullptr;
+
+bool parseMovementModeField(JsonVariantConst value, hexapod::MovementMode& mode) {
+  if (value.isNull()) {
+    return false;
+  }
+
+  if (value.is<int>()) {
+    int raw = value.as<int>();
+    if (raw >= 0 && raw < hexapod::MOVEMENT_TOTAL) {
+      mode = static_cast<hexapod::MovementMode>(raw);
+      return true;
+    }
+    for (int i = 0; i < hexapod::MOVEMENT_TOTAL; ++i) {
+      if (raw & (1 << i)) {
+        mode = static_cast<hexapod::MovementMode>(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (value.is<const char*>()) {
+    return cmdkeys::lookupMovementMode(value.as<const char*>(), mode);
+  }
+
+  return false;
+}
+
+// 表演名 / 优先级名 / 单腿操作名的完美哈希表（大小写不敏感，见 name_hash.h）
+constexpr namehash::Entry kPerformanceNames[] = {
+  {"freestyle", static_cast<uint8_t>(performance::Kind::Freestyle)},
+  {"beatsway", static_cast<uint8_t>(performance::Kind::BeatSway)},
+  {"beat_sway", static_cast<uint8_t>(performance::Kind::BeatSway)},
+  {"showtime", static_cast<uint8_t>(performance::Kind::Showtime)},
+};
+constexpr uint8_t kPerformanceBits = 3;
+constexpr uint32_t kPerformanceSeed = 3;
+constexpr namehash::SlotTable<(1u << kPerformanceBits)> kPerformanceSlots = namehash::buildSlots(
+    kPerformanceNames, kPerformanceSeed, kPerformanceBits, namehash::MakeIndices<(1u << kPerformanceBits)>::type());
+static_assert(namehash::isPerfect(kPerformanceNames, kPerformanceSeed, kPerformanceBits), "performance name collision");
+
+constexpr namehash::Entry kPriorityNames[] = {
+  {"safety", static_cast<uint8_t>(motion::Priority::Safety)},
+  {"user", static_cast<uint8_t>(motion::Priority::User)},
+  {"performance", static_cast<uint8_t>(motion::Priority::Performance)},
+};
+constexpr uint8_t kPriorityBits = 2;
+constexpr uint32_t kPrioritySeed = 5;
+constexpr namehash::SlotTable<(1u << kPriorityBits)> kPrioritySlots = namehash::buildSlots(
+    kPriorityNames, kPrioritySeed, kPriorityBits, namehash::MakeIndices<(1u << kPriorityBits)>::type());
+static_assert(namehash::isPerfect(kPriorityNames, kPrioritySeed, kPriorityBits), "priority name collision");
+
+constexpr namehash::Entry kSingleLegOpNames[] = {
+  {"start", static_cast<uint8_t>(SingleLegOp::Start)},
+  {"input", static_cast<uint8_t>(SingleLegOp::Input)},
+  {"stop", static_cast<uint8_t>(SingleLegOp::Stop)},
+};
+constexpr uint8_t kSingleLegOpBits = 2;
+constexpr uint32_t kSingleLegOpSeed = 3;
+constexpr namehash::SlotTable<(1u << kSingleLegOpBits)> kSingleLegOpSlots = namehash::buildSlots(
+    kSingleLegOpNames, kSingleLegOpSeed, kSingleLegOpBits, namehash::MakeIndices<(1u << kSingleLegOpBits)>::type());
+static_assert(namehash::isPerfect(kSingleLegOpNames, kSingleLegOpSeed, kSingleLegOpBits), "singleLeg op collision");
+
+bool parsePerformanceKindField(JsonVariantConst value, performance::Kind& kind) {
+  if (value.isNull() || !value.is<const char*>()) {
+    return false;
+  }
+
+  const int8_t index = namehash::lookup(kPerformanceNames, kPerformanceSlots, kPerformanceSeed, kPerformanceBits,
+                                        value.as<const char*>(), true);
+  if (index < 0) {
+    return false;
+  }
+  kind = static_cast<performance::Kind>(kPerformanceNames[index].value);
+  return true;
+}
+
+bool parsePriorityField(JsonVariantConst value, motion::Priority& priority) {
+  if (value.isNull()) {
+    priority = motion::Priority::User;
+    return true;
+  }
+  if (!value.is<const char*>()) {
+    return false;
+  }
+
+  const int8_t index = namehash::lookup(kPriorityNames, kPrioritySlots, kPrioritySeed, kPriorityBits,
+                                        value.as<const char*>(), true);
+  if (index < 0) {
+    return false;
+  }
+  priority = static_cast<motion::Priority>(kPriorityNames[index].value);
+  return true;
+}
+
+SingleLegOp parseSingleLegOp(const char* name) {
+  const int8_t index = namehash::lookup(kSingleLegOpNames, kSingleLegOpSlots, kSingleLegOpSeed, kSingleLegOpBits,
+                                        name, true);
+  return index < 0 ? SingleLegOp::Unknown : static_cast<SingleLegOp>(kSingleLegOpNames[index].value);
+}
+
+// 覆盖式指令只清空同级及更低优先级的通道，已排队的安全动作不受用户指令影响
+void clearMotionLanesFrom(motion::Priority priority, const char* reason) {
+  for (size_t lane = static_cast<size_t>(priority); lane < motion::kPriorityCount; ++lane) {
+    motion::controller().clearLane(static_cast<motion::Priority>(lane), reason);
+    reason = nullptr;
+  }
+}
+
+bool buildActionFromFields(const cmdkeys::Fields& fields, motion::Action& action, String& error) {
+  JsonVariantConst modeField = fields[cmdkeys::Key::MovementMode];
+  if (modeField.isNull()) {
+    modeField = fields[cmdkeys::Key::Mode];
+  }
+  if (!parseMovementModeField(modeField, action.mode)) {
+    error = "movementMode missing or invalid";
+    return false;
+  }
+
+  if (fields.has(cmdkeys::Key::SpeedOverride)) {
+    action.speed = fields[cmdkeys::Key::SpeedOverride].as<float>();
+  }
+
+  if (fields.has(cmdkeys::Key::DurationMs)) {
+    error = "durationMs is not supported (use cycles/steps/distance/angle)";
+    return false;
+  }
+
+  if (fields.has(cmdkeys::Key::Cycles)) {
+    action.unit = motion::Unit::Cycles;
+    action.value = fields[cmdkeys::Key::Cycles].as<float>();
+  } else if (fields.has(cmdkeys::Key::Steps)) {
+    action.unit = motion::Unit::Steps;
+    action.value = fields[cmdkeys::Key::Steps].as<float>();
+  } else if (fields.has(cmdkeys::Key::Distance)) {
+    action.unit = motion::Unit::Distance;
+    action.value = fields[cmdkeys::Key::Distance].as<float>();
+  } else if (fields.has(cmdkeys::Key::Angle)) {
+    action.unit = motion::Unit::Angle;
+    action.value = fields[cmdkeys::Key::Angle].as<float>();
+  } else {
+    error = "missing cycles/steps/distance/angle";
+    return false;
+  }
+
+  if (action.value <= 0.0f) {
+    error = "value must be positive";
+    return false;
+  }
+  return true;
+}
+
+bool hasActionParameters(const cmdkeys::Fields& fields) {
+  return fields.has(cmdkeys::Key::Cycles)
+      || fields.has(cmdkeys::Key::Steps)
+      || fields.has(cmdkeys::Key::Distance)
+      || fields.has(cmdkeys::Key::Angle);
+}
+
+}  // namespace
+
+void begin() {
+  if (!flagMutex) {
+    flagMutex = xSemaphoreCreateMutex();
+  }
+  transition::begin();
+}
+
+AdvancedResult handleAdvanced(const cmdkeys::Fields& fields) {
+  AdvancedResult result;
+
+  if (fields.has(cmdkeys::Key::Stop) && fields[cmdkeys::Key::Stop].as<bool>()) {
+    result.handled = true;
+    motion::controller().clear("[Motion] stop command");
+    performance::controller().clear("[Motion] stop command");
+    singleleg::controller().stop("[SingleLeg] stop command");
+    clearMovementFlag();
+    result.success = true;
+    result.message = "Motion stopped";
+    return result;
+  }
+
+  if (fields.has(cmdkeys::Key::ClearQueue) && fields[cmdkeys::Key::ClearQueue].as<bool>()) {
+    result.handled = true;
+    motion::controller().clear("[Motion] queue cleared");
+    performance::controller().clear("[Motion] queue cleared");
+    singleleg::controller().stop("[SingleLeg] queue cleared");
+    result.success = true;
+    result.message = "Queue cleared";
+    return result;
+  }
+
+  // {"seed": n}：重设所有子系统的随机数（入场帧选择、表演编排），之后的随机选择可复现
+  if (fields.has(cmdkeys::Key::Seed)) {
+    result.handled = true;
+    if (!fields[cmdkeys::Key::Seed].is<uint32_t>()) {
+      result.success = false;
+      result.message = "seed must be an unsigned integer";
+      return result;
+    }
+    rng::seedAll(fields[cmdkeys::Key::Seed].as<uint32_t>());
+    result.success = true;
+    result.message = "random seed set";
+    return result;
+  }
+
+  if (fields.has(cmdkeys::Key::CancelSequence)) {
+    result.handled = true;
+    const uint32_t cancelId = fields[cmdkeys::Key::CancelSequence] | 0U;
+    if (cancelId == 0 || !motion::controller().cancelSequence(cancelId, "[Motion] sequence cancelled")) {
+      result.success = false;
+      result.message = "sequence not found";
+      return result;
+    }
+    result.success = true;
+    result.sequenceId = cancelId;
+    result.message = "sequence cancelled";
+    return result;
+  }
+
+  if (fields.has(cmdkeys::Key::SingleLeg)) {
+    result.handled = true;
+
+    JsonObjectConst singleLeg = fields[cmdkeys::Key::SingleLeg].as<JsonObjectConst>();
+    if (singleLeg.isNull()) {
+      result.success = false;
+      result.message = "singleLeg must be an object";
+      return result;
+    }
+
+    const SingleLegOp op = parseSingleLegOp(singleLeg["op"] | "");
+
+    if (op == SingleLegOp::Start) {
+      const int legIndex = singleLeg["legIndex"] | -1;
+      if (legIndex < 0 || legIndex >= 6) {
+        result.success = false;
+        result.message = "invalid leg index";
+        return result;
+      }
+
+      motion::controller().clear("[SingleLeg] start override");
+      performance::controller().clear("[SingleLeg] start override");
+      clearMovementFlag();
+      singleleg::controller().stop("[SingleLeg] restart");
+
+      String error;
+      if (!singleleg::controller().start(static_cast<uint8_t>(legIndex), error)) {
+        result.success = false;
+        result.message = error;
+        return result;
+      }
+
+      result.success = true;
+      result.message = "single leg control started";
+      return result;
+    }
+
+    if (op == SingleLegOp::Input) {
+      if (!singleleg::controller().isActive()) {
+        result.success = false;
+        result.message = "single leg control not active";
+        return result;
+      }
+
+      singleleg::InputAxes axes;
+      axes.lx = singleLeg["lx"] | 0.0f;
+      axes.ly = singleLeg["ly"] | 0.0f;
+      axes.rz = singleLeg["rz"] | 0.0f;
+      singleleg::controller().updateInput(axes);
+
+      result.success = true;
+      result.suppressAck = true;
+      result.message = "single leg input accepted";
+      return result;
+    }
+
+    if (op == SingleLegOp::Stop) {
+      singleleg::controller().stop("[SingleLeg] stop command");
+      result.success = true;
+      result.message = "single leg control stopped";
+      return result;
+    }
+
+    result.success = false;
+    result.message = "unsupported singleLeg operation";
+    return result;
+  }
+
+  if (fields.has(cmdkeys::Key::Performance)) {
+    result.handled = true;
+    if (singleleg::controller().isActive()) {
+      singleleg::controller().stop("[SingleLeg] overridden by performance");
+    }
+    performance::Kind kind;
+    if (!parsePerformanceKindField(fields[cmdkeys::Key::Performance], kind)) {
+      result.success = false;
+      result.message = "unsupported performance";
+      return result;
+    }
+
+    const bool repeat = fields[cmdkeys::Key::Repeat] | false;
+    const uint32_t requestedSequenceId = fields[cmdkeys::Key::SequenceId] | 0U;
+    String error;
+    uint32_t acceptedSequenceId = 0;
+    if (!performance::controller().start(kind, repeat, requestedSequenceId, error, acceptedSequenceId)) {
+      result.success = false;
+      result.message = error;
+      return result;
+    }
+
+    clearMovementFlag();
+    result.success = true;
+    result.sequenceId = acceptedSequenceId;
+    result.message = "performance accepted";
+    return result;
+  }
+
+  if (fields.has(cmdkeys::Key::Sequence)) {
+    result.handled = true;
+    if (singleleg::controller().isActive()) {
+      singleleg::controller().stop("[SingleLeg] overridden by sequence");
+    }
+    performance::controller().clear("[Performance] overridden by sequence");
+    motion::controller().clearLane(motion::Priority::Performance);
+    JsonArrayConst seq = fields[cmdkeys::Key::Sequence].as<JsonArrayConst>();
+    if (seq.isNull() || seq.size() == 0 || seq.size() > motion::kMaxSequenceLength) {
+      char buffer[48];
+      snprintf(buffer, sizeof(buffer), "sequence size must be 1-%u",
+               static_cast<unsigned>(motion::kMaxSequenceLength));
+      result.success = false;
+      result.message = buffer;
+      return result;
+    }
+
+    motion::Priority priority;
+    if (!parsePriorityField(fields[cmdkeys::Key::Priority], priority)) {
+      result.success = false;
+      result.message = "unsupported priority";
+      return result;
+    }
+
+    bool append = fields[cmdkeys::Key::Append] | false;
+    uint32_t seqId = fields[cmdkeys::Key::SequenceId] | (uint32_t)millis();
+    if (seqId == 0) {
+      seqId = 1;
+    }
+    motion::Action actions[motion::kMaxSequenceLength];
+    for (size_t i = 0; i < seq.size(); ++i) {
+      String err;
+      const cmdkeys::Fields actionFields(seq[i].as<JsonObjectConst>());
+      if (!buildActionFromFields(actionFields, actions[i], err)) {
+        result.success = false;
+        result.message = err;
+        return result;
+      }
+      actions[i].sequenceId = seqId;
+      actions[i].sequenceTail = (i == seq.size() - 1);
+      actions[i].priority = priority;
+    }
+
+    if (!append) {
+      clearMotionLanesFrom(priority, "[Motion] sequence override");
+    }
+
+    if (!motion::controller().enqueueSequence(actions, seq.size())) {
+      result.success = false;
+      result.message = "queue full";
+      return result;
+    }
+
+    clearMovementFlag();
+    result.success = true;
+    result.sequenceId = seqId;
+    result.message = "sequence accepted";
+    return result;
+  }
+
+  if (hasActionParameters(fields)) {
+    result.handled = true;
+    if (singleleg::controller().isActive()) {
+      singleleg::controller().stop("[SingleLeg] overridden by single action");
+    }
+    performance::controller().clear("[Performance] overridden by single action");
+    motion::controller().clearLane(motion::Priority::Performance);
+    motion::Action action;
+    String error;
+    if (!buildActionFromFields(fields, action, error)) {
+      result.success = false;
+      result.message = error;
+      return result;
+    }
+    if (!parsePriorityField(fields[cmdkeys::Key::Priority], action.priority)) {
+      result.success = false;
+      result.message = "unsupported priority";
+      return result;
+    }
+
+    if (fields.has(cmdkeys::Key::SequenceId)) {
+      action.sequenceId = fields[cmdkeys::Key::SequenceId].as<uint32_t>();
+      action.sequenceTail = true;
+    }
+
+    bool append = fields[cmdkeys::Key::Append] | false;
+    if (!append) {
+      clearMotionLanesFrom(action.priority, "[Motion] single action override");
+    }
+
+    if (!motion::controller().enqueue(action)) {
+      result.success = false;
+      result.message = "queue full";
+      return result;
+    }
+
+    clearMovementFlag();
+    result.success = true;
+    result.sequenceId = action.sequenceId;
+    result.message = "action accepted";
+    return result;
+  }
+
+  return result;
+}
+
+MovementResult applyMovementMode(int16_t movementMode, const char* logTag) {
+  if (singleleg::controller().isActive()) {
+    singleleg::controller().stop("[SingleLeg] overridden by movementMode");
+  }
+  if (performance::controller().isActive()) {
+    motion::controller().clear("[Performance] overridden by movementMode");
+    performance::controller().clear("[Performance] overridden by movementMode");
+  }
+
+  if (movementMode < 0) {
+    return MovementResult::Invalid;
+  }
+
+  // 使用短超时时间获取锁，避免长时间等待
+  if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+    return MovementResult::Busy;
+  }
+  const bool changed = flag != movementMode;
+  if (changed) {
+    flag = movementMode;
+    Serial.printf("%s: Receive Movement Command Flag: %d\n", logTag, movementMode);
+  }
+  xSemaphoreGive(flagMutex);
+  return changed ? MovementResult::Changed : MovementResult::Unchanged;
+}
+
+void stopAll(const char* reason) {
+  motion::controller().clear(reason);
+  performance::controller().clear(reason);
+  singleleg::controller().stop(reason);
+  clearMovementFlag();
+}
+
+void clearMovementFlag() {
+  if (xSemaphoreTake(flagMutex, portMAX_DELAY) == pdTRUE) {
+    flag = 0;
+    xSemaphoreGive(flagMutex);
+  }
+}
+
+bool tryClearMovementFlag(uint32_t timeoutMs) {
+  if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+    return false;
+  }
+  flag = 0;
+  xSemaphoreGive(flagMutex);
+  return true;
+}
+
+int16_t movementFlag() {
+  return flag;
+}
+
+bool hasMotionFlag(uint32_t timeoutMs) {
+  bool moving = false;
+  if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE) {
+    for (auto m = hexapod::MOVEMENT_FORWARD; m < hexapod::MOVEMENT_TOTAL; m++) {
+      if (flag & (1 << m)) {
+        moving = true;
+        break;
+      }
+    }
+    xSemaphoreGive(flagMutex);
+  }
+  return moving;
+}
+
+bool runTick(int elapsedMs) {
+  if (singleleg::controller().isActive()) {
+    singleleg::controller().onLoopTick(elapsedMs);
+    return false;
+  }
+
+  auto mode = hexapod::MOVEMENT_STANDBY;
+  if (motion::controller().hasActiveAction()) {
+    mode = motion::controller().activeMode();
+  } else if (xSemaphoreTake(flagMutex, portMAX_DELAY) == pdTRUE) {
+    for (auto m = hexapod::MOVEMENT_STANDBY; m < hexapod::MOVEMENT_TOTAL; m++) {
+      if (flag & (1 << m)) {
+        mode = m;
+        break;
+      }
+    }
+    xSemaphoreGive(flagMutex);
+  }
+
+  if (hexapod::Robot) {
+    hexapod::Robot->processMovement(mode, elapsedMs);
+    // 每个模式对从请求到过渡结束的延迟
+    transition::onTick(mode, hexapod::Robot->isTransitioning(), elapsedMs, hexapod::Robot->getGaitMode());
+  }
+  // 对四足：动作切换存在“等待 entry/对齐”的过渡期，此时实际执行 mode 可能不同。
+  // 为保证序列单位(cycles)的计时准确，应以“实际执行的 mode”来累计 completedCycles；
+  // 时间也按步态实际推进的时间累计（功率调节/稳定裕度可能放慢或停顿步态）。
+  const auto executedMode = hexapod::Robot ? hexapod::Robot->executedMovementMode(mode) : mode;
+  const int advancedMs = hexapod::Robot ? hexapod::Robot->lastMovementAdvanceMs(elapsedMs) : elapsedMs;
+  motion::controller().onLoopTick(executedMode, advancedMs);
+  return hexapod::Robot != nullptr;
+}
+
+}  // namespace cmddispatch
@@ -0,0 +1,61 @@
+// 控制指令的执行层（WebSocket、UART2 文本链路与二进制链路共用）
+// - 把解析好的指令字段作用到 motion / performance / singleleg 控制器与运动标志；
+//   解析、低电量拦截与应答的格式/发送留在各通道（main.cpp）
+// - 运动标志（按位的 movementMode）与每个控制周期的模式选择也在这里：固件主循环与主机回放
+//   （sim/replay.cpp）执行同一套代码，录制的会话（session_recorder.h）可以逐周期复现
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+
+#include "command_keys.h"
+
+namespace cmddispatch {
+
+// 应答消息（定长，避免每条指令构造 String）
+struct AckMessage {
+  char text[64] = "";
+
+  AckMessage& operator=(const char* value) {
+    strlcpy(text, value ? value : "", sizeof(text));
+    return *this;
+  }
+  AckMessage& operator=(const String& value) { return *this = value.c_str(); }
+  const char* c_str() const { return text; }
+};
+
+struct AdvancedResult {
+  bool handled = false;
+  bool success = false;
+  bool suppressAck = false;
+  uint32_t sequenceId = 0;
+  AckMessage message;
+};
+
+enum class MovementResult : uint8_t { Changed, Unchanged, Busy, Invalid };
+
+void begin();
+
+// stop / clearQueue / seed / cancelSequence / singleLeg / performance / sequence / 单个动作；
+// handled=false 表示不是这几类指令，由调用方继续处理 movementMode / speed 等字段
+AdvancedResult handleAdvanced(const cmdkeys::Fields& fields);
+
+// 设置运动标志（会先中止单腿控制与表演）；logTag 为日志前缀，如 "UART2"
+MovementResult applyMovementMode(int16_t movementMode, const char* logTag);
+
+// 清空所有动作队列、表演与单腿控制，运动标志归零
+void stopAll(const char* reason);
+
+void clearMovementFlag();
+// 短超时清零（WebSocket 断开等回调中使用），拿不到锁时返回 false
+bool tryClearMovementFlag(uint32_t timeoutMs);
+// 当前运动标志（不加锁的快照，遥测用）
+int16_t movementFlag();
+// 运动标志中是否有待机以外的运动位（拿不到锁时视为没有）
+bool hasMotionFlag(uint32_t timeoutMs);
+
+// 一个控制周期：单腿控制、动作队列或运动标志 -> 机器人（记录切换延迟，见 transition_timing.h）-> 动作计时；
+// 返回本周期是否推进了步态（单腿控制或机器人未创建时为 false）
+bool runTick(int elapsedMs);
+
+}  // namespace cmddispatch
@@ -0,0 +1,116 @@
+// JSON 控制协议的单遍字段分发
+
+#include "command_keys.h"
+
+#include "name_hash.h"
+
+namespace cmdkeys {
+
+namespace {
+
+// 表内顺序与 Key 枚举一致（value 即枚举值）
+constexpr namehash::Entry kKeyNames[] = {
+  {"stop", static_cast<uint8_t>(Key::Stop)},
+  {"clearQueue", static_cast<uint8_t>(Key::ClearQueue)},
+  {"cancelSequence", static_cast<uint8_t>(Key::CancelSequence)},
+  {"singleLeg", static_cast<uint8_t>(Key::SingleLeg)},
+  {"performance", static_cast<uint8_t>(Key::Performance)},
+  {"repeat", static_cast<uint8_t>(Key::Repeat)},
+  {"sequence", static_cast<uint8_t>(Key::Sequence)},
+  {"sequenceId", static_cast<uint8_t>(Key::SequenceId)},
+  {"priority", static_cast<uint8_t>(Key::Priority)},
+  {"append", static_cast<uint8_t>(Key::Append)},
+  {"movementMode", static_cast<uint8_t>(Key::MovementMode)},
+  {"mode", static_cast<uint8_t>(Key::Mode)},
+  {"speed", static_cast<uint8_t>(Key::Speed)},
+  {"speedLevel", static_cast<uint8_t>(Key::SpeedLevel)},
+  {"gaitMode", static_cast<uint8_t>(Key::GaitMode)},
+  {"speedOverride", static_cast<uint8_t>(Key::SpeedOverride)},
+  {"durationMs", static_cast<uint8_t>(Key::DurationMs)},
+  {"cycles", static_cast<uint8_t>(Key::Cycles)},
+  {"steps", static_cast<uint8_t>(Key::Steps)},
+  {"distance", static_cast<uint8_t>(Key::Distance)},
+  {"angle", static_cast<uint8_t>(Key::Angle)},
+  {"link", static_cast<uint8_t>(Key::Link)},
+  {"baud", static_cast<uint8_t>(Key::Baud)},
+  {"seed", static_cast<uint8_t>(Key::Seed)},
+};
+constexpr uint8_t kKeyBits = 6;
+constexpr uint32_t kKeySeed = 119;
+constexpr namehash::SlotTable<(1u << kKeyBits)> kKeySlots =
+    namehash::buildSlots(kKeyNames, kKeySeed, kKeyBits, namehash::MakeIndices<(1u << kKeyBits)>::type());
+static_assert(sizeof(kKeyNames) / sizeof(kKeyNames[0]) == kKeyCount, "every Key needs a name");
+static_assert(namehash::isPerfect(kKeyNames, kKeySeed, kKeyBits), "key hash collision, pick another kKeySeed");
+
+constexpr namehash::Entry kModeNames[] = {
+  {"standby", hexapod::MOVEMENT_STANDBY},
+  {"forward", hexapod::MOVEMENT_FORWARD},
+  {"forwardfast", hexapod::MOVEMENT_FORWARDFAST},
+  {"forward_fast", hexapod::MOVEMENT_FORWARDFAST},
+  {"backward", hexapod::MOVEMENT_BACKWARD},
+  {"turnleft", hexapod::MOVEMENT_TURNLEFT},
+  {"turn_left", hexapod::MOVEMENT_TURNLEFT},
+  {"turnright", hexapod::MOVEMENT_TURNRIGHT},
+  {"turn_right", hexapod::MOVEMENT_TURNRIGHT},
+  {"shiftleft", hexapod::MOVEMENT_SHIFTLEFT},
+  {"shift_left", hexapod::MOVEMENT_SHIFTLEFT},
+  {"shiftright", hexapod::MOVEMENT_SHIFTRIGHT},
+  {"shift_right", hexapod::MOVEMENT_SHIFTRIGHT},
+  {"climb", hexapod::MOVEMENT_CLIMB},
+  {"rotatex", hexapod::MOVEMENT_ROTATEX},
+  {"rotate_x", hexapod::MOVEMENT_ROTATEX},
+  {"rotatey", hexapod::MOVEMENT_ROTATEY},
+  {"rotate_y", hexapod::MOVEMENT_ROTATEY},
+  {"rotatez", hexapod::MOVEMENT_ROTATEZ},
+  {"rotate_z", hexapod::MOVEMENT_ROTATEZ},
+  {"twist", hexapod::MOVEMENT_TWIST},
+  {"beatsway", hexapod::MOVEMENT_BEATSWAY},
+  {"beat_sway", hexapod::MOVEMENT_BEATSWAY},
+};
+constexpr uint8_t kModeBits = 6;
+constexpr uint32_t kModeSeed = 337;
+constexpr namehash::SlotTable<(1u << kModeBits)> kModeSlots =
+    namehash::buildSlots(kModeNames, kModeSeed, kModeBits, namehash::MakeIndices<(1u << kModeBits)>::type());
+static_assert(namehash::isPerfect(kModeNames, kModeSeed, kModeBits), "mode hash collision, pick another kModeSeed");
+
+}  // namespace
+
+bool lookupKey(const char* name, Key& key) {
+  const int8_t index = namehash::lookup(kKeyNames, kKeySlots, kKeySeed, kKeyBits, name, false);
+  if (index < 0) {
+    return false;
+  }
+  key = static_cast<Key>(kKeyNames[index].value);
+  return true;
+}
+
+bool lookupMovementMode(const char* name, hexapod::MovementMode& mode) {
+  const int8_t index = namehash::lookup(kModeNames, kModeSlots, kModeSeed, kModeBits, name, true);
+  if (index < 0) {
+    return false;
+  }
+  mode = static_cast<hexapod::MovementMode>(kModeNames[index].value);
+  return true;
+}
+
+const char* movementModeName(hexapod::MovementMode mode) {
+  // 每个模式的第一个名字是不带下划线的写法
+  for (const namehash::Entry& entry : kModeNames) {
+    if (entry.value == mode) {
+      return entry.name;
+    }
+  }
+  return "unknown";
+}
+
+void Fields::collect(JsonObjectConst object) {
+  for (JsonPairConst pair : object) {
+    Key key;
+    if (lookupKey(pair.key().c_str(), key) && !has(key)) {
+      values_[index(key)] = pair.value();
+      present_ |= bit(key);
+    }
+  }
+}
+
+}  // namespace cmdkeys
@@ -0,0 +1,77 @@
+// JSON 控制协议的单遍字段分发
+// - 指令对象只遍历一次，每个键经编译期完美哈希表（name_hash.h）映射为 Key，值按 Key 存入 Fields；
+//   之后的判断都是数组下标访问，不再对对象做多次 containsKey / operator[] 线性查找
+// - 运动模式名（"forward"、"turn_left" 等，大小写不敏感）同样走完美哈希，不再构造 String 转小写逐个比较
+// - 与平台无关（只依赖 ArduinoJson 与 movement.h），可在主机上编译做基准测试
+#pragma once
+
+#include <ArduinoJson.h>
+
+#include "movement.h"
+
+namespace cmdkeys {
+
+// 协议字段（顶层指令与 sequence 中的动作对象共用）
+enum class Key : uint8_t {
+  Stop = 0,
+  ClearQueue,
+  CancelSequence,
+  SingleLeg,
+  Performance,
+  Repeat,
+  Sequence,
+  SequenceId,
+  Priority,
+  Append,
+  MovementMode,
+  Mode,
+  Speed,
+  SpeedLevel,
+  GaitMode,
+  SpeedOverride,
+  DurationMs,
+  Cycles,
+  Steps,
+  Distance,
+  Angle,
+  Link,
+  Baud,
+  Seed,
+  Count,
+};
+
+constexpr size_t kKeyCount = static_cast<size_t>(Key::Count);
+
+// 键名 -> Key，未知键返回 false
+bool lookupKey(const char* name, Key& key);
+
+// 运动模式名 -> MovementMode（大小写不敏感）
+bool lookupMovementMode(const char* name, hexapod::MovementMode& mode);
+
+// MovementMode -> 模式名（不带下划线的写法），无效模式返回 "unknown"
+const char* movementModeName(hexapod::MovementMode mode);
+
+// 单遍收集的指令字段
+class Fields {
+public:
+  Fields() : present_(0) {}
+  explicit Fields(JsonObjectConst object) : present_(0) { collect(object); }
+
+  // 遍历对象一次；未知键忽略，重复键取第一个（与 ArduinoJson 的 operator[] 一致）
+  void collect(JsonObjectConst object);
+
+  bool has(Key key) const { return (present_ & bit(key)) != 0; }
+  JsonVariantConst operator[](Key key) const { return has(key) ? values_[index(key)] : JsonVariantConst(); }
+  bool empty() const { return present_ == 0; }
+
+private:
+  static size_t index(Key key) { return static_cast<size_t>(key); }
+  static uint32_t bit(Key key) { return 1UL << index(key); }
+
+  uint32_t present_;
+  JsonVariantConst values_[kKeyCount];
+};
+
+static_assert(kKeyCount <= 32, "Fields::present_ holds one bit per key");
+
+}  // namespace cmdkeys
@@ -14,10 +14,18 @@ Preferences prefs;
 static constexpr const char* kNs = "settings";
 static constexpr const char* kKeyLowBatteryProtect = "lb_protect";
 static constexpr const char* kKeyMotionButtonMode = "motion_btn";
+static constexpr const char* kKeyGovernorEnabled = "gov_on";
+static constexpr const char* kKeyGovernorFloorMv = "gov_floor";
 
 // 缓存值（避免频繁 NVS IO）
 bool cachedLowBatteryProtectionEnabled = true;
 MotionButtonMode cachedMotionButtonMode = MotionButtonMode::Continuous;
+bool cachedGovernorEnabled = true;
+uint16_t cachedGovernorFloorMv = kGovernorFloorDefaultMv;
+
+bool isValidGovernorFloor(uint16_t floorMv) {
+  return floorMv >= kGovernorFloorMinMv && floorMv <= kGovernorFloorMaxMv;
+}
 
 void loadFromNvs() {
   // 只读打开若命名空间尚未创建会返回 false，首次需回退到读写创建
@@ -32,6 +40,11 @@ void loadFromNvs() {
   cachedMotionButtonMode = (rawMotionButtonMode == static_cast<uint8_t>(MotionButtonMode::SingleCycle))
     ? MotionButtonMode::SingleCycle
     : MotionButtonMode::Continuous;
+  cachedGovernorEnabled = prefs.getBool(kKeyGovernorEnabled, true);
+  cachedGovernorFloorMv = prefs.getUShort(kKeyGovernorFloorMv, kGovernorFloorDefaultMv);
+  if (!isValidGovernorFloor(cachedGovernorFloorMv)) {
+    cachedGovernorFloorMv = kGovernorFloorDefaultMv;
+  }
   prefs.end();
 }
 
@@ -53,6 +66,16 @@ bool writeMotionButtonModeToNvs(MotionButtonMode mode) {
   return true;
 }
 
+bool writeGovernorToNvs(bool enabled, uint16_t floorMv) {
+  if (!prefs.begin(kNs, false)) {
+    return false;
+  }
+  prefs.putBool(kKeyGovernorEnabled, enabled);
+  prefs.putUShort(kKeyGovernorFloorMv, floorMv);
+  prefs.end();
+  return true;
+}
+
 }  // namespace
 
 void init() {
@@ -66,6 +89,8 @@ bool isLowBatteryProtectionEnabled() {
 PowerSettings getPowerSettings() {
   PowerSettings s;
   s.lowBatteryProtectionEnabled = cachedLowBatteryProtectionEnabled;
+  s.governorEnabled = cachedGovernorEnabled;
+  s.governorFloorMv = cachedGovernorFloorMv;
   return s;
 }
 
@@ -88,6 +113,19 @@ bool setLowBatteryProtectionEnabled(bool enabled) {
   return true;
 }
 
+bool setGovernor(bool enabled, uint16_t floorMv) {
+  if (!isValidGovernorFloor(floorMv)) {
+    return false;
+  }
+  if (!writeGovernorToNvs(enabled, floorMv)) {
+    return false;
+  }
+  cachedGovernorEnabled = enabled;
+  cachedGovernorFloorMv = floorMv;
+  Serial.printf("Settings: governorEnabled=%s governorFloorMv=%u\n", enabled ? "true" : "false", floorMv);
+  return true;
+}
+
 bool setMotionButtonMode(MotionButtonMode mode) {
   if (!writeMotionButtonModeToNvs(mode)) {
     return false;
@@ -12,8 +12,15 @@ enum class MotionButtonMode : uint8_t {
   SingleCycle = 1,
 };
 
+// 功率调节器的带载电压下限范围（mV，2S 电池）
+static constexpr uint16_t kGovernorFloorMinMv = 6600;
+static constexpr uint16_t kGovernorFloorMaxMv = 8000;
+static constexpr uint16_t kGovernorFloorDefaultMv = 7000;
+
 struct PowerSettings {
   bool lowBatteryProtectionEnabled = true;
+  bool governorEnabled = true;
+  uint16_t governorFloorMv = kGovernorFloorDefaultMv;
 };
 
 struct MotionSettings {
@@ -32,6 +39,8 @@ MotionSettings getMotionSettings();
 // 写入 NVS 并更新缓存
 // 返回 true 表示写入成功
 bool setLowBatteryProtectionEnabled(bool enabled);
+// 功率调节器开关与带载电压下限（floorMv 超出范围时返回 false）
+bool setGovernor(bool enabled, uint16_t floorMv);
 bool setMotionButtonMode(MotionButtonMode mode);
 
 }  // namespace devsettings
@@ -0,0 +1,182 @@
+// 事件扇出（/cmd WebSocket 客户端 + UART2）
+
+#include "event_fanout.h"
+
+namespace eventfanout {
+
+namespace {
+
+static constexpr size_t kFormatCount = 2;
+static constexpr size_t kSlotCount = static_cast<size_t>(Slot::Count);
+static constexpr size_t kMaxPendingClients = DEFAULT_MAX_WS_CLIENTS;
+static constexpr size_t kSinkBufferSize = 192;
+
+struct PendingEvent {
+  AsyncWebSocketMessageBuffer* buffers[kFormatCount];  // 持有一份引用，补发完成后释放
+  uint32_t clientIds[kMaxPendingClients];
+  uint8_t clientCount;
+};
+
+PendingEvent pendingEvents[kSlotCount];
+uint8_t pendingTotal = 0;
+Stats stats;
+
+size_t indexOf(jsonpool::Format format) {
+  return static_cast<size_t>(format);
+}
+
+AsyncWebSocketMessageBuffer* serializeToBuffer(AsyncWebSocket& server, jsonpool::Format format, const JsonDocument& doc) {
+  const size_t length = jsonpool::measure(format, doc);
+  AsyncWebSocketMessageBuffer* buffer = server.makeBuffer(length);
+  if (!buffer || !buffer->get()) {
+    return nullptr;
+  }
+  // makeBuffer 额外分配 1 字节存放 '\0'
+  jsonpool::serialize(format, doc, reinterpret_cast<char*>(buffer->get()), length + 1);
+  ++stats.serializations;
+  return buffer;
+}
+
+void enqueue(AsyncWebSocketClient* client, jsonpool::Format format, AsyncWebSocketMessageBuffer* buffer) {
+  if (format == jsonpool::Format::MsgPack) {
+    client->binary(buffer);
+  } else {
+    client->text(buffer);
+  }
+  ++stats.delivered;
+}
+
+void retain(AsyncWebSocketMessageBuffer* buffer) {
+  if (buffer) {
+    (*buffer)++;
+  }
+}
+
+void release(AsyncWebSocketMessageBuffer*& buffer) {
+  if (buffer) {
+    (*buffer)--;
+    buffer = nullptr;
+  }
+}
+
+void removeAt(PendingEvent& pending, uint8_t index) {
+  pending.clientIds[index] = pending.clientIds[pending.clientCount - 1];
+  --pending.clientCount;
+  --pendingTotal;
+}
+
+}  // namespace
+
+void publish(AsyncWebSocket& server, const JsonDocument& doc, Slot slot, Sink sink, jsonpool::Format sinkFormat) {
+  ++stats.events;
+  PendingEvent& pending = pendingEvents[static_cast<size_t>(slot)];
+
+  // 新事件取代尚未补发的同类旧事件：旧的暂缓列表清空，本轮队列仍满的客户端重新记入
+  stats.coalesced += pending.clientCount;
+  pendingTotal -= pending.clientCount;
+  pending.clientCount = 0;
+
+  AsyncWebSocketMessageBuffer* buffers[kFormatCount] = {nullptr, nullptr};
+  // getClients() 返回浅拷贝的链表，不会释放节点
+  for (AsyncWebSocketClient* client : server.getClients()) {
+    if (!client || client->status() != WS_CONNECTED) {
+      continue;
+    }
+    const jsonpool::Format format = jsonpool::clientFormat(client);
+    AsyncWebSocketMessageBuffer*& buffer = buffers[indexOf(format)];
+    if (!buffer) {
+      buffer = serializeToBuffer(server, format, doc);
+      if (!buffer) {
+        ++stats.dropped;
+        continue;
+      }
+      buffer->lock();
+    }
+    if (client->queueIsFull()) {
+      if (pending.clientCount < kMaxPendingClients) {
+        pending.clientIds[pending.clientCount++] = client->id();
+        ++pendingTotal;
+        ++stats.deferred;
+      } else {
+        ++stats.dropped;
+      }
+      continue;
+    }
+    enqueue(client, format, buffer);
+  }
+
+  // 暂缓列表引用本轮的缓冲，旧缓冲交还给库回收
+  for (size_t i = 0; i < kFormatCount; ++i) {
+    release(pending.buffers[i]);
+    if (pending.clientCount > 0) {
+      pending.buffers[i] = buffers[i];
+      retain(buffers[i]);
+    }
+  }
+
+  if (sink) {
+    AsyncWebSocketMessageBuffer* shared = buffers[indexOf(sinkFormat)];
+    if (shared) {
+      sink(reinterpret_cast<const char*>(shared->get()), shared->length());
+    } else {
+      char payload[kSinkBufferSize];
+      const size_t length = jsonpool::serialize(sinkFormat, doc, payload, sizeof(payload));
+      if (length > 0) {
+        ++stats.serializations;
+        sink(payload, length);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < kFormatCount; ++i) {
+    if (buffers[i]) {
+      buffers[i]->unlock();
+    }
+  }
+  server._cleanBuffers();
+}
+
+void flushPending(AsyncWebSocket& server) {
+  if (pendingTotal == 0) {
+    return;
+  }
+  for (size_t s = 0; s < kSlotCount; ++s) {
+    PendingEvent& pending = pendingEvents[s];
+    uint8_t i = 0;
+    while (i < pending.clientCount) {
+      // client() 只返回仍处于连接状态的客户端
+      AsyncWebSocketClient* client = server.client(pending.clientIds[i]);
+      if (!client) {
+        ++stats.dropped;
+        removeAt(pending, i);
+        continue;
+      }
+      if (client->queueIsFull()) {
+        ++i;
+        continue;
+      }
+      AsyncWebSocketMessageBuffer* buffer = pending.buffers[indexOf(jsonpool::clientFormat(client))];
+      if (buffer) {
+        enqueue(client, jsonpool::clientFormat(client), buffer);
+      } else {
+        // 暂缓后客户端切换了格式，没有对应格式的缓冲
+        ++stats.dropped;
+      }
+      removeAt(pending, i);
+    }
+    if (pending.clientCount == 0) {
+      for (size_t f = 0; f < kFormatCount; ++f) {
+        release(pending.buffers[f]);
+      }
+    }
+  }
+  server._cleanBuffers();
+}
+
+Stats getStats() {
+  Stats out = stats;
+  out.pending = pendingTotal;
+  return out;
+}
+
+}  // namespace eventfanout
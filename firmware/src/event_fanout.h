@@ -0,0 +1,48 @@
+// 事件扇出（/cmd WebSocket 客户端 + UART2）
+// - 每个事件每种格式（JSON / MessagePack）只序列化一次，写入 AsyncWebSocketMessageBuffer；
+//   同格式的客户端共享该缓冲（库按引用计数释放），客户端数量增加时内存不随之翻倍
+// - 串口等其它通道通过 sink 复用同一份序列化结果
+// - 客户端消息队列已满（WS_MAX_QUEUED_MESSAGES）时不再入队（库会直接丢弃并打印错误），
+//   改为记入该类事件的暂缓列表，由 flushPending() 在队列腾出后补发；
+//   同类事件只保留最新一条（序列按顺序完成、低电量为状态），新事件到来时旧的暂缓事件被合并
+// - 只在主循环任务中调用
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+
+#include "json_pool.h"
+
+namespace eventfanout {
+
+// 事件类别：同类事件互相合并
+enum class Slot : uint8_t {
+  SequenceComplete = 0,
+  LowBattery,
+  Count,
+};
+
+struct Stats {
+  uint32_t events = 0;          // 发布的事件数
+  uint32_t serializations = 0;  // 实际序列化次数（每个事件每种格式最多一次）
+  uint32_t delivered = 0;       // 入队到客户端的消息数（含补发）
+  uint32_t deferred = 0;        // 客户端队列已满而暂缓的次数
+  uint32_t coalesced = 0;       // 暂缓中的旧事件被同类新事件取代
+  uint32_t dropped = 0;         // 客户端断开、暂缓列表已满或缓冲分配失败而放弃
+  uint8_t pending = 0;          // 当前暂缓的客户端数
+};
+
+// 其它通道的发送函数（如 seriallink::sendJson）
+typedef void (*Sink)(const char* data, size_t length);
+
+// 按各客户端的格式推送事件；sink 非空时以 sinkFormat 格式同时交给 sink
+void publish(AsyncWebSocket& server, const JsonDocument& doc, Slot slot,
+             Sink sink = nullptr, jsonpool::Format sinkFormat = jsonpool::Format::Json);
+
+// 补发暂缓的事件（主循环中周期调用，无暂缓时立即返回）
+void flushPending(AsyncWebSocket& server);
+
+Stats getStats();
+
+}  // namespace eventfanout
@@ -1,10 +1,13 @@
 #include <ArduinoJson.h>
-#include <SPIFFS.h>
+#include "storage.h"
 
 #include "hexapod.h"
 #include "servo.h"
 #include "debug.h"
 #include "robot.h"
+#include "transition_timing.h"
+
+#include <cmath>
 
 namespace hexapod {
 
@@ -18,15 +21,38 @@ namespace hexapod {
     HexapodClass::HexapodClass(): 
         legs_{{0}, {1}, {2}, {3}, {4}, {5}}, 
         movement_{MOVEMENT_STANDBY},
-        mode_{MOVEMENT_STANDBY}
+        mode_{MOVEMENT_STANDBY},
+        speedScale_{1.0f},
+        liftScale_{1.0f},
+        jointAnglesValid_{false},
+        advancedMs_{0},
+        servoRefreshMs_{0},
+        servoRefreshIndex_{0}
     {
-
+        // 过渡时长按各腿沿插值路径的关节角度变化与关节限速计算
+        movement_.setTransitionTimer([this](const Locations& from, const Locations& to) {
+            float slowest = 0;
+            for (int i = 0; i < 6; i++) {
+                float angles[transition::kPathSegments + 1][3];
+                for (int s = 0; s <= transition::kPathSegments; s++) {
+                    Point3D tip = from.get(i);
+                    tip += (to.get(i) - from.get(i)) * (static_cast<float>(s) / transition::kPathSegments);
+                    legs_[i].jointAnglesFor(tip, angles[s]);
+                }
+                const float ms = transition::pathTravelMs(angles, transition::kPathSegments, config::jointSpeedLimitDegPerSec);
+                if (ms > slowest)
+                    slowest = ms;
+            }
+            return slowest;
+        });
     }
 
     void HexapodClass::init(bool setting, bool isReset) {
         Servo::init();
 
         calibrationLoad();
+        // 驱动板可能刚复位（或校准参数已变）：不再信任上一次下发的 tick
+        invalidateServos();
         movement_.snapToMode(MOVEMENT_STANDBY);
         mode_ = MOVEMENT_STANDBY;
 
@@ -41,15 +67,130 @@ namespace hexapod {
     }
 
     void HexapodClass::processMovement(MovementMode mode, int elapsed) {
+        refreshServos(elapsed);
+
         if (mode_ != mode) {
             mode_ = mode;
             movement_.setMode(mode_);
         }
 
-        auto& location = movement_.next(elapsed);
+        // 稳定裕度：按当前足端与步态相位的触地状态计算，裕度不足时放慢或暂停摆动
+        float timeScale = 1.0f;
+        if (elapsed > 0) {
+            Point3D feet[6];
+            bool contact[6];
+            for(int i=0;i<6;i++)
+                feet[i] = movement_.position().get(i);
+            movement_.contactStates(contact);
+            const float pace = movement_.getSpeed() / config::maxSpeed * speedScale_;
+            timeScale = stability_.update(feet, contact, 6, elapsed, pace);
+        }
+
+        const int step = clock_.advance(elapsed, speedScale_ * timeScale);
+        advancedMs_ = step;
+        if (elapsed > 0 && step <= 0) {
+            // 停顿：保持当前姿态
+            jointTravel_ = JointTravel();
+            return;
+        }
+
+        auto& location = movement_.next(step);
+
+        // 功率调节：行走时按 liftScale_ 压低摆动腿高度（相对站立高度）
+        const bool scaleLift = liftScale_ < 1.0f && isLocomotionMode(mode_);
+        const Locations& standby = getMovementTable(MOVEMENT_STANDBY).table[0];
+        JointTravel travel;
         for(int i=0;i<6;i++) {
-            legs_[i].moveTip(location.get(i));
+            Point3D tip = location.get(i);
+            const float standZ = standby.get(i).z_;
+            if (scaleLift && tip.z_ > standZ) {
+                tip.z_ = standZ + (tip.z_ - standZ) * liftScale_;
+            }
+            legs_[i].moveTip(tip);
+            tips_[i] = tip;
+
+            const bool swing = tip.z_ > standZ + kSwingLiftThresholdMm;
+            for(int j=0;j<3;j++) {
+                const float angle = legs_[i].get(j)->getAngle();
+                if (jointAnglesValid_) {
+                    const float delta = std::fabs(angle - jointAngles_[i][j]);
+                    if (swing)
+                        travel.swingDeg += delta;
+                    else
+                        travel.stanceDeg += delta;
+                }
+                jointAngles_[i][j] = angle;
+            }
+        }
+        jointAnglesValid_ = true;
+        jointTravel_ = travel;
+    }
+
+    void HexapodClass::invalidateServos() {
+        for (int i = 0; i < 6; i++)
+            for (int j = 0; j < 3; j++)
+                legs_[i].get(j)->invalidate();
+    }
+
+    void HexapodClass::refreshServos(int elapsed) {
+        // 每 servoRefreshIntervalMs 轮完 18 路：每次只重发一路，把 I2C 写入分散到各个控制周期；
+        // 每轮开始时检查驱动板，复位过的板所有通道都没有输出，立即全部重发
+        servoRefreshMs_ += elapsed;
+        if (servoRefreshMs_ < config::servoRefreshIntervalMs / 18)
+            return;
+        servoRefreshMs_ = 0;
+        if (servoRefreshIndex_ == 0 && Servo::recoverBoards()) {
+            for (int i = 0; i < 6; i++)
+                for (int j = 0; j < 3; j++)
+                    legs_[i].get(j)->refresh();
+            return;
         }
+        legs_[servoRefreshIndex_ / 3].get(servoRefreshIndex_ % 3)->refresh();
+        servoRefreshIndex_ = (servoRefreshIndex_ + 1) % 18;
+    }
+
+    void HexapodClass::setPowerLimits(float speedScale, float liftScale) {
+        speedScale_ = speedScale;
+        liftScale_ = liftScale;
+    }
+
+    JointTravel HexapodClass::lastJointTravel() const {
+        return jointTravel_;
+    }
+
+    int HexapodClass::lastMovementAdvanceMs(int requestedMs) const {
+        (void)requestedMs;
+        return advancedMs_;
+    }
+
+    stability::Stats HexapodClass::stabilityStats() const {
+        return stability_.stats();
+    }
+
+    int HexapodClass::legCount() const {
+        return 6;
+    }
+
+    bool HexapodClass::footTip(int legIndex, Point3D& tip) const {
+        if (legIndex < 0 || legIndex >= 6 || !jointAnglesValid_) {
+            return false;
+        }
+        tip = tips_[legIndex];
+        return true;
+    }
+
+    bool HexapodClass::jointAngles(int legIndex, float angles[3]) const {
+        if (legIndex < 0 || legIndex >= 6 || !jointAnglesValid_) {
+            return false;
+        }
+        for (int j = 0; j < 3; ++j) {
+            angles[j] = jointAngles_[legIndex][j];
+        }
+        return true;
+    }
+
+    bool HexapodClass::isTransitioning() const {
+        return movement_.isTransiting();
     }
 
     bool HexapodClass::supportsSingleLegControl() const {
@@ -120,7 +261,7 @@ namespace hexapod {
     }
 
     void HexapodClass::setMovementSpeed(float speed) {
-        // 受限于舵机频率(50hz->20ms)，速度控制只能是离散的(1/n)
+        // 受限于控制周期(config::movementInterval，默认 20ms 对应 50Hz 舵机刷新)，速度控制只能是离散的(1/n)
         movement_.setSpeed(speed);
         char buffer[100]; 
         snprintf(buffer, sizeof(buffer), "运动速度已设置为: %.2f (范围: %.1f - %.1f)", 
@@ -158,8 +299,9 @@ namespace hexapod {
 
     void HexapodClass::calibrationSave() {
         // {"leg1": [0, 0, 0], ..., "leg6: [0, 0, 0]"}
+        // 存在多点校准曲线的腿额外写入 "curveN": [[5 个锚点修正量] x 3]，全零曲线不落盘以保持文件紧凑
 
-        StaticJsonDocument<512> doc;
+        StaticJsonDocument<2560> doc;
 
         for(int i=0;i<6;i++) {
             char leg[5];
@@ -172,23 +314,42 @@ namespace hexapod {
                 Serial.println(offset);
                 legData.add((short)offset);
             }
+
+            bool hasCurve = false;
+            for(int j=0; j<3; j++) {
+                int correction;
+                for(int k=0; k<ServoCurve::kPointCount; k++) {
+                    legs_[i].get(j)->getCurvePoint(k, correction);
+                    if (correction != 0)
+                        hasCurve = true;
+                }
+            }
+            if (!hasCurve)
+                continue;
+
+            char curve[8];
+            sprintf(curve, "curve%d", i);
+            JsonArray curveData = doc.createNestedArray(curve);
+            for(int j=0; j<3; j++) {
+                JsonArray jointCurve = curveData.createNestedArray();
+                for(int k=0; k<ServoCurve::kPointCount; k++) {
+                    int correction;
+                    legs_[i].get(j)->getCurvePoint(k, correction);
+                    jointCurve.add((short)correction);
+                }
+            }
         }
 
         String output;
         serializeJson(doc, output);
         Serial.println(output);
 
-        File file = SPIFFS.open(calibrationFilePath, FILE_WRITE);
-        if (!file) {
-            Serial.println("Failed to open file for writing");
-            return;
+        // 原子写入（临时文件 + rename），写到一半掉电时保留旧的校准文件
+        String error;
+        if (!storage::writeRecord(calibrationFilePath, output, error)) {
+            Serial.print("Failed to save calibration: ");
+            Serial.println(error);
         }
-
-        if (serializeJson(doc, file) == 0) {
-            Serial.println("Failed to write to file");
-        }
-
-        file.close();
     }
 
     void HexapodClass::calibrationGet(int legIndex, int partIndex, int& offset) {
@@ -211,6 +372,10 @@ namespace hexapod {
     }
 
     void HexapodClass::calibrationSet(CalibrationData&  calibrationData) {
+        if (calibrationData.curvePoint >= 0) {
+            calibrationCurveSet(calibrationData.legIndex, calibrationData.partIndex, calibrationData.curvePoint, calibrationData.curveValue);
+            return;
+        }
         calibrationSet(calibrationData.legIndex, calibrationData.partIndex, calibrationData.offset);
     }
 
@@ -229,19 +394,47 @@ namespace hexapod {
         }
     }
 
+    void HexapodClass::calibrationCurveGet(int legIndex, int partIndex, int point, int& correctionUs) {
+        if (legIndex < 0 || legIndex >= 6 || partIndex < 0 || partIndex >= 3) {
+            correctionUs = 0;
+            return;
+        }
+        legs_[legIndex].get(partIndex)->getCurvePoint(point, correctionUs);
+    }
+
+    void HexapodClass::calibrationCurveSet(int legIndex, int partIndex, int point, int correctionUs) {
+        if (legIndex < 0 || legIndex >= 6 || partIndex < 0 || partIndex >= 3) {
+            return;
+        }
+        char buffer[120];
+        snprintf(buffer, sizeof(buffer), "腿部关节舵机曲线校准: 腿部索引[%d] 关节索引[%d] 锚点[%d] 修正量[%dus]", legIndex, partIndex, point, correctionUs);
+        LOG_INFO(buffer);
+
+        legs_[legIndex].get(partIndex)->setCurvePoint(point, correctionUs, false);
+    }
+
+    void HexapodClass::calibrationCurveTest(int legIndex, int partIndex, int point) {
+        if (legIndex < 0 || legIndex >= 6 || partIndex < 0 || partIndex >= 3) {
+            return;
+        }
+        legs_[legIndex].get(partIndex)->testCurvePoint(point);
+    }
+
     void HexapodClass::calibrationLoad() {
-        File file = SPIFFS.open(calibrationFilePath, FILE_READ);
-        if (!file) {
-            Serial.println("[Warn] Failed to open file for reading. Skipping calibration parameters loading!!!");
+        String payload;
+        String readError;
+        if (!storage::readRecord(calibrationFilePath, payload, readError)) {
+            Serial.print("[Warn] Calibration file unavailable (");
+            Serial.print(readError);
+            Serial.println("). Skipping calibration parameters loading!!!");
             return;
         }
 
-        StaticJsonDocument<512> doc;
-        DeserializationError error = deserializeJson(doc, file);
+        StaticJsonDocument<2560> doc;
+        DeserializationError error = deserializeJson(doc, payload);
         if (error) {
             Serial.print("Failed to read file, using default configuration: ");
             Serial.println(error.c_str());
-            file.close();
             return;
         }
         LOG_INFO("Read Servo Motors Calibration Data:");
@@ -261,14 +454,25 @@ namespace hexapod {
                 // 等后续 standby/动作下发时再统一 setAngle。
                 legs_[i].get(j)->setParameter(param, false);
             }
-        }
 
-        file.close();
+            // 旧版校准文件没有曲线字段，此时保持线性（曲线全零）
+            char curve[8];
+            sprintf(curve, "curve%d", i);
+            JsonArray curveData = doc[curve];
+            for (int j = 0; j < 3; j++) {
+                JsonArray jointCurve = curveData[j];
+                for (int k = 0; k < ServoCurve::kPointCount; k++) {
+                    int correction = jointCurve[k] | 0;
+                    legs_[i].get(j)->setCurvePoint(k, correction, false);
+                }
+            }
+        }
     }
 
     void HexapodClass::clearOffset() {
         for(int i=0; i<6; i++) {
             for(int j=0; j<3; j++) {
+                legs_[i].get(j)->clearCurve(false);
                 legs_[i].get(j)->setParameter(0, true);
             }
         }
@@ -28,6 +28,20 @@ namespace hexapod {
         float getMovementSpeed() const;
         float getMovementCycleDurationMs(MovementMode mode) const override;
 
+        // Power governor API
+        void setPowerLimits(float speedScale, float liftScale) override;
+        JointTravel lastJointTravel() const override;
+        int lastMovementAdvanceMs(int requestedMs) const override;
+
+        // Stability API
+        stability::Stats stabilityStats() const override;
+
+        // Kinematic state API
+        int legCount() const override;
+        bool footTip(int legIndex, Point3D& tip) const override;
+        bool jointAngles(int legIndex, float angles[3]) const override;
+        bool isTransitioning() const override;
+
         // Calibration API
 
         void calibrationSave(); // write to flash
@@ -36,6 +50,9 @@ namespace hexapod {
         void calibrationSet(CalibrationData&  calibrationData);
         void calibrationTest(int legIndex, int partIndex, float angle);             // test servo setting
         void calibrationTestAllLeg(float angle);
+        void calibrationCurveGet(int legIndex, int partIndex, int point, int& correctionUs);
+        void calibrationCurveSet(int legIndex, int partIndex, int point, int correctionUs);
+        void calibrationCurveTest(int legIndex, int partIndex, int point);
         void clearOffset();
         void forceResetAllLegTippos();
 
@@ -49,12 +66,26 @@ namespace hexapod {
 
     private:
         void calibrationLoad(); // read from flash
+        void invalidateServos();
+        void refreshServos(int elapsed);
 
     private:
         const char* calibrationFilePath = "/calibration.json";
         MovementMode mode_;
         Movement movement_;
         Leg legs_[6];
+
+        float speedScale_;
+        float liftScale_;
+        ScaledClock clock_;
+        Point3D tips_[6];
+        float jointAngles_[6][3];
+        bool jointAnglesValid_;
+        JointTravel jointTravel_;
+        int advancedMs_;
+        int servoRefreshMs_;
+        int servoRefreshIndex_;     // 下一路周期重发的舵机（腿 * 3 + 关节）
+        stability::Monitor stability_;
     };
 
     extern HexapodClass Hexapod;
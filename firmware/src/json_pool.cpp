@@ -0,0 +1,160 @@
+// 指令通道复用的 JSON 文档与发送缓冲
+
+#include "json_pool.h"
+
+namespace jsonpool {
+
+namespace {
+
+static constexpr size_t kChannelCount = static_cast<size_t>(Channel::Count);
+static constexpr size_t kReplyBufferSize = 384;
+
+// 指令文档：WebSocket 需容纳最长的 sequence 指令（最多 motion::kMaxSequenceLength 段），
+// 零拷贝解析后文档只存节点，不存字符串
+StaticJsonDocument<3072> wsCommand;
+StaticJsonDocument<1024> serialCommand;
+StaticJsonDocument<256> replyDocs[kChannelCount];
+char replyBuffers[kChannelCount][kReplyBufferSize];
+Format formats[kChannelCount];
+Stats stats[kChannelCount];
+
+size_t indexOf(Channel channel) {
+  return static_cast<size_t>(channel);
+}
+
+}  // namespace
+
+JsonDocument& command(Channel channel) {
+  if (channel == Channel::WebSocket) {
+    return wsCommand;
+  }
+  return serialCommand;
+}
+
+JsonDocument& reply(Channel channel) {
+  JsonDocument& doc = replyDocs[indexOf(channel)];
+  doc.clear();
+  return doc;
+}
+
+Format format(Channel channel) {
+  return formats[indexOf(channel)];
+}
+
+Format detectFormat(const uint8_t* data, size_t length) {
+  if (length == 0) {
+    return Format::Json;
+  }
+  const uint8_t first = data[0];
+  return ((first & 0xF0) == 0x80 || first == 0xDE || first == 0xDF) ? Format::MsgPack : Format::Json;
+}
+
+DeserializationError parse(Channel channel, char* input, size_t length, Format format) {
+  JsonDocument& doc = command(channel);
+  // MessagePack 同样就地解析：字符串在输入缓冲内前移并补 '\0'，文档只存节点
+  const DeserializationError err = format == Format::MsgPack
+      ? deserializeMsgPack(doc, input, length)
+      : deserializeJson(doc, input, length);
+  formats[indexOf(channel)] = format;
+  Stats& s = stats[indexOf(channel)];
+  ++s.commands;
+  if (format == Format::MsgPack) {
+    ++s.msgpackCommands;
+  }
+  if (err == DeserializationError::NoMemory) {
+    ++s.overflows;
+  }
+  if (doc.memoryUsage() > s.peakCommandBytes) {
+    s.peakCommandBytes = static_cast<uint16_t>(doc.memoryUsage());
+  }
+  return err;
+}
+
+size_t measure(Format format, const JsonDocument& doc) {
+  return format == Format::MsgPack ? measureMsgPack(doc) : measureJson(doc);
+}
+
+size_t serialize(Format format, const JsonDocument& doc, char* buffer, size_t capacity) {
+  if (format == Format::MsgPack) {
+    if (measureMsgPack(doc) > capacity) {
+      return 0;
+    }
+    return serializeMsgPack(doc, buffer, capacity);
+  }
+  if (measureJson(doc) >= capacity) {
+    return 0;
+  }
+  return serializeJson(doc, buffer, capacity);
+}
+
+size_t serializeReply(Channel channel, JsonDocument& doc, const char*& out) {
+  Stats& s = stats[indexOf(channel)];
+  if (doc.overflowed()) {
+    ++s.overflows;
+  }
+  char* buffer = replyBuffers[indexOf(channel)];
+  const Format replyFormat = formats[indexOf(channel)];
+  size_t length = serialize(replyFormat, doc, buffer, kReplyBufferSize);
+  ++s.replies;
+  if (length == 0) {
+    // 超出缓冲：截断发送（JSON 保持原有行为），计入 overflows
+    ++s.overflows;
+    length = replyFormat == Format::MsgPack
+        ? serializeMsgPack(doc, buffer, kReplyBufferSize)
+        : serializeJson(doc, buffer, kReplyBufferSize);
+  }
+  if (length > s.peakReplyBytes) {
+    s.peakReplyBytes = static_cast<uint16_t>(length);
+  }
+  out = buffer;
+  return length;
+}
+
+void sendReply(AsyncWebSocketClient* client, JsonDocument& doc) {
+  if (!client) {
+    return;
+  }
+  const Format replyFormat = formats[indexOf(Channel::WebSocket)];
+  setClientFormat(client, replyFormat);
+  // 超出静态缓冲时退回 String，避免截断
+  if (measure(replyFormat, doc) >= kReplyBufferSize) {
+    Stats& s = stats[indexOf(Channel::WebSocket)];
+    ++s.heapAllocs;
+    ++s.replies;
+    String payload;
+    if (replyFormat == Format::MsgPack) {
+      serializeMsgPack(doc, payload);
+      client->binary(payload);
+    } else {
+      serializeJson(doc, payload);
+      client->text(payload);
+    }
+    return;
+  }
+  const char* payload = nullptr;
+  const size_t length = serializeReply(Channel::WebSocket, doc, payload);
+  if (replyFormat == Format::MsgPack) {
+    client->binary(payload, length);
+  } else {
+    client->text(payload, length);
+  }
+}
+
+void setClientFormat(AsyncWebSocketClient* client, Format format) {
+  if (client) {
+    client->_tempObject = reinterpret_cast<void*>(static_cast<uintptr_t>(format));
+  }
+}
+
+Format clientFormat(AsyncWebSocketClient* client) {
+  if (!client) {
+    return Format::Json;
+  }
+  return static_cast<Format>(reinterpret_cast<uintptr_t>(client->_tempObject));
+}
+
+Stats getStats(Channel channel) {
+  return stats[indexOf(channel)];
+}
+
+}  // namespace jsonpool
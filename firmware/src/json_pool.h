@@ -0,0 +1,68 @@
+// 指令通道复用的 JSON 文档与发送缓冲
+// - 每个通道（WebSocket / UART2）一份静态的指令文档、应答文档和序列化缓冲，启动时分配在 .bss，
+//   不再在 AsyncTCP / SerialLink 回调里每条消息占用数 KB 栈，也不再为应答构造 String
+// - 通道与任务一一对应（WebSocket 只在 async_tcp 任务、Serial 只在 SerialLink 任务中使用），无需加锁；
+//   主循环发起的事件推送（低电量、序列完成等）走 event_fanout.h，不使用通道的静态文档与缓冲；
+//   本模块不做多客户端推送，只提供格式识别、按客户端记录格式与按格式序列化，由 event_fanout 共享序列化结果
+// - 应答直接序列化进静态缓冲，再交给 AsyncWebSocketClient::text(const char*, len) / seriallink::sendJson，
+//   指令处理路径上不做堆分配；超出缓冲的应答计入 heapAllocs 并退回 String
+// - 指令可以是 JSON 文本或同一结构的 MessagePack（WebSocket 二进制帧 / 二进制链路 JsonCommand 报文），
+//   应答与事件按发送方最近一次指令的格式回送
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+
+namespace jsonpool {
+
+enum class Channel : uint8_t {
+  WebSocket = 0,
+  Serial,
+  Count,
+};
+
+enum class Format : uint8_t {
+  Json = 0,
+  MsgPack,
+};
+
+struct Stats {
+  uint32_t commands = 0;       // 解析的指令数
+  uint32_t replies = 0;        // 发送的应答数
+  uint32_t heapAllocs = 0;     // 本模块路径上的堆分配（应答超出静态缓冲时退回 String），稳定运行应为 0
+  uint32_t overflows = 0;      // 文档容量不足（指令或应答被截断）
+  uint32_t msgpackCommands = 0;  // 其中 MessagePack 格式的指令数
+  uint16_t peakCommandBytes = 0;  // 指令文档内存占用峰值，用于核对容量
+  uint16_t peakReplyBytes = 0;    // 应答序列化长度峰值
+};
+
+// 按首字节识别格式：指令总是对象，MessagePack 以 map 标记开头（fixmap 0x80-0x8f、map16 0xde、map32 0xdf），
+// JSON 文本以 '{' 或空白开头
+Format detectFormat(const uint8_t* data, size_t length);
+
+// 就地解析指令到通道的指令文档（input 可写，字符串不拷贝进文档），并记录该通道当前的应答格式
+DeserializationError parse(Channel channel, char* input, size_t length, Format format);
+// 最近一次 parse 的结果与格式
+JsonDocument& command(Channel channel);
+Format format(Channel channel);
+// 取得清空后的应答文档
+JsonDocument& reply(Channel channel);
+
+// 按格式序列化到调用方缓冲，返回长度（缓冲不足返回 0）；JSON 会在末尾补 '\0'
+size_t serialize(Format format, const JsonDocument& doc, char* buffer, size_t capacity);
+
+// 序列化应答文档并以 WebSocket 通道当前格式发送到客户端（JSON 为文本帧，MessagePack 为二进制帧）
+void sendReply(AsyncWebSocketClient* client, JsonDocument& doc);
+// 序列化应答文档，返回指向通道静态缓冲的内容与长度（下一次调用前有效）
+size_t serializeReply(Channel channel, JsonDocument& doc, const char*& out);
+
+// WebSocket 客户端的格式（记录在 AsyncWebSocketClient::_tempObject 中，库不会释放该字段）
+void setClientFormat(AsyncWebSocketClient* client, Format format);
+Format clientFormat(AsyncWebSocketClient* client);
+// 按格式估算序列化长度（不含 JSON 末尾的 '\0'）
+size_t measure(Format format, const JsonDocument& doc);
+
+Stats getStats(Channel channel);
+
+}  // namespace jsonpool
@@ -141,6 +141,12 @@ namespace hexapod {
         moveTipLocal(to);
     }
 
+    void Leg::jointAnglesFor(const Point3D& world, float angles[3]) const {
+        Point3D local;
+        localConv_(world - mountPosition_, local);
+        _inverseKinematics(local, angles);
+    }
+
     void Leg::moveTip(const Point3D& to) {
         if (to == tipPos_)
             return;
@@ -18,6 +18,9 @@ namespace hexapod {
 
         void setJointAngle(float angle[3]);
 
+        // 足端移动到 world（世界坐标）时的关节角度（度，未经舵机限幅），不驱动舵机
+        void jointAnglesFor(const Point3D& world, float angles[3]) const;
+
         // world coordinate system (default)
         void moveTip(const Point3D& to);
         const Point3D& getTipPosition(void);
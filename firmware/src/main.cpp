@@ -21,7 +21,6 @@ _mode和mode的处理在异步的Web服务回调函数中处理
 #include <ESPAsyncWebServer.h>
 #include <Wifi.h>
 #include <ArduinoJson.h>
-#include <SPIFFS.h>
 #include <HardwareSerial.h>
 
 #include "debug.h"
@@ -35,6 +34,21 @@ _mode和mode的处理在异步的Web服务回调函数中处理
 #include "motion_controller.h"
 #include "performance_controller.h"
 #include "single_leg_controller.h"
+#include "pwm.h"
+#include "web_assets.h"
+#include "storage.h"
+#include "boot_profile.h"
+#include "serial_link.h"
+#include "json_pool.h"
+#include "event_fanout.h"
+#include "battery_adc.h"
+#include "battery_estimator.h"
+#include "power_governor.h"
+#include "command_keys.h"
+#include "command_dispatch.h"
+#include "session_recorder.h"
+#include "rng.h"
+#include "transition_timing.h"
 
 // 宏定义
 #define REACT_DELAY hexapod::config::movementInterval
@@ -47,10 +61,12 @@ _mode和mode的处理在异步的Web服务回调函数中处理
 static constexpr const char* kRobotType = "quad";
 static constexpr int kRobotLegCount = 4;
 static constexpr const char* kCalibrationFilePath = "/calibration_quad.json";
+static constexpr sessionrec::Model kSessionModel = sessionrec::Model::Quad;
 #else
 static constexpr const char* kRobotType = "hexa";
 static constexpr int kRobotLegCount = 6;
 static constexpr const char* kCalibrationFilePath = "/calibration.json";
+static constexpr sessionrec::Model kSessionModel = sessionrec::Model::Hexapod;
 #endif
 
 // 调试模式控制
@@ -64,29 +80,52 @@ static constexpr const char* kCalibrationFilePath = "/calibration.json";
 
 // 静态变量
 static int8_t _mode = 0;  // 六足工作模式：0-运动模式 1-校准模式
-static int16_t flag = 0;   // 六足运动模式: 见枚举hexapod:MovementMode
 static float test_angle = 0.;
 
-// flag访问保护
-SemaphoreHandle_t flagMutex;
-
 // 串口通讯相关变量
-static String serialBuffer = "";  // 串口数据接收缓冲区
-static const unsigned long SERIAL_TIMEOUT = 1000;  // 串口数据超时时间(ms)
-static unsigned long lastSerialDataTime = 0;  // 上次接收串口数据的时间
-static bool frameStarted = false;  // 帧接收状态：false-等待起始符$，true-正在接收数据
+static const unsigned long SERIAL_TIMEOUT = 1000;  // 串口半帧超时时间(ms)
+static const int UART2_RX_PIN = 16;
+static const int UART2_TX_PIN = 17;
 
 // 电池监测相关变量
 static const float LOW_VOLTAGE_WARNING_THRESHOLD = 7.2f; // UI/警告阈值(V)
-static const float LOW_VOLTAGE_LATCH_THRESHOLD_STANDBY = 7.2f; // 待机/校准锁存阈值(V)
-static const float LOW_VOLTAGE_LATCH_THRESHOLD_MOVING = 7.0f; // 运动锁存阈值(V)
-static const float BATTERY_VOLTAGE_GAIN = 1.0122f; // 采样比例校准
+static const float LOW_VOLTAGE_LATCH_THRESHOLD = 7.2f; // 锁存阈值(V)，比较 IR 补偿后的开路电压
+static const float LOW_VOLTAGE_HARD_FLOOR = 6.6f; // 带载端电压硬下限(V)，内阻估计失准时兜底
+static const float LOW_BATTERY_RELEASE_HYSTERESIS = 0.3f; // 解除锁存需高出阈值的电压(V)
+static const float BATTERY_VOLTAGE_GAIN = 1.0122f; // 采样比例校准（分压电阻误差）
+static const float BATTERY_DIVIDER_RATIO = (100.0f + 47.0f) / 47.0f; // 100k/47k 分压
+static const uint8_t BATTERY_ADC_OVERSAMPLE = 32; // 每次采样的 ADC 过采样次数
 static const uint8_t LOW_BATTERY_LATCH_CONSECUTIVE_SAMPLES = 2; // 连续低压次数阈值
+static const uint8_t LOW_BATTERY_RELEASE_SAMPLES = 10; // 连续恢复次数阈值（更换/充电后）
 static const unsigned long LOW_BATTERY_SERIAL_REMINDER_INTERVAL_MS = 10000; // 串口提醒重发间隔
-// 低电量锁存：一旦置 true，只能通过重启恢复（避免 ADC 电压波动导致忽高忽低）
+#ifndef BATTERY_CAPACITY_MAH
+#define BATTERY_CAPACITY_MAH 2200
+#endif
+#ifndef BATTERY_CELL_COUNT
+#define BATTERY_CELL_COUNT 2
+#endif
+// 舵机电流模型：站立保持电流、行走（速度 1.0）增加的电流；关节系数按前进步态（速度 1.0）的关节角速度标定到同一电流
+#ifdef ROBOT_MODEL_NODEQUADMINI
+static const float SERVO_IDLE_CURRENT_A = 0.35f;
+static const float SERVO_ACTIVE_CURRENT_A = 1.2f;
+static const float SERVO_STANCE_AMPS_PER_DEG_S = 0.0012f;
+static const float SERVO_SWING_AMPS_PER_DEG_S = 0.0004f;
+#else
+static const float SERVO_IDLE_CURRENT_A = 0.6f;
+static const float SERVO_ACTIVE_CURRENT_A = 2.4f;
+static const float SERVO_STANCE_AMPS_PER_DEG_S = 0.0018f;
+static const float SERVO_SWING_AMPS_PER_DEG_S = 0.0006f;
+#endif
+static const unsigned long POWER_GOVERNOR_EXCHANGE_INTERVAL_MS = 250; // 主循环与电池任务交换估计值的间隔
+static const unsigned long JOINT_CURRENT_STALE_MS = 1500; // 超过该时间未更新的关节电流估计不再使用
+// 低电量锁存：置 true 后需开路电压连续回升到阈值 + 回差以上才解除（避免 ADC 电压波动导致忽高忽低）
 static bool lowBatteryLatched = false;
 static bool lowBatteryHandled = false; // 是否已执行过“强制待机/清队列/通知”动作
-static uint16_t latestBatteryVoltageMv = 0;
+static battery::State batteryState;
+static float jointLoadCurrentA = 0.0f; // 功率调节器由关节角速度估算的电流（主循环写入）
+static unsigned long jointLoadCurrentMs = 0;
+static powergovernor::Governor powerGovernor;
+static unsigned long lastGovernorExchangeMs = 0;
 static constexpr const char* kLowBatteryUiMessage = "电量低，请关闭电源后进行充电！";
 static constexpr const char* kLowBatteryProtectCode = "LOW_BATTERY_PROTECT";
 static unsigned long lastLowBatterySerialNotifyMs = 0;
@@ -103,8 +142,8 @@ void handleCalibrationData(AsyncWebServerRequest *request, uint8_t *data, size_t
 void handleCalibrationGet(AsyncWebServerRequest *request);
 void handleNotFound(AsyncWebServerRequest *request);
 void handleMotionPlanner(AsyncWebServerRequest *request);
-void sendHtmlFromSpiffs(AsyncWebServerRequest *request, const char *path);
-void sendFileFromSpiffs(AsyncWebServerRequest *request, const char *path, const char *contentType);
+void sendHtmlFromFs(AsyncWebServerRequest *request, const char *path);
+void sendFileFromFs(AsyncWebServerRequest *request, const char *path, const char *contentType);
 void onRobotCmdWebSocketEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len);
 void normal_loop();
 void setting_loop();
@@ -121,6 +160,18 @@ void handleApConfigReset(AsyncWebServerRequest *request);
 // 最小能力探测接口（仅返回机型与腿数）
 void handleCapsGet(AsyncWebServerRequest *request);
 
+// 运行时诊断接口（舵机写入统计等）
+void handleDiagGet(AsyncWebServerRequest *request);
+
+// 模式切换延迟（每个模式对从请求到过渡结束的时长）
+void handleTransitionsGet(AsyncWebServerRequest *request);
+void handleTransitionsReset(AsyncWebServerRequest *request);
+
+// 控制会话录制（下载后在主机上用 sim/replay.cpp 回放）
+void handleSessionGet(AsyncWebServerRequest *request);
+void handleSessionStart(AsyncWebServerRequest *request);
+void handleSessionStop(AsyncWebServerRequest *request);
+
 // 通用设置接口（用于承载未来更多配置项）
 void handleSettingsGet(AsyncWebServerRequest *request);
 void handleSettingsPostBody(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
@@ -131,11 +182,17 @@ void BatteryMonitorTask(void *pvParameters);
 void LEDControllerTask(void *pvParameters);
 
 // 串口通讯相关函数声明
-void parseSerialMovementCommand(const String& jsonString);
-void SerialCommandTask(void *pvParameters);
-void sendSerialResponse(const String& message);
+void parseSerialMovementCommand(char* frame, size_t length, jsonpool::Format format);
+void handleSerialFrame(char* frame, size_t length);
+void handleSerialPacket(const seriallink::Packet& packet);
+size_t fillSerialTelemetry(uint8_t* out, size_t capacity);
+static void sendSerialReply(JsonDocument& response);
+static void sendSerialError(const char* message);
+static void sendSerialEvent(const JsonDocument& event);
+static jsonpool::Format serialEventFormat();
 void testUART2Connection();
-void clearMovementFlag();
+void NetworkStartupTask(void *pvParameters);
+void startWebServer();
 static const char* motionButtonModeToString(devsettings::MotionButtonMode mode);
 static bool parseMotionButtonModeField(JsonVariantConst value, devsettings::MotionButtonMode& mode);
 
@@ -146,68 +203,137 @@ static void sendLowBatteryErrorToWebSocket(AsyncWebSocketClient *client);
 static void sendLowBatteryErrorToSerial();
 static void sendLowBatteryEventToSerial();
 static void maybeRepeatLowBatteryEventToSerial();
-static uint16_t getLatestBatteryVoltageMv();
-static uint8_t estimateBatteryPercent(uint16_t voltageMv);
-static bool shouldUseMovingLowBatteryThreshold();
-
-struct AdvancedCommandResult {
-  bool handled = false;
-  bool success = false;
-  bool suppressAck = false;
-  uint32_t sequenceId = 0;
-  String message;
-};
+static battery::State getBatteryState();
+static bool isMotionActive();
+static void configurePowerGovernor();
+static void updatePowerGovernor(int elapsedMs);
 
 static void handleSequenceComplete(uint32_t sequenceId);
-static AdvancedCommandResult handleAdvancedMotionCommand(JsonVariantConst json);
-static bool parseMovementModeField(JsonVariantConst value, hexapod::MovementMode& mode);
-static bool parsePerformanceKindField(JsonVariantConst value, performance::Kind& kind);
-static bool buildActionFromJson(JsonVariantConst obj, motion::Action& action, String& error);
-static bool hasActionParameters(JsonVariantConst json);
 
 void setup() {
   // 初始化串口
   Serial.begin(115200);
   Serial.println("Starting...");
-
-  // 初始化UART2用于接收运动指令
-  Serial2.begin(UART2_BAUD_RATE, SERIAL_8N1, 16, 17);  // RX=GPIO16, TX=GPIO17 (默认引脚)
-  Serial2.setTimeout(100);
-  Serial2.flush(); // 清空串口缓冲区
-  Serial.printf("UART2 initialized: %d baud (GPIO16-RX, GPIO17-TX)\n", UART2_BAUD_RATE);
+  bootprofile::mark(bootprofile::Phase::SerialReady);
 
   // 初始化电池监测相关硬件
   pinMode(BAT_ADC, INPUT);
   pinMode(BAT_LED, OUTPUT);
   voltageMutex = xSemaphoreCreateMutex();
-  flagMutex = xSemaphoreCreateMutex();
+  cmddispatch::begin();
+  sessionrec::begin();
 
   // 初始化I2C
   Wire.setPins(21, 22);
 
-  // 挂载SPIFFS文件系统
-  if (!SPIFFS.begin(true)) {
-      Serial.println("An Error has occurred while mounting SPIFFS");
-      return;
+  // 启动顺序：先让机器人站起来（只依赖文件系统中的校准数据），WiFi/Web 服务放到后台任务并行启动
+
+  // 挂载 LittleFS 文件系统（旧固件的 SPIFFS 分区在首次启动时迁移）
+  // 挂载失败时仍继续启动（使用默认校准参数站立），避免整机无响应
+  if (!storage::begin()) {
+      Serial.println("An Error has occurred while mounting LittleFS");
   }
+  bootprofile::mark(bootprofile::Phase::StorageMounted);
+
+  // 读取设备设置（NVS，低电量保护开关需在电池任务启动前就绪）
+  devsettings::init();
+  Serial.printf("Power: lowBatteryProtectionEnabled=%s\n", devsettings::isLowBatteryProtectionEnabled() ? "true" : "false");
+  configurePowerGovernor();
+  bootprofile::mark(bootprofile::Phase::SettingsLoaded);
+
+  // 初始化日志记录回调函数&机器人工作模式
+  hexapod::initLogOutput(log_output, millis);
+  if (hexapod::Robot) {
+    hexapod::Robot->init(_mode == 1);
+  }
+  bootprofile::mark(bootprofile::Phase::Standing);
+  motion::controller().begin();
+  performance::controller().begin();
+  singleleg::controller().begin();
+  motion::controller().setSequenceCallback(handleSequenceComplete);
+
+  // 创建电池监测任务
+  xTaskCreate(
+    BatteryMonitorTask,
+    "BatteryMonitor",
+    4096,
+    NULL,
+    1,
+    NULL
+  );
+
+  // 创建LED控制任务
+  xTaskCreate(
+    LEDControllerTask,
+    "LEDController",
+    4096,
+    NULL,
+    1,
+    NULL
+  );
+
+  // 初始化UART2指令链路（驱动事件唤醒接收任务，优先级2，确保串口数据及时处理）
+  if (seriallink::begin(UART2_BAUD_RATE, UART2_RX_PIN, UART2_TX_PIN, SERIAL_TIMEOUT, 2, handleSerialFrame)) {
+    Serial.printf("UART2 initialized: %d baud (GPIO%d-RX, GPIO%d-TX)\n", UART2_BAUD_RATE, UART2_RX_PIN, UART2_TX_PIN);
+  } else {
+    Serial.println("UART2 initialization failed");
+  }
+  seriallink::setPacketHandler(handleSerialPacket);
+  seriallink::setTelemetryProvider(fillSerialTelemetry);
+  bootprofile::mark(bootprofile::Phase::TasksStarted);
+
+  // 创建网络启动任务（WiFi AP + Web 服务，完成后自行删除）
+  xTaskCreate(
+    NetworkStartupTask,
+    "NetworkStartup",
+    8192,
+    NULL,
+    1,
+    NULL
+  );
+
+  printWelcomeMessage();
+
+  // 测试UART2连接
+  testUART2Connection();
+
+  Serial.print("Started, mode=");
+  Serial.println(_mode);
+  bootprofile::printSummary(Serial);
+}
+
+/* 网络启动任务：与站立姿态并行地启动 WiFi AP、注册路由并开始监听
+*/
+void NetworkStartupTask(void *pvParameters) {
+  webassets::init();
 
   // 初始化WiFi（动态 AP 配置）
   apconfig::init();
   apconfig::printCurrentAPInfo(Serial);
+  bootprofile::mark(bootprofile::Phase::WifiReady);
 
-  // 读取设备设置（NVS）
-  devsettings::init();
-  Serial.printf("Power: lowBatteryProtectionEnabled=%s\n", devsettings::isLowBatteryProtectionEnabled() ? "true" : "false");
+  startWebServer();
+  bootprofile::mark(bootprofile::Phase::WebReady);
+  bootprofile::printSummary(Serial);
+
+  vTaskDelete(NULL);
+}
 
+/* 注册 HTTP/WebSocket 路由并启动服务
+*/
+void startWebServer() {
   // 初始化Web服务
   server.on("/", HTTP_GET, handleRoot);
   server.on("/planner", HTTP_GET, handleMotionPlanner);
   server.on("/planner.html", HTTP_GET, handleMotionPlanner);
   server.on("/power_ui.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-    sendFileFromSpiffs(request, "/power_ui.js", "application/javascript; charset=utf-8");
+    sendFileFromFs(request, "/power_ui.js", "application/javascript; charset=utf-8");
   });
   server.on("/single_leg_panel.js", HTTP_GET, [](AsyncWebServerRequest *request) {
-    sendFileFromSpiffs(request, "/single_leg_panel.js", "application/javascript; charset=utf-8");
+    sendFileFromFs(request, "/single_leg_panel.js", "application/javascript; charset=utf-8");
+  });
+  server.on("/msgpack.js", HTTP_GET, [](AsyncWebServerRequest *request) {
+    sendFileFromFs(request, "/msgpack.js", "application/javascript; charset=utf-8");
   });
   server.on("/calibration", HTTP_GET, handleCalibrationPage);
   server.on("/calibration", HTTP_POST, 
@@ -235,6 +361,16 @@ void setup() {
   // UI 能力探测（用于校准页适配四足/六足）
   server.on("/api/caps", HTTP_GET, handleCapsGet);
 
+  // 运行时诊断（调试/性能评估用）
+  server.on("/api/diag", HTTP_GET, handleDiagGet);
+  server.on("/api/transitions/reset", HTTP_POST, handleTransitionsReset);
+  server.on("/api/transitions", HTTP_GET, handleTransitionsGet);
+
+  // 控制会话录制：开始（可选 ?seed=）/ 停止 / 下载
+  server.on("/api/session/start", HTTP_POST, handleSessionStart);
+  server.on("/api/session/stop", HTTP_POST, handleSessionStop);
+  server.on("/api/session", HTTP_GET, handleSessionGet);
+
   // 通用设置接口（承载 WiFi 之外的设置项）
   server.on("/api/settings", HTTP_GET, handleSettingsGet);
   server.on("/api/settings", HTTP_POST,
@@ -247,57 +383,12 @@ void setup() {
 
   server.begin();
   Serial.println("HTTP server started");
-
-  // 初始化日志记录回调函数&机器人工作模式
-  hexapod::initLogOutput(log_output, millis);
-  if (hexapod::Robot) {
-    hexapod::Robot->init(_mode == 1);
-  }
-  motion::controller().begin();
-  performance::controller().begin();
-  singleleg::controller().begin();
-  motion::controller().setSequenceCallback(handleSequenceComplete);
-
-  // 创建电池监测任务
-  xTaskCreate(
-    BatteryMonitorTask,
-    "BatteryMonitor",
-    4096,
-    NULL,
-    1,
-    NULL
-  );
-
-  // 创建LED控制任务
-  xTaskCreate(
-    LEDControllerTask,
-    "LEDController",
-    4096,
-    NULL,
-    1,
-    NULL
-  );
-
-  // 创建串口指令处理任务
-  xTaskCreate(
-    SerialCommandTask,
-    "SerialCommand",
-    4096,
-    NULL,
-    2,  // 提高优先级到2，确保串口数据及时处理
-    NULL
-  );
-
-  printWelcomeMessage();
-
-  // 测试UART2连接
-  testUART2Connection();
-
-  Serial.print("Started, mode=");
-  Serial.println(_mode);
 }
 
 void loop() {
+  // 补发因客户端队列已满而暂缓的事件
+  eventfanout::flushPending(wsRoverCmd);
+
   // 低电量锁存后：强制回到运动模式（standby），并屏蔽所有控制
   if (isLowBatteryLatched()) {
     if (_mode != 0) {
@@ -336,37 +427,16 @@ void normal_loop() {
   }
 
   auto t0 = millis();
+  sessionrec::onLoopTick();
 
   if (lowBattery) {
     if (hexapod::Robot) {
       hexapod::Robot->processMovement(hexapod::MOVEMENT_STANDBY, REACT_DELAY);
     }
     motion::controller().onLoopTick(hexapod::MOVEMENT_STANDBY, REACT_DELAY);
-  } else if (singleleg::controller().isActive()) {
-    singleleg::controller().onLoopTick(REACT_DELAY);
-  } else {
-    auto mode = hexapod::MOVEMENT_STANDBY;
-    if (motion::controller().hasActiveAction()) {
-      mode = motion::controller().activeMode();
-    } else {
-      if (xSemaphoreTake(flagMutex, portMAX_DELAY) == pdTRUE) {
-        for (auto m = hexapod::MOVEMENT_STANDBY; m < hexapod::MOVEMENT_TOTAL; m++) {
-          if (flag & (1<<m)) {
-            mode = m;
-            break;
-          }
-        }
-        xSemaphoreGive(flagMutex);
-      }
-    }
-
-    if (hexapod::Robot) {
-      hexapod::Robot->processMovement(mode, REACT_DELAY);
-    }
-    // 对四足：动作切换存在“等待 entry/对齐”的过渡期，此时实际执行 mode 可能不同。
-    // 为保证序列单位(cycles)的计时准确，应以“实际执行的 mode”来累计 completedCycles。
-    const auto executedMode = hexapod::Robot ? hexapod::Robot->executedMovementMode(mode) : mode;
-    motion::controller().onLoopTick(executedMode, REACT_DELAY);
+  } else if (cmddispatch::runTick(REACT_DELAY)) {
+    // 单腿控制 / 动作队列 / 运动标志的调度见 command_dispatch.cpp（主机回放执行同一段代码）
+    updatePowerGovernor(REACT_DELAY);
   }
 
   auto spent = millis() - t0;
@@ -388,9 +458,13 @@ void setting_loop() {
 
 /* HandleRoot
 */
-void sendFileFromSpiffs(AsyncWebServerRequest *request, const char *path, const char *contentType) {
-  if (SPIFFS.exists(path)) {
-    request->send(SPIFFS, path, contentType);
+void sendFileFromFs(AsyncWebServerRequest *request, const char *path, const char *contentType) {
+  // 优先发送构建时预压缩的 gzip 资源（带 ETag / 304），清单中没有时回退到原始文件
+  if (webassets::send(request, path, contentType)) {
+    return;
+  }
+  if (storage::exists(path)) {
+    request->send(storage::filesystem(), path, contentType);
   } else {
     String message = "File not found: ";
     message += path;
@@ -398,21 +472,21 @@ void sendFileFromSpiffs(AsyncWebServerRequest *request, const char *path, const
   }
 }
 
-void sendHtmlFromSpiffs(AsyncWebServerRequest *request, const char *path) {
+void sendHtmlFromFs(AsyncWebServerRequest *request, const char *path) {
   // 显式声明 UTF-8，避免不同浏览器对中文编码推断不一致导致乱码
-  sendFileFromSpiffs(request, path, "text/html; charset=utf-8");
+  sendFileFromFs(request, path, "text/html; charset=utf-8");
 }
 
 void handleRoot(AsyncWebServerRequest *request) {
     apconfig::autoConfirmIfPending();
-    sendHtmlFromSpiffs(request, "/web_controller.html");
+    sendHtmlFromFs(request, "/web_controller.html");
 }
 
 /* HandleCalibrationPage
 */
 void handleCalibrationPage(AsyncWebServerRequest *request) {
   apconfig::autoConfirmIfPending();
-  sendHtmlFromSpiffs(request, "/calibration.html");
+  sendHtmlFromFs(request, "/calibration.html");
 }
 
 /* handleCalibrationData
@@ -459,7 +533,12 @@ void handleCalibrationData(AsyncWebServerRequest *request, uint8_t *data, size_t
     if (_mode == 1) {
       if (hexapod::Robot) {
         hexapod::Robot->calibrationSet(calibrationData);
-        hexapod::Robot->calibrationTest(calibrationData.legIndex, calibrationData.partIndex, test_angle);
+        if (calibrationData.curvePoint >= 0) {
+          // 曲线锚点调整：转到该锚点对应角度，便于观察修正效果
+          hexapod::Robot->calibrationCurveTest(calibrationData.legIndex, calibrationData.partIndex, calibrationData.curvePoint);
+        } else {
+          hexapod::Robot->calibrationTest(calibrationData.legIndex, calibrationData.partIndex, test_angle);
+        }
       }
       request->send(200, "application/json", "{\"status\":\"success\"}");
     }
@@ -468,9 +547,9 @@ void handleCalibrationData(AsyncWebServerRequest *request, uint8_t *data, size_t
 
 /* 查询当前校准状态与偏移 */
 void handleCalibrationGet(AsyncWebServerRequest *request) {
-  StaticJsonDocument<1024> doc;
+  StaticJsonDocument<3072> doc;
 
-  bool exists = SPIFFS.exists(kCalibrationFilePath);
+  bool exists = storage::exists(kCalibrationFilePath);
   doc["exists"] = exists;
 
   JsonArray offsets = doc.createNestedArray("offsets");
@@ -486,6 +565,27 @@ void handleCalibrationGet(AsyncWebServerRequest *request) {
     }
   }
 
+  // 多点校准曲线：anchors 为锚点角度（舵机输出角），curves[leg][joint][point] 为各锚点修正量（us）
+  JsonArray anchors = doc.createNestedArray("curveAnchors");
+  for (int k = 0; k < hexapod::ServoCurve::kPointCount; k++) {
+    anchors.add(hexapod::ServoCurve::anchorAngle(k));
+  }
+  doc["curveLimitUs"] = hexapod::ServoCurve::kMaxCorrectionUs;
+  JsonArray curves = doc.createNestedArray("curves");
+  for (int i = 0; i < kRobotLegCount; i++) {
+    JsonArray leg = curves.createNestedArray();
+    for (int j = 0; j < 3; j++) {
+      JsonArray joint = leg.createNestedArray();
+      for (int k = 0; k < hexapod::ServoCurve::kPointCount; k++) {
+        int correction = 0;
+        if (hexapod::Robot) {
+          hexapod::Robot->calibrationCurveGet(i, j, k, correction);
+        }
+        joint.add(correction);
+      }
+    }
+  }
+
   String responseStr;
   serializeJson(doc, responseStr);
   request->send(200, "application/json", responseStr);
@@ -500,16 +600,25 @@ void handleCapsGet(AsyncWebServerRequest *request) {
   JsonObject power = doc.createNestedObject("power");
   power["lowBatteryLatched"] = isLowBatteryLatched();
   power["lowBatteryProtectionEnabled"] = devsettings::isLowBatteryProtectionEnabled();
-  const uint16_t voltageMv = getLatestBatteryVoltageMv();
-  power["voltageMv"] = voltageMv;
-  power["percentEstimate"] = estimateBatteryPercent(voltageMv);
+  const battery::State bat = getBatteryState();
+  power["voltageMv"] = bat.loadedMv;
+  power["openCircuitMv"] = bat.openCircuitMv;
+  power["percentEstimate"] = (uint8_t)(bat.socPercent + 0.5f);
+  power["runtimeMin"] = bat.runtimeSec / 60;
+  power["internalResistanceMohm"] = (uint16_t)(bat.resistanceOhm * 1000.0f + 0.5f);
+  power["loadCurrentMa"] = (uint16_t)(bat.currentA * 1000.0f + 0.5f);
   power["lowBatteryThresholdMv"] = (uint16_t)(LOW_VOLTAGE_WARNING_THRESHOLD * 1000.0f + 0.5f);
+  power["throttlePercent"] = powerGovernor.stats().throttlePercent;
 
   JsonObject performanceCaps = doc.createNestedObject("performance");
   performanceCaps["freestyle"] = performance::isSupported(performance::Kind::Freestyle);
   performanceCaps["beatsway"] = performance::isSupported(performance::Kind::BeatSway);
   performanceCaps["showtime"] = performance::isSupported(performance::Kind::Showtime);
 
+  JsonObject motionCaps = doc.createNestedObject("motion");
+  motionCaps["maxSequenceLength"] = motion::kMaxSequenceLength;
+  motionCaps["queueCapacity"] = motion::controller().capacity();
+
   JsonObject manualCaps = doc.createNestedObject("manual");
 #ifdef ROBOT_MODEL_NODEQUADMINI
   manualCaps["singleLeg"] = false;
@@ -522,6 +631,249 @@ void handleCapsGet(AsyncWebServerRequest *request) {
   request->send(200, "application/json", responseStr);
 }
 
+/* 运行时诊断：舵机 PWM 写入统计（脏标记跳过的写入量）、网页资源缓存命中、存储与启动耗时 */
+void handleDiagGet(AsyncWebServerRequest *request) {
+  StaticJsonDocument<2560> doc;
+
+  hexapod::hal::PwmWriteStats pwmStats;
+  hexapod::hal::getPwmWriteStats(pwmStats);
+  JsonObject servo = doc.createNestedObject("servo");
+  servo["writes"] = pwmStats.writes;
+  servo["skipped"] = pwmStats.skipped;
+  servo["writesPerSec"] = pwmStats.writesPerSec;
+  servo["skippedPerSec"] = pwmStats.skippedPerSec;
+
+  const webassets::Stats webStats = webassets::getStats();
+  JsonObject web = doc.createNestedObject("web");
+  web["gzipAssets"] = webassets::assetCount();
+  web["served"] = webStats.served;
+  web["notModified"] = webStats.notModified;
+  web["bytesSent"] = webStats.bytesSent;
+
+  const storage::Timings storageTimings = storage::getTimings();
+  JsonObject fsInfo = doc.createNestedObject("storage");
+  fsInfo["mountMs"] = storageTimings.mountMs;
+  fsInfo["migrated"] = storageTimings.migrated;
+  fsInfo["migrateSkipped"] = storageTimings.migrateSkipped;
+  fsInfo["lastReadUs"] = storageTimings.lastReadUs;
+  fsInfo["lastWriteUs"] = storageTimings.lastWriteUs;
+  fsInfo["writes"] = storageTimings.writes;
+  fsInfo["skippedWrites"] = storageTimings.skippedWrites;
+  fsInfo["crcErrors"] = storageTimings.crcErrors;
+
+  const seriallink::Stats uartStats = seriallink::getStats();
+  JsonObject uart = doc.createNestedObject("uart");
+  uart["frames"] = uartStats.frames;
+  uart["bytes"] = uartStats.bytes;
+  uart["frameOverflows"] = uartStats.frameOverflows;
+  uart["rxOverflows"] = uartStats.rxOverflows;
+  uart["timeouts"] = uartStats.timeouts;
+  uart["lastDispatchUs"] = uartStats.lastDispatchUs;
+  uart["maxDispatchUs"] = uartStats.maxDispatchUs;
+  uart["link"] = seriallink::mode() == seriallink::LinkMode::Binary ? "binary" : "text";
+  uart["baud"] = seriallink::baudRate();
+  uart["packets"] = uartStats.packets;
+  uart["badPackets"] = uartStats.badPackets;
+  uart["duplicates"] = uartStats.duplicates;
+  uart["seqGaps"] = uartStats.seqGaps;
+  uart["telemetrySent"] = uartStats.telemetrySent;
+
+  JsonObject jsonInfo = doc.createNestedObject("json");
+  static const char* const kJsonChannelNames[] = {"ws", "serial"};
+  for (uint8_t i = 0; i < static_cast<uint8_t>(jsonpool::Channel::Count); ++i) {
+    const jsonpool::Stats poolStats = jsonpool::getStats(static_cast<jsonpool::Channel>(i));
+    JsonObject channel = jsonInfo.createNestedObject(kJsonChannelNames[i]);
+    channel["commands"] = poolStats.commands;
+    channel["msgpackCommands"] = poolStats.msgpackCommands;
+    channel["replies"] = poolStats.replies;
+    channel["heapAllocs"] = poolStats.heapAllocs;
+    channel["overflows"] = poolStats.overflows;
+    channel["peakCommandBytes"] = poolStats.peakCommandBytes;
+    channel["peakReplyBytes"] = poolStats.peakReplyBytes;
+  }
+  const eventfanout::Stats fanoutStats = eventfanout::getStats();
+  JsonObject events = jsonInfo.createNestedObject("events");
+  events["published"] = fanoutStats.events;
+  events["serializations"] = fanoutStats.serializations;
+  events["delivered"] = fanoutStats.delivered;
+  events["deferred"] = fanoutStats.deferred;
+  events["coalesced"] = fanoutStats.coalesced;
+  events["dropped"] = fanoutStats.dropped;
+  events["pending"] = fanoutStats.pending;
+
+  const battery::State bat = getBatteryState();
+  JsonObject batteryInfo = doc.createNestedObject("battery");
+  batteryInfo["adcCalibration"] = batteryadc::calibrationSourceName();
+  batteryInfo["oversample"] = BATTERY_ADC_OVERSAMPLE;
+  batteryInfo["loadedMv"] = bat.loadedMv;
+  batteryInfo["openCircuitMv"] = bat.openCircuitMv;
+  batteryInfo["averageCurrentMa"] = (uint16_t)(bat.averageCurrentA * 1000.0f + 0.5f);
+
+  const powergovernor::Stats govStats = powerGovernor.stats();
+  const powergovernor::Limits govLimits = powerGovernor.limits();
+  JsonObject governor = doc.createNestedObject("governor");
+  governor["enabled"] = powerGovernor.config().enabled;
+  governor["floorMv"] = (uint16_t)(powerGovernor.config().floorVoltage * 1000.0f + 0.5f);
+  governor["engaged"] = govStats.engaged;
+  governor["throttlePercent"] = govStats.throttlePercent;
+  governor["speedScale"] = govLimits.speedScale;
+  governor["liftScale"] = govLimits.liftScale;
+  governor["currentMa"] = (uint16_t)(govStats.currentA * 1000.0f + 0.5f);
+  governor["budgetMa"] = (uint16_t)(govStats.budgetA > 60.0f ? 60000 : govStats.budgetA * 1000.0f + 0.5f);
+  governor["throttledMs"] = govStats.throttledMs;
+  governor["engageCount"] = govStats.engageCount;
+
+  // 静态稳定裕度（最近一次计算；触地腿少于 3 条时 valid=false）
+  if (hexapod::Robot) {
+    const stability::Stats stabStats = hexapod::Robot->stabilityStats();
+    JsonObject stab = doc.createNestedObject("stability");
+    stab["valid"] = stabStats.last.valid;
+    stab["contacts"] = stabStats.last.contacts;
+    stab["marginMm"] = stabStats.last.marginMm;
+    if (stabStats.minMarginValid) {
+      stab["minMarginMm"] = stabStats.minMarginMm;
+    }
+    stab["timeScale"] = stabStats.timeScale;
+    stab["slowedTicks"] = stabStats.slowedTicks;
+    stab["pauses"] = stabStats.pauses;
+  }
+
+  const sessionrec::Stats sessionStats = sessionrec::getStats();
+  JsonObject session = doc.createNestedObject("session");
+  session["recording"] = sessionStats.recording;
+  session["commands"] = sessionStats.commands;
+  session["dropped"] = sessionStats.droppedCommands;
+  session["bytes"] = sessionStats.bytes;
+  session["ticks"] = sessionStats.ticks;
+  if (rng::isSeeded()) {
+    session["rngSeed"] = rng::lastSeed();
+  }
+
+  // 启动阶段耗时（距上电毫秒数，未到达的阶段不输出）
+  JsonObject boot = doc.createNestedObject("boot");
+  for (uint8_t i = 0; i < static_cast<uint8_t>(bootprofile::Phase::Count); ++i) {
+    const bootprofile::Phase phase = static_cast<bootprofile::Phase>(i);
+    if (bootprofile::isMarked(phase)) {
+      boot[bootprofile::phaseName(phase)] = bootprofile::elapsedMs(phase);
+    }
+  }
+
+  String responseStr;
+  serializeJson(doc, responseStr);
+  request->send(200, "application/json", responseStr);
+}
+
+/* 模式切换延迟：只列出出现过的模式对与步态；模式对最多 MOVEMENT_TOTAL^2 个，逐条写入响应流而不是先拼成 JSON 文档 */
+void handleTransitionsGet(AsyncWebServerRequest *request) {
+#ifdef ROBOT_MODEL_NODEQUADMINI
+  const float* limits = hexapod::config::quadJointSpeedLimitDegPerSec;
+#else
+  const float* limits = hexapod::config::jointSpeedLimitDegPerSec;
+#endif
+  AsyncResponseStream *response = request->beginResponseStream("application/json");
+  response->printf("{\"jointSpeedLimitDegPerSec\":[%g,%g,%g],\"pairs\":[", limits[0], limits[1], limits[2]);
+  bool first = true;
+  for (auto from = hexapod::MOVEMENT_STANDBY; from < hexapod::MOVEMENT_TOTAL; from++) {
+    for (auto to = hexapod::MOVEMENT_STANDBY; to < hexapod::MOVEMENT_TOTAL; to++) {
+      transition::PairStats stats;
+      if (!transition::pairStats(from, to, stats)) {
+        continue;
+      }
+      response->printf("%s{\"from\":\"%s\",\"to\":\"%s\",\"count\":%u,\"interrupted\":%u,"
+                       "\"lastMs\":%u,\"minMs\":%u,\"maxMs\":%u,\"avgMs\":%u}",
+                       first ? "" : ",", cmdkeys::movementModeName(from), cmdkeys::movementModeName(to),
+                       stats.count, stats.interrupted, stats.lastMs, stats.minMs, stats.maxMs,
+                       stats.count > 0 ? stats.totalMs / stats.count : 0);
+      first = false;
+    }
+  }
+  // 按步态汇总（gait 与 getGaitMode() 相同：四足 0=trot 1=walk 2=gallop 3=creep，六足只有 0）
+  response->print("],\"gaits\":[");
+  first = true;
+  for (int gait = 0; gait < transition::kMaxGaits; ++gait) {
+    transition::PairStats stats;
+    if (!transition::gaitStats(gait, stats)) {
+      continue;
+    }
+    response->printf("%s{\"gait\":%d,\"count\":%u,\"interrupted\":%u,\"minMs\":%u,\"maxMs\":%u,\"avgMs\":%u}",
+                     first ? "" : ",", gait, stats.count, stats.interrupted, stats.minMs, stats.maxMs,
+                     stats.count > 0 ? stats.totalMs / stats.count : 0);
+    first = false;
+  }
+  response->print("]}");
+  request->send(response);
+}
+
+void handleTransitionsReset(AsyncWebServerRequest *request) {
+  transition::resetStats();
+  request->send(200, "application/json", "{\"status\":\"success\"}");
+}
+
+static void sendSessionStatus(AsyncWebServerRequest *request, int code, const char* status, const char* message) {
+  const sessionrec::Stats stats = sessionrec::getStats();
+  StaticJsonDocument<256> doc;
+  doc["status"] = status;
+  doc["message"] = message;
+  doc["recording"] = stats.recording;
+  doc["commands"] = stats.commands;
+  doc["dropped"] = stats.droppedCommands;
+  doc["ticks"] = stats.ticks;
+  String responseStr;
+  serializeJson(doc, responseStr);
+  request->send(code, "application/json", responseStr);
+}
+
+/* 开始录制：要求机器人待机且没有动作/表演/单腿控制在执行，回放从同一个初始状态出发 */
+void handleSessionStart(AsyncWebServerRequest *request) {
+  const bool idle = hexapod::Robot
+      && hexapod::Robot->executedMovementMode(hexapod::MOVEMENT_STANDBY) == hexapod::MOVEMENT_STANDBY
+      && !hexapod::Robot->isTransitioning()
+      && !isMotionActive()
+      && !motion::controller().hasActiveAction()
+      && !isLowBatteryLatched();
+  if (!idle) {
+    sendSessionStatus(request, 409, "error", "recording must start in standby");
+    return;
+  }
+
+  sessionrec::Header header;
+  header.model = kSessionModel;
+  header.gaitMode = static_cast<uint8_t>(hexapod::Robot->getGaitMode());
+  header.flags = hexapod::Robot->isAutoGait() ? sessionrec::kFlagAutoGait : 0;
+  header.speed = hexapod::Robot->getMovementSpeed();
+  header.tickMs = REACT_DELAY;
+  header.seed = request->hasParam("seed") ? strtoul(request->getParam("seed")->value().c_str(), nullptr, 0) : micros();
+  String error;
+  if (!sessionrec::start(header, error)) {
+    sendSessionStatus(request, 500, "error", error.c_str());
+    return;
+  }
+  rng::seedAll(header.seed);
+  Serial.printf("[Session] recording started, seed=%u\n", header.seed);
+  sendSessionStatus(request, 200, "success", "recording started");
+}
+
+void handleSessionStop(AsyncWebServerRequest *request) {
+  sessionrec::stop();
+  sendSessionStatus(request, 200, "success", "recording stopped");
+}
+
+/* 下载录制内容（二进制，格式见 session_recorder.h）；录制中也可下载，内容截止到请求时刻 */
+void handleSessionGet(AsyncWebServerRequest *request) {
+  sessionrec::Header header;
+  const size_t total = sessionrec::snapshot(header);
+  if (total == 0) {
+    sendSessionStatus(request, 404, "error", "no recording");
+    return;
+  }
+  AsyncWebServerResponse *response = request->beginResponse("application/octet-stream", total,
+      [header, total](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        return sessionrec::read(header, total, index, buffer, maxLen);
+      });
+  response->addHeader("Content-Disposition", "attachment; filename=\"session.nhsr\"");
+  request->send(response);
+}
+
 static String* appendRequestBodyChunk(AsyncWebServerRequest *request,
                                       const uint8_t *data,
                                       size_t len,
@@ -571,7 +923,7 @@ void handleNotFound(AsyncWebServerRequest *request) {
 }
 
 void handleMotionPlanner(AsyncWebServerRequest *request) {
-  sendHtmlFromSpiffs(request, "/motion_planner.html");
+  sendHtmlFromFs(request, "/motion_planner.html");
 }
 
 /* AP 配置接口处理
@@ -704,13 +1056,16 @@ void handleApConfigReset(AsyncWebServerRequest *request) {
 
 /* 通用设置接口：GET/POST /api/settings
  * - GET: 返回当前设置
- * - POST: 允许更新已支持的 power/motion 设置
+ * - POST: 允许更新已支持的 power/motion 设置（power 下各字段可单独提交）
  */
 void handleSettingsGet(AsyncWebServerRequest *request) {
   StaticJsonDocument<256> json;
   json["status"] = "success";
+  const devsettings::PowerSettings powerSettings = devsettings::getPowerSettings();
   JsonObject power = json.createNestedObject("power");
-  power["lowBatteryProtectionEnabled"] = devsettings::isLowBatteryProtectionEnabled();
+  power["lowBatteryProtectionEnabled"] = powerSettings.lowBatteryProtectionEnabled;
+  power["governorEnabled"] = powerSettings.governorEnabled;
+  power["governorFloorMv"] = powerSettings.governorFloorMv;
   JsonObject motion = json.createNestedObject("motion");
   motion["buttonMode"] = motionButtonModeToString(devsettings::getMotionButtonMode());
   String response;
@@ -740,19 +1095,36 @@ void handleSettingsPostBody(AsyncWebServerRequest *request, uint8_t *data, size_
   }
 
   bool hasPowerUpdate = false;
+  bool hasGovernorUpdate = false;
   bool powerEnabled = devsettings::isLowBatteryProtectionEnabled();
+  devsettings::PowerSettings governorSettings = devsettings::getPowerSettings();
   if (hasPowerObject) {
     if (!doc["power"].is<JsonObjectConst>()) {
       request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid payload: power must be an object\"}");
       return;
     }
     JsonObjectConst p = doc["power"].as<JsonObjectConst>();
-    if (!p.containsKey("lowBatteryProtectionEnabled")) {
-      request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid payload: missing power.lowBatteryProtectionEnabled\"}");
+    if (p.containsKey("lowBatteryProtectionEnabled")) {
+      powerEnabled = p["lowBatteryProtectionEnabled"].as<bool>();
+      hasPowerUpdate = true;
+    }
+    if (p.containsKey("governorEnabled")) {
+      governorSettings.governorEnabled = p["governorEnabled"].as<bool>();
+      hasGovernorUpdate = true;
+    }
+    if (p.containsKey("governorFloorMv")) {
+      const long floorMv = p["governorFloorMv"].is<long>() ? p["governorFloorMv"].as<long>() : -1;
+      if (floorMv < devsettings::kGovernorFloorMinMv || floorMv > devsettings::kGovernorFloorMaxMv) {
+        request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid payload: power.governorFloorMv must be 6600-8000\"}");
+        return;
+      }
+      governorSettings.governorFloorMv = static_cast<uint16_t>(floorMv);
+      hasGovernorUpdate = true;
+    }
+    if (!hasPowerUpdate && !hasGovernorUpdate) {
+      request->send(400, "application/json", "{\"status\":\"error\",\"message\":\"Invalid payload: missing power.lowBatteryProtectionEnabled/governorEnabled/governorFloorMv\"}");
       return;
     }
-    powerEnabled = p["lowBatteryProtectionEnabled"].as<bool>();
-    hasPowerUpdate = true;
   }
 
   bool hasMotionUpdate = false;
@@ -783,6 +1155,13 @@ void handleSettingsPostBody(AsyncWebServerRequest *request, uint8_t *data, size_
     }
   }
 
+  if (hasGovernorUpdate) {
+    if (!devsettings::setGovernor(governorSettings.governorEnabled, governorSettings.governorFloorMv)) {
+      request->send(500, "application/json", "{\"status\":\"error\",\"message\":\"Failed to persist power settings\"}");
+      return;
+    }
+  }
+
   if (hasMotionUpdate) {
     if (!devsettings::setMotionButtonMode(buttonMode)) {
       request->send(500, "application/json", "{\"status\":\"error\",\"message\":\"Failed to persist motion settings\"}");
@@ -792,8 +1171,11 @@ void handleSettingsPostBody(AsyncWebServerRequest *request, uint8_t *data, size_
 
   StaticJsonDocument<256> resp;
   resp["status"] = "success";
+  const devsettings::PowerSettings powerSettings = devsettings::getPowerSettings();
   JsonObject power = resp.createNestedObject("power");
-  power["lowBatteryProtectionEnabled"] = devsettings::isLowBatteryProtectionEnabled();
+  power["lowBatteryProtectionEnabled"] = powerSettings.lowBatteryProtectionEnabled;
+  power["governorEnabled"] = powerSettings.governorEnabled;
+  power["governorFloorMv"] = powerSettings.governorFloorMv;
   JsonObject motion = resp.createNestedObject("motion");
   motion["buttonMode"] = motionButtonModeToString(devsettings::getMotionButtonMode());
   String response;
@@ -812,33 +1194,37 @@ void onRobotCmdWebSocketEvent(AsyncWebSocket *server,
   switch (type) {
     case WS_EVT_CONNECT:
       Serial.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
+      if (!bootprofile::isMarked(bootprofile::Phase::FirstWebSocket)) {
+        bootprofile::mark(bootprofile::Phase::FirstWebSocket);
+        bootprofile::printSummary(Serial);
+      }
       break;
     case WS_EVT_DISCONNECT:
       Serial.printf("WebSocket client #%u disconnected\n", client->id());
       // 使用短超时时间获取锁
-      if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        flag = 0;  
-        xSemaphoreGive(flagMutex);
-      }
+      cmddispatch::tryClearMovementFlag(10);
       singleleg::controller().stop("[SingleLeg] websocket disconnected");
       break;
     case WS_EVT_DATA:
       AwsFrameInfo *info;
       info = (AwsFrameInfo*)arg;
-      if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
-        // 为了支持包含 sequence 数组的高级运动指令，将文档容量从 128 增大，并显式传入长度
-        StaticJsonDocument<1024> json;
-        DeserializationError err = deserializeJson(json, data, len);
+      if (info->final && info->index == 0 && info->len == len
+          && (info->opcode == WS_TEXT || info->opcode == WS_BINARY)) {
+        // 在接收缓冲上零拷贝解析，指令/应答文档为 WebSocket 通道复用的静态实例（见 json_pool.h）；
+        // 二进制帧为同一结构的 MessagePack，应答与事件也以二进制帧回送给该客户端
+        const jsonpool::Format format = info->opcode == WS_BINARY ? jsonpool::Format::MsgPack : jsonpool::Format::Json;
+        sessionrec::record(sessionrec::Source::WebSocket, static_cast<uint8_t>(format), data, len);
+        DeserializationError err = jsonpool::parse(jsonpool::Channel::WebSocket, reinterpret_cast<char*>(data), len, format);
+        JsonDocument& json = jsonpool::command(jsonpool::Channel::WebSocket);
+        jsonpool::setClientFormat(client, format);
         if (err) {
-          Serial.print(F("deserializeJson() failed with code: "));
+          Serial.print(F("deserialize failed with code: "));
           Serial.println(err.c_str());
           if (client) {
-            StaticJsonDocument<160> ack;
+            JsonDocument& ack = jsonpool::reply(jsonpool::Channel::WebSocket);
             ack["status"] = "error";
-            ack["message"] = "Invalid JSON format";
-            String payload;
-            serializeJson(ack, payload);
-            client->text(payload);
+            ack["message"] = format == jsonpool::Format::MsgPack ? "Invalid MessagePack format" : "Invalid JSON format";
+            jsonpool::sendReply(client, ack);
           }
           return;
         }
@@ -848,12 +1234,14 @@ void onRobotCmdWebSocketEvent(AsyncWebSocket *server,
           motion::controller().clear("[Power] low battery, command ignored");
           performance::controller().clear("[Power] low battery, command ignored");
           singleleg::controller().stop("[Power] low battery, single leg ignored");
-          clearMovementFlag();
+          cmddispatch::clearMovementFlag();
           sendLowBatteryErrorToWebSocket(client);
           return;
         }
 
-        AdvancedCommandResult adv = handleAdvancedMotionCommand(json.as<JsonVariantConst>());
+        // 单遍收集字段，后续按 Key 直接取值（见 command_keys.h）
+        const cmdkeys::Fields fields(json.as<JsonObjectConst>());
+        const cmddispatch::AdvancedResult adv = cmddispatch::handleAdvanced(fields);
         if (adv.handled) {
           if (!adv.suppressAck) {
             if (adv.success) {
@@ -863,48 +1251,35 @@ void onRobotCmdWebSocketEvent(AsyncWebSocket *server,
             }
           }
           if (!adv.suppressAck && client) {
-            StaticJsonDocument<160> ack;
+            JsonDocument& ack = jsonpool::reply(jsonpool::Channel::WebSocket);
             ack["status"] = adv.success ? "success" : "error";
-            ack["message"] = adv.message;
+            ack["message"] = adv.message.c_str();
             if (adv.sequenceId) {
               ack["sequenceId"] = adv.sequenceId;
             }
-            String payload;
-            serializeJson(ack, payload);
-            client->text(payload);
+            jsonpool::sendReply(client, ack);
           }
           return;
         }
 
-        if (json.containsKey("movementMode")) {
-          if (singleleg::controller().isActive()) {
-            singleleg::controller().stop("[SingleLeg] overridden by movementMode");
-          }
-          int16_t movementMode = json["movementMode"];
-
-          if (performance::controller().isActive()) {
-            motion::controller().clear("[Performance] overridden by movementMode");
-            performance::controller().clear("[Performance] overridden by movementMode");
-          }
-
-          // 使用短超时时间获取锁
-          if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-            if (flag != movementMode) {
-              flag = movementMode; 
-              Serial.printf("Receive Movement Command Flag: %d\n", movementMode);
-            }
-            xSemaphoreGive(flagMutex);
-          } else {
+        if (fields.has(cmdkeys::Key::MovementMode)) {
+          int16_t movementMode = fields[cmdkeys::Key::MovementMode];
+          const cmddispatch::MovementResult result = cmddispatch::applyMovementMode(movementMode, "WebSocket");
+          if (result == cmddispatch::MovementResult::Busy) {
             Serial.println("WebSocket: Failed to acquire flag lock, command ignored");
-            if (client) {
-              client->text("{\"status\":\"error\",\"message\":\"System busy, command ignored\"}");
-            }
+          }
+          if ((result == cmddispatch::MovementResult::Busy || result == cmddispatch::MovementResult::Invalid) && client) {
+            JsonDocument& ack = jsonpool::reply(jsonpool::Channel::WebSocket);
+            ack["status"] = "error";
+            ack["message"] = result == cmddispatch::MovementResult::Busy
+                ? "System busy, command ignored" : "Invalid movement mode";
+            jsonpool::sendReply(client, ack);
           }
         }
         
         // Handle speed control
-        if (json.containsKey("speed")) {
-          float speed = json["speed"];
+        if (fields.has(cmdkeys::Key::Speed)) {
+          float speed = fields[cmdkeys::Key::Speed];
           if (hexapod::Robot) {
             hexapod::Robot->setMovementSpeed(speed);
           }
@@ -912,8 +1287,8 @@ void onRobotCmdWebSocketEvent(AsyncWebSocket *server,
         }
         
         // Handle speed level control
-        if (json.containsKey("speedLevel")) {
-          int level = json["speedLevel"];
+        if (fields.has(cmdkeys::Key::SpeedLevel)) {
+          int level = fields[cmdkeys::Key::SpeedLevel];
           if (level >= hexapod::SPEED_SLOWEST && level <= hexapod::SPEED_FAST) {
             if (hexapod::Robot) {
               hexapod::Robot->setMovementSpeedLevel((hexapod::SpeedLevel)level);
@@ -925,8 +1300,8 @@ void onRobotCmdWebSocketEvent(AsyncWebSocket *server,
         }
 
         // Handle gait mode control (可选字段，六足实现会忽略)
-        if (json.containsKey("gaitMode")) {
-          int gaitMode = json["gaitMode"];
+        if (fields.has(cmdkeys::Key::GaitMode)) {
+          int gaitMode = fields[cmdkeys::Key::GaitMode];
           if (hexapod::Robot) {
             hexapod::Robot->setGaitMode(gaitMode);
           }
@@ -946,8 +1321,11 @@ void onRobotCmdWebSocketEvent(AsyncWebSocket *server,
 */
 CalibrationData parseCalibrationData(const String& jsonString) {
   // {"legIndex": 0, "partIndex": 0, "offset": 0}
+  // {"legIndex": 0, "partIndex": 0, "curvePoint": 1, "curveValue": -12}
 
   CalibrationData data;
+  data.curvePoint = -1;
+  data.curveValue = 0;
 
   StaticJsonDocument<200> doc;
   DeserializationError error = deserializeJson(doc, jsonString);
@@ -964,6 +1342,10 @@ CalibrationData parseCalibrationData(const String& jsonString) {
     data.legIndex = doc["legIndex"];
     data.partIndex = doc["partIndex"];
     data.offset = doc["offset"];
+    if (doc.containsKey("curvePoint")) {
+      data.curvePoint = doc["curvePoint"];
+      data.curveValue = doc["curveValue"];
+    }
   } else {
     data.operation = doc["operation"].as<String>();
   }
@@ -973,43 +1355,53 @@ CalibrationData parseCalibrationData(const String& jsonString) {
 
 // 电池监测任务
 void BatteryMonitorTask(void *pvParameters) {
-  const uint8_t SAMPLE_SIZE = 10;
-  uint16_t adcReadings[SAMPLE_SIZE] = {0};
-  uint8_t readIndex = 0;
-  uint32_t adcSum = 0;
-  uint8_t actualSampleCount = 0;  // 实际采集的样本数量
+  battery::Config config;
+  config.cellCount = BATTERY_CELL_COUNT;
+  config.capacityAh = BATTERY_CAPACITY_MAH / 1000.0f;
+  config.idleCurrentA = SERVO_IDLE_CURRENT_A;
+  config.activeCurrentA = SERVO_ACTIVE_CURRENT_A;
+  battery::Estimator estimator(config);
+
+  if (!batteryadc::begin(BAT_ADC)) {
+    Serial.println("[Power] BAT_ADC is not an ADC1 pin, battery monitor disabled");
+    vTaskDelete(NULL);
+    return;
+  }
+  Serial.printf("[Power] Battery ADC calibration: %s\n", batteryadc::calibrationSourceName());
+
+  const uint16_t latchThresholdMv = (uint16_t)(LOW_VOLTAGE_LATCH_THRESHOLD * 1000.0f + 0.5f);
+  const uint16_t releaseThresholdMv = (uint16_t)((LOW_VOLTAGE_LATCH_THRESHOLD + LOW_BATTERY_RELEASE_HYSTERESIS) * 1000.0f + 0.5f);
+  const uint16_t hardFloorMv = (uint16_t)(LOW_VOLTAGE_HARD_FLOOR * 1000.0f + 0.5f);
   uint8_t consecutiveLowCount = 0;
+  uint8_t consecutiveRecoveredCount = 0;
+  uint32_t lastSampleMs = millis();
 
   while(1) {
-    // 采集ADC值并做移动平均滤波
-    if (actualSampleCount < SAMPLE_SIZE) {
-      // 采样初期，直接累加
-      adcReadings[actualSampleCount] = analogRead(BAT_ADC);
-      adcSum += adcReadings[actualSampleCount];
-      actualSampleCount++;
-    } else {
-      // 采样数量达到设定值后，使用移动平均
-      adcSum -= adcReadings[readIndex];
-      adcReadings[readIndex] = analogRead(BAT_ADC);
-      adcSum += adcReadings[readIndex];
-      readIndex = (readIndex + 1) % SAMPLE_SIZE;
-    }
+    // 过采样 + eFuse 校准后的引脚电压，按分压比换算为电池端电压
+    const uint32_t pinMv = batteryadc::readPinMv(BATTERY_ADC_OVERSAMPLE);
+    const float voltage = pinMv / 1000.0f * BATTERY_DIVIDER_RATIO * BATTERY_VOLTAGE_GAIN;
 
-    uint16_t adcAverage = adcSum / actualSampleCount;
-    const uint16_t rawAdc = adcReadings[actualSampleCount < SAMPLE_SIZE ? actualSampleCount - 1 : readIndex == 0 ? SAMPLE_SIZE - 1 : readIndex - 1];
+    // 负载电流用于 IR 压降补偿：步态运行时取功率调节器按关节角速度估算的电流，
+    // 单腿控制/校准等不经过步态的状态按运动状态估算
+    const uint32_t now = millis();
+    xSemaphoreTake(voltageMutex, portMAX_DELAY);
+    const float jointCurrent = jointLoadCurrentA;
+    const unsigned long jointCurrentMs = jointLoadCurrentMs;
+    xSemaphoreGive(voltageMutex);
+    const bool moving = isMotionActive();
+    const bool jointCurrentFresh = jointCurrentMs != 0 && now - jointCurrentMs < JOINT_CURRENT_STALE_MS;
+    const float speed = hexapod::Robot ? hexapod::Robot->getMovementSpeed() : 1.0f;
+    const float loadCurrent = jointCurrentFresh ? jointCurrent : battery::estimateLoadCurrent(config, moving, speed);
 
-    // 计算实际电压值 (V)
-    float voltage = (float)adcAverage * 3.3f / 4095.0f * (100.0f + 47.0f) / 47.0f;
-    voltage *= BATTERY_VOLTAGE_GAIN;
+    const battery::State state = estimator.update(voltage, loadCurrent, (now - lastSampleMs) / 1000.0f);
+    lastSampleMs = now;
 
-    const uint16_t voltageMv = (uint16_t)(voltage * 1000.0f + 0.5f);
-    const bool useMovingThreshold = shouldUseMovingLowBatteryThreshold();
-    const float latchThreshold = useMovingThreshold ? LOW_VOLTAGE_LATCH_THRESHOLD_MOVING : LOW_VOLTAGE_LATCH_THRESHOLD_STANDBY;
-    const uint16_t latchThresholdMv = (uint16_t)(latchThreshold * 1000.0f + 0.5f);
-    const bool isLow = (voltageMv <= latchThresholdMv);
+    // 开路电压判断电量；带载电压低于硬下限时无论补偿结果如何都视为低压
+    const bool isLow = state.openCircuitMv <= latchThresholdMv || state.loadedMv <= hardFloorMv;
+    const bool isRecovered = state.openCircuitMv >= releaseThresholdMv && state.loadedMv > hardFloorMv;
 
     xSemaphoreTake(voltageMutex, portMAX_DELAY);
-    latestBatteryVoltageMv = voltageMv;
+    batteryState = state;
 
     if (isLow) {
       if (consecutiveLowCount < LOW_BATTERY_LATCH_CONSECUTIVE_SAMPLES) {
@@ -1018,8 +1410,15 @@ void BatteryMonitorTask(void *pvParameters) {
     } else {
       consecutiveLowCount = 0;
     }
+    if (isRecovered) {
+      if (consecutiveRecoveredCount < LOW_BATTERY_RELEASE_SAMPLES) {
+        consecutiveRecoveredCount++;
+      }
+    } else {
+      consecutiveRecoveredCount = 0;
+    }
 
-    // 低电量锁存：连续低压达到阈值后锁存，直到重启恢复
+    // 低电量锁存：连续低压达到阈值后锁存；开路电压连续回升到阈值 + 回差以上后解除（充电/更换电池）
     if (consecutiveLowCount >= LOW_BATTERY_LATCH_CONSECUTIVE_SAMPLES && !lowBatteryLatched) {
       lowBatteryLatched = true;
       lowBatteryHandled = false; // 允许主循环执行一次强制待机/通知
@@ -1027,24 +1426,35 @@ void BatteryMonitorTask(void *pvParameters) {
       #ifdef DEBUG_ADC_MONITOR
       Serial.println("WARNING: Low voltage detected! (latched)");
       #endif
+    } else if (consecutiveRecoveredCount >= LOW_BATTERY_RELEASE_SAMPLES && lowBatteryLatched) {
+      lowBatteryLatched = false;
+      lowBatteryHandled = false;
+
+      #ifdef DEBUG_ADC_MONITOR
+      Serial.println("Battery voltage recovered, low battery latch released");
+      #endif
     }
     const bool latchedNow = lowBatteryLatched;
     const bool handledNow = lowBatteryHandled;
     xSemaphoreGive(voltageMutex);
 
     #ifdef DEBUG_ADC_MONITOR
-    Serial.printf("ADC Debug - Raw: %u, Avg: %u, Samples: %u, Voltage: %.2fV (%umV), Warning: %.2fV, Latch: %.2fV [%s], LowNow: %s, LowCount: %u/%u, Latched: %s, Handled: %s\n",
-                  rawAdc,
-                  adcAverage,
-                  actualSampleCount,
-                  voltage,
-                  voltageMv,
-                  LOW_VOLTAGE_WARNING_THRESHOLD,
-                  latchThreshold,
-                  useMovingThreshold ? "moving" : "standby",
+    Serial.printf("ADC Debug - Pin: %umV [%s], Loaded: %umV, OCV: %umV, I: %.2fA (%s%s), R: %.0fmOhm, SoC: %.1f%%, Runtime: %umin, LowNow: %s, LowCount: %u/%u, Recovered: %u/%u, Latched: %s, Handled: %s\n",
+                  (unsigned)pinMv,
+                  batteryadc::calibrationSourceName(),
+                  state.loadedMv,
+                  state.openCircuitMv,
+                  state.currentA,
+                  moving ? "moving" : "standby",
+                  jointCurrentFresh ? ", joints" : "",
+                  state.resistanceOhm * 1000.0f,
+                  state.socPercent,
+                  (unsigned)(state.runtimeSec / 60),
                   isLow ? "yes" : "no",
                   consecutiveLowCount,
                   LOW_BATTERY_LATCH_CONSECUTIVE_SAMPLES,
+                  consecutiveRecoveredCount,
+                  LOW_BATTERY_RELEASE_SAMPLES,
                   latchedNow ? "yes" : "no",
                   handledNow ? "yes" : "no");
     #endif
@@ -1078,9 +1488,9 @@ void LEDControllerTask(void *pvParameters) {
   }
 }
 
-// 打印欢迎语（用于确认SPIFFS文件系统正常工作）
+// 打印欢迎语（用于确认文件系统正常工作）
 void printWelcomeMessage() {
-  File file = SPIFFS.open("/text.txt");
+  File file = storage::filesystem().open("/text.txt");
   if(!file){
     Serial.println("Failed to open file for reading");
     return;
@@ -1093,13 +1503,6 @@ void printWelcomeMessage() {
   file.close();
 }
 
-void clearMovementFlag() {
-  if (xSemaphoreTake(flagMutex, portMAX_DELAY) == pdTRUE) {
-    flag = 0;
-    xSemaphoreGive(flagMutex);
-  }
-}
-
 static bool isLowBatteryLatched() {
   const bool protectEnabled = devsettings::isLowBatteryProtectionEnabled();
   if (!protectEnabled) {
@@ -1116,72 +1519,91 @@ static bool isLowBatteryLatched() {
   return value;
 }
 
-static uint16_t getLatestBatteryVoltageMv() {
+static battery::State getBatteryState() {
   if (!voltageMutex) {
-    return latestBatteryVoltageMv;
+    return batteryState;
   }
-  uint16_t value = latestBatteryVoltageMv;
+  battery::State value = batteryState;
   if (xSemaphoreTake(voltageMutex, pdMS_TO_TICKS(5)) == pdTRUE) {
-    value = latestBatteryVoltageMv;
+    value = batteryState;
     xSemaphoreGive(voltageMutex);
   }
   return value;
 }
 
-static bool shouldUseMovingLowBatteryThreshold() {
-  // 校准模式下机器人不应按“运动中压降”放宽阈值，仍按待机/静止逻辑处理。
+static bool isMotionActive() {
+  // 校准模式下舵机只保持姿态，按待机电流估算。
   if (_mode == 1) {
     return false;
   }
 
+  if (performance::controller().isActive() || singleleg::controller().isActive()) {
+    return true;
+  }
+
   if (motion::controller().hasActiveAction()) {
     return motion::controller().activeMode() != hexapod::MOVEMENT_STANDBY;
   }
 
-  bool moving = false;
-  if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(5)) == pdTRUE) {
-    for (auto m = hexapod::MOVEMENT_FORWARD; m < hexapod::MOVEMENT_TOTAL; m++) {
-      if (flag & (1 << m)) {
-        moving = true;
-        break;
-      }
+  return cmddispatch::hasMotionFlag(5);
+}
+
+static void configurePowerGovernor() {
+  powergovernor::Config config;
+  config.idleCurrentA = SERVO_IDLE_CURRENT_A;
+  config.stanceAmpsPerDegS = SERVO_STANCE_AMPS_PER_DEG_S;
+  config.swingAmpsPerDegS = SERVO_SWING_AMPS_PER_DEG_S;
+  const devsettings::PowerSettings settings = devsettings::getPowerSettings();
+  config.enabled = settings.governorEnabled;
+  config.floorVoltage = settings.governorFloorMv / 1000.0f;
+  powerGovernor.setConfig(config);
+}
+
+/* 功率调节：由本周期的关节运动估算电流，按电池余量限制步态推进速度与抬腿高度（下一周期生效） */
+static void updatePowerGovernor(int elapsedMs) {
+  const hexapod::JointTravel travel = hexapod::Robot->lastJointTravel();
+  const bool wasEngaged = powerGovernor.stats().engaged;
+  const powergovernor::Limits& limits = powerGovernor.update(travel.stanceDeg, travel.swingDeg, elapsedMs);
+  hexapod::Robot->setPowerLimits(limits.speedScale, limits.liftScale);
+
+  const unsigned long now = millis();
+  if (now - lastGovernorExchangeMs >= POWER_GOVERNOR_EXCHANGE_INTERVAL_MS) {
+    lastGovernorExchangeMs = now;
+    // 与电池任务交换：取电池估计，回写关节电流估计（供 IR 补偿）；设置可能已被 /api/settings 修改
+    if (voltageMutex && xSemaphoreTake(voltageMutex, pdMS_TO_TICKS(5)) == pdTRUE) {
+      const battery::State bat = batteryState;
+      jointLoadCurrentA = powerGovernor.currentA();
+      jointLoadCurrentMs = now;
+      xSemaphoreGive(voltageMutex);
+      powerGovernor.setBattery(bat.openCircuitMv / 1000.0f, bat.resistanceOhm, bat.valid);
     }
-    xSemaphoreGive(flagMutex);
+    const devsettings::PowerSettings settings = devsettings::getPowerSettings();
+    powerGovernor.setEnabled(settings.governorEnabled);
+    powerGovernor.setFloorVoltage(settings.governorFloorMv / 1000.0f);
   }
-  return moving;
-}
 
-static uint8_t estimateBatteryPercent(uint16_t voltageMv) {
-  if (voltageMv >= 8300) return 100;
-  if (voltageMv >= 8100) return 85;
-  if (voltageMv >= 7900) return 70;
-  if (voltageMv >= 7700) return 55;
-  if (voltageMv >= 7500) return 40;
-  if (voltageMv >= 7300) return 25;
-  if (voltageMv >= 7200) return 10;
-  return 0;
+  const powergovernor::Stats stats = powerGovernor.stats();
+  if (stats.engaged != wasEngaged) {
+    Serial.printf("[Power] Governor %s: speed x%.2f, lift x%.2f, current %.2fA, budget %.2fA\n",
+                  stats.engaged ? "throttling" : "released", limits.speedScale, limits.liftScale,
+                  stats.currentA, stats.budgetA);
+  }
 }
 
 static void sendLowBatteryErrorToWebSocket(AsyncWebSocketClient *client) {
-  StaticJsonDocument<160> ack;
+  JsonDocument& ack = jsonpool::reply(jsonpool::Channel::WebSocket);
   ack["status"] = "error";
   ack["code"] = kLowBatteryProtectCode;
   ack["message"] = kLowBatteryUiMessage;
-  String payload;
-  serializeJson(ack, payload);
-  if (client) {
-    client->text(payload);
-  }
+  jsonpool::sendReply(client, ack);
 }
 
 static void sendLowBatteryErrorToSerial() {
-  StaticJsonDocument<160> ack;
+  JsonDocument& ack = jsonpool::reply(jsonpool::Channel::Serial);
   ack["status"] = "error";
   ack["code"] = kLowBatteryProtectCode;
   ack["message"] = kLowBatteryUiMessage;
-  String payload;
-  serializeJson(ack, payload);
-  sendSerialResponse(payload);
+  sendSerialReply(ack);
 }
 
 static void sendLowBatteryEventToSerial() {
@@ -1190,9 +1612,7 @@ static void sendLowBatteryEventToSerial() {
   doc["code"] = kLowBatteryProtectCode;
   doc["message"] = kLowBatteryUiMessage;
 
-  String payload;
-  serializeJson(doc, payload);
-  sendSerialResponse(payload);
+  sendSerialEvent(doc);
   lastLowBatterySerialNotifyMs = millis();
 }
 
@@ -1229,19 +1649,18 @@ static void handleLowBatteryLatchedOnce() {
   motion::controller().clear("[Power] low battery, force standby");
   performance::controller().clear("[Power] low battery, clear performance");
   singleleg::controller().stop("[Power] low battery, clear single leg");
-  clearMovementFlag();
+  cmddispatch::clearMovementFlag();
+  // 低电量后指令被屏蔽，设备行为不再由录制的指令决定
+  sessionrec::stop();
 
   StaticJsonDocument<192> doc;
   doc["event"] = "lowBattery";
   doc["code"] = kLowBatteryProtectCode;
   doc["message"] = kLowBatteryUiMessage;
 
-  String payload;
-  serializeJson(doc, payload);
-
-  // 主动广播给所有 WebSocket 客户端，串口单独走可重发提醒逻辑
-  wsRoverCmd.textAll(payload);
-  sendLowBatteryEventToSerial();
+  // 主动推送给所有 WebSocket 客户端（按各自格式）与串口，串口的重复提醒由 maybeRepeatLowBatteryEventToSerial 负责
+  eventfanout::publish(wsRoverCmd, doc, eventfanout::Slot::LowBattery, seriallink::sendJson, serialEventFormat());
+  lastLowBatterySerialNotifyMs = millis();
 
   Serial.println("[Power] Low battery latched: force standby and block commands.");
 }
@@ -1285,394 +1704,68 @@ static void handleSequenceComplete(uint32_t sequenceId) {
   doc["event"] = "sequenceComplete";
   doc["sequenceId"] = sequenceId;
 
-  String payload;
-  serializeJson(doc, payload);
-
-  sendSerialResponse(payload);
-  wsRoverCmd.textAll(payload);
+  eventfanout::publish(wsRoverCmd, doc, eventfanout::Slot::SequenceComplete, seriallink::sendJson, serialEventFormat());
   Serial.printf("[MotionController] Sequence %u completed\n", sequenceId);
   performance::controller().onSequenceComplete(sequenceId);
 }
 
-struct ModeNameEntry {
-  const char* name;
-  hexapod::MovementMode mode;
-};
-
-static bool parseMovementModeField(JsonVariantConst value, hexapod::MovementMode& mode) {
-  if (value.isNull()) {
-    return false;
-  }
-
-  if (value.is<int>()) {
-    int raw = value.as<int>();
-    if (raw >= 0 && raw < hexapod::MOVEMENT_TOTAL) {
-      mode = static_cast<hexapod::MovementMode>(raw);
-      return true;
-    }
-    for (int i = 0; i < hexapod::MOVEMENT_TOTAL; ++i) {
-      if (raw & (1 << i)) {
-        mode = static_cast<hexapod::MovementMode>(i);
-        return true;
-      }
-    }
-    return false;
-  }
-
-  if (value.is<const char*>()) {
-    static constexpr ModeNameEntry kModeNames[] = {
-      {"standby", hexapod::MOVEMENT_STANDBY},
-      {"forward", hexapod::MOVEMENT_FORWARD},
-      {"forwardfast", hexapod::MOVEMENT_FORWARDFAST},
-      {"forward_fast", hexapod::MOVEMENT_FORWARDFAST},
-      {"backward", hexapod::MOVEMENT_BACKWARD},
-      {"turnleft", hexapod::MOVEMENT_TURNLEFT},
-      {"turn_left", hexapod::MOVEMENT_TURNLEFT},
-      {"turnright", hexapod::MOVEMENT_TURNRIGHT},
-      {"turn_right", hexapod::MOVEMENT_TURNRIGHT},
-      {"shiftleft", hexapod::MOVEMENT_SHIFTLEFT},
-      {"shift_left", hexapod::MOVEMENT_SHIFTLEFT},
-      {"shiftright", hexapod::MOVEMENT_SHIFTRIGHT},
-      {"shift_right", hexapod::MOVEMENT_SHIFTRIGHT},
-      {"climb", hexapod::MOVEMENT_CLIMB},
-      {"rotatex", hexapod::MOVEMENT_ROTATEX},
-      {"rotate_x", hexapod::MOVEMENT_ROTATEX},
-      {"rotatey", hexapod::MOVEMENT_ROTATEY},
-      {"rotate_y", hexapod::MOVEMENT_ROTATEY},
-      {"rotatez", hexapod::MOVEMENT_ROTATEZ},
-      {"rotate_z", hexapod::MOVEMENT_ROTATEZ},
-      {"twist", hexapod::MOVEMENT_TWIST},
-      {"beatsway", hexapod::MOVEMENT_BEATSWAY},
-      {"beat_sway", hexapod::MOVEMENT_BEATSWAY},
-    };
-    String lower = value.as<const char*>();
-    lower.toLowerCase();
-    for (auto entry : kModeNames) {
-      if (lower == entry.name) {
-        mode = entry.mode;
-        return true;
-      }
-    }
-  }
-
-  return false;
-}
-
-static bool parsePerformanceKindField(JsonVariantConst value, performance::Kind& kind) {
-  if (value.isNull() || !value.is<const char*>()) {
-    return false;
-  }
-
-  String lower = value.as<const char*>();
-  lower.toLowerCase();
-  if (lower == "freestyle") {
-    kind = performance::Kind::Freestyle;
-    return true;
-  }
-  if (lower == "beatsway" || lower == "beat_sway") {
-    kind = performance::Kind::BeatSway;
-    return true;
-  }
-  if (lower == "showtime") {
-    kind = performance::Kind::Showtime;
-    return true;
-  }
-  return false;
-}
-
-static bool buildActionFromJson(JsonVariantConst obj, motion::Action& action, String& error) {
-  JsonVariantConst modeField = obj["movementMode"];
-  if (modeField.isNull()) {
-    modeField = obj["mode"];
-  }
-  if (!parseMovementModeField(modeField, action.mode)) {
-    error = "movementMode missing or invalid";
-    return false;
-  }
-
-  if (obj.containsKey("speedOverride")) {
-    action.speed = obj["speedOverride"].as<float>();
-  }
-
-  if (obj.containsKey("durationMs")) {
-    error = "durationMs is not supported (use cycles/steps/distance/angle)";
-    return false;
-  }
-
-  if (obj.containsKey("cycles")) {
-    action.unit = motion::Unit::Cycles;
-    action.value = obj["cycles"].as<float>();
-  } else if (obj.containsKey("steps")) {
-    action.unit = motion::Unit::Steps;
-    action.value = obj["steps"].as<float>();
-  } else if (obj.containsKey("distance")) {
-    action.unit = motion::Unit::Distance;
-    action.value = obj["distance"].as<float>();
-  } else if (obj.containsKey("angle")) {
-    action.unit = motion::Unit::Angle;
-    action.value = obj["angle"].as<float>();
-  } else {
-    error = "missing cycles/steps/distance/angle";
-    return false;
-  }
-
-  if (action.value <= 0.0f) {
-    error = "value must be positive";
-    return false;
-  }
-  return true;
-}
-
-static bool hasActionParameters(JsonVariantConst json) {
-  return json.containsKey("cycles")
-      || json.containsKey("steps")
-      || json.containsKey("distance")
-      || json.containsKey("angle");
-}
-
-static AdvancedCommandResult handleAdvancedMotionCommand(JsonVariantConst json) {
-  AdvancedCommandResult result;
-
-  if (json.containsKey("stop") && json["stop"].as<bool>()) {
-    result.handled = true;
-    motion::controller().clear("[Motion] stop command");
-    performance::controller().clear("[Motion] stop command");
-    singleleg::controller().stop("[SingleLeg] stop command");
-    clearMovementFlag();
-    result.success = true;
-    result.message = "Motion stopped";
-    return result;
-  }
-
-  if (json.containsKey("clearQueue") && json["clearQueue"].as<bool>()) {
-    result.handled = true;
-    motion::controller().clear("[Motion] queue cleared");
-    performance::controller().clear("[Motion] queue cleared");
-    singleleg::controller().stop("[SingleLeg] queue cleared");
-    result.success = true;
-    result.message = "Queue cleared";
-    return result;
-  }
-
-  if (json.containsKey("singleLeg")) {
-    result.handled = true;
-
-    JsonObjectConst singleLeg = json["singleLeg"].as<JsonObjectConst>();
-    if (singleLeg.isNull()) {
-      result.success = false;
-      result.message = "singleLeg must be an object";
-      return result;
-    }
-
-    String op = singleLeg["op"] | "";
-    op.toLowerCase();
-
-    if (op == "start") {
-      const int legIndex = singleLeg["legIndex"] | -1;
-      if (legIndex < 0 || legIndex >= 6) {
-        result.success = false;
-        result.message = "invalid leg index";
-        return result;
-      }
-
-      motion::controller().clear("[SingleLeg] start override");
-      performance::controller().clear("[SingleLeg] start override");
-      clearMovementFlag();
-      singleleg::controller().stop("[SingleLeg] restart");
-
-      String error;
-      if (!singleleg::controller().start(static_cast<uint8_t>(legIndex), error)) {
-        result.success = false;
-        result.message = error;
-        return result;
-      }
-
-      result.success = true;
-      result.message = "single leg control started";
-      return result;
-    }
-
-    if (op == "input") {
-      if (!singleleg::controller().isActive()) {
-        result.success = false;
-        result.message = "single leg control not active";
-        return result;
-      }
-
-      singleleg::InputAxes axes;
-      axes.lx = singleLeg["lx"] | 0.0f;
-      axes.ly = singleLeg["ly"] | 0.0f;
-      axes.rz = singleLeg["rz"] | 0.0f;
-      singleleg::controller().updateInput(axes);
-
-      result.success = true;
-      result.suppressAck = true;
-      result.message = "single leg input accepted";
-      return result;
-    }
-
-    if (op == "stop") {
-      singleleg::controller().stop("[SingleLeg] stop command");
-      result.success = true;
-      result.message = "single leg control stopped";
-      return result;
-    }
-
-    result.success = false;
-    result.message = "unsupported singleLeg operation";
-    return result;
-  }
-
-  if (json.containsKey("performance")) {
-    result.handled = true;
-    if (singleleg::controller().isActive()) {
-      singleleg::controller().stop("[SingleLeg] overridden by performance");
-    }
-    performance::Kind kind;
-    if (!parsePerformanceKindField(json["performance"], kind)) {
-      result.success = false;
-      result.message = "unsupported performance";
-      return result;
-    }
-
-    const bool repeat = json["repeat"] | false;
-    const uint32_t requestedSequenceId = json["sequenceId"] | 0U;
-    String error;
-    uint32_t acceptedSequenceId = 0;
-    if (!performance::controller().start(kind, repeat, requestedSequenceId, error, acceptedSequenceId)) {
-      result.success = false;
-      result.message = error;
-      return result;
-    }
-
-    clearMovementFlag();
-    result.success = true;
-    result.sequenceId = acceptedSequenceId;
-    result.message = "performance accepted";
-    return result;
-  }
-
-  if (json.containsKey("sequence")) {
-    result.handled = true;
-    if (singleleg::controller().isActive()) {
-      singleleg::controller().stop("[SingleLeg] overridden by sequence");
-    }
-    performance::controller().clear("[Performance] overridden by sequence");
-    JsonArrayConst seq = json["sequence"].as<JsonArrayConst>();
-    if (seq.isNull() || seq.size() == 0 || seq.size() > 5) {
-      result.success = false;
-      result.message = "sequence size must be 1-5";
-      return result;
-    }
-
-    bool append = json["append"] | false;
-    uint32_t seqId = json["sequenceId"] | (uint32_t)millis();
-    motion::Action actions[5];
-    for (size_t i = 0; i < seq.size(); ++i) {
-      String err;
-      if (!buildActionFromJson(seq[i], actions[i], err)) {
-        result.success = false;
-        result.message = err;
-        return result;
-      }
-      actions[i].sequenceId = seqId;
-      actions[i].sequenceTail = (i == seq.size() - 1);
-    }
-
-    if (!append) {
-      motion::controller().clear("[Motion] sequence override");
-    }
-
-    if (!motion::controller().enqueueSequence(actions, seq.size())) {
-      result.success = false;
-      result.message = "queue full";
-      return result;
-    }
-
-    clearMovementFlag();
-    result.success = true;
-    result.sequenceId = seqId;
-    result.message = "sequence accepted";
-    return result;
-  }
-
-  if (hasActionParameters(json)) {
-    result.handled = true;
-    if (singleleg::controller().isActive()) {
-      singleleg::controller().stop("[SingleLeg] overridden by single action");
-    }
-    performance::controller().clear("[Performance] overridden by single action");
-    motion::Action action;
-    String error;
-    if (!buildActionFromJson(json, action, error)) {
-      result.success = false;
-      result.message = error;
-      return result;
-    }
-
-    if (json.containsKey("sequenceId")) {
-      action.sequenceId = json["sequenceId"].as<uint32_t>();
-      action.sequenceTail = true;
-    }
-
-    bool append = json["append"] | false;
-    if (!append) {
-      motion::controller().clear("[Motion] single action override");
-    }
-
-    if (!motion::controller().enqueue(action)) {
-      result.success = false;
-      result.message = "queue full";
-      return result;
-    }
-
-    clearMovementFlag();
-    result.success = true;
-    result.sequenceId = action.sequenceId;
-    result.message = "action accepted";
-    return result;
-  }
-
-  return result;
-}
-
 
 /* 解析串口运动指令
 */
-void parseSerialMovementCommand(const String& jsonString) {
-  StaticJsonDocument<512> json;
-  DeserializationError err = deserializeJson(json, jsonString);
+void parseSerialMovementCommand(char* frame, size_t length, jsonpool::Format format) {
+  // 直接在帧缓冲上解析（可写 char*，字符串不拷贝进文档），文档与应答缓冲为串口通道复用的静态实例；
+  // 应答使用与指令相同的格式。录制要在解析之前，解析会改写帧缓冲
+  sessionrec::record(sessionrec::Source::Serial, static_cast<uint8_t>(format), frame, length);
+  DeserializationError err = jsonpool::parse(jsonpool::Channel::Serial, frame, length, format);
+  JsonDocument& json = jsonpool::command(jsonpool::Channel::Serial);
   
   if (err) {
-    Serial.print(F("Serial deserializeJson() failed with code: "));
+    Serial.print(F("Serial deserialize failed with code: "));
     Serial.println(err.c_str());
     // 发送错误响应
-    sendSerialResponse("{\"status\":\"error\",\"message\":\"Invalid JSON format\"}");
+    sendSerialError(format == jsonpool::Format::MsgPack ? "Invalid MessagePack format" : "Invalid JSON format");
+    return;
+  }
+
+  // 单遍收集字段，后续按 Key 直接取值（见 command_keys.h）
+  const cmdkeys::Fields fields(json.as<JsonObjectConst>());
+
+  // 链路协商：{"link":"binary","baud":921600}，应答发出后切换到二进制帧（低电量时也允许）
+  if (fields.has(cmdkeys::Key::Link)) {
+    const char* link = fields[cmdkeys::Key::Link] | "";
+    const uint32_t baud = fields[cmdkeys::Key::Baud] | seriallink::baudRate();
+    const bool toBinary = strcmp(link, "binary") == 0;
+    if ((!toBinary && strcmp(link, "text") != 0) || !seriallink::isSupportedBaud(baud)) {
+      sendSerialError("Unsupported link or baud");
+      return;
+    }
+    JsonDocument& response = jsonpool::reply(jsonpool::Channel::Serial);
+    response["status"] = "success";
+    response["link"] = toBinary ? "binary" : "text";
+    response["baud"] = baud;
+    response["version"] = seriallink::kProtocolVersion;
+    sendSerialReply(response);
+    seriallink::requestMode(toBinary ? seriallink::LinkMode::Binary : seriallink::LinkMode::Text, baud);
     return;
   }
 
   // 低电量锁存后：屏蔽所有控制指令（包括运动模式/速度/步态/序列）
   if (isLowBatteryLatched()) {
-    motion::controller().clear("[Power] low battery, command ignored");
-    performance::controller().clear("[Power] low battery, command ignored");
-    singleleg::controller().stop("[Power] low battery, single leg ignored");
-    clearMovementFlag();
+    cmddispatch::stopAll("[Power] low battery, command ignored");
     sendLowBatteryErrorToSerial();
     return;
   }
 
-  AdvancedCommandResult adv = handleAdvancedMotionCommand(json.as<JsonVariantConst>());
+  const cmddispatch::AdvancedResult adv = cmddispatch::handleAdvanced(fields);
   if (adv.handled) {
     if (!adv.suppressAck) {
-      StaticJsonDocument<192> response;
+      JsonDocument& response = jsonpool::reply(jsonpool::Channel::Serial);
       response["status"] = adv.success ? "success" : "error";
-      response["message"] = adv.message;
+      response["message"] = adv.message.c_str();
       if (adv.sequenceId) {
         response["sequenceId"] = adv.sequenceId;
       }
-      String payload;
-      serializeJson(response, payload);
-      sendSerialResponse(payload);
+      sendSerialReply(response);
     }
     return;
   }
@@ -1680,104 +1773,75 @@ void parseSerialMovementCommand(const String& jsonString) {
   bool hasValidCommand = false;
 
   // 检查是否包含movementMode字段
-  if (json.containsKey("movementMode")) {
-    if (singleleg::controller().isActive()) {
-      singleleg::controller().stop("[SingleLeg] overridden by movementMode");
-    }
+  if (fields.has(cmdkeys::Key::MovementMode)) {
     hasValidCommand = true;
-    int16_t movementMode = json["movementMode"];
-
-    if (performance::controller().isActive()) {
-      motion::controller().clear("[Performance] overridden by movementMode");
-      performance::controller().clear("[Performance] overridden by movementMode");
-    }
-    
-    // 验证运动模式范围
-    // if (movementMode >= 0 && movementMode < hexapod::MOVEMENT_TOTAL) {
-    if (movementMode >= 0) {
-      // 使用短超时时间获取锁，避免长时间等待
-      if (xSemaphoreTake(flagMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        if (flag != movementMode) {
-          flag = movementMode;
-          Serial.printf("UART2: Receive Movement Command Flag: %d\n", movementMode);
-          
-          // 发送成功响应
-          StaticJsonDocument<128> response;
-          response["status"] = "success";
-          response["movementMode"] = movementMode;
-          response["message"] = "Movement command executed";
-          
-          String responseStr;
-          serializeJson(response, responseStr);
-          sendSerialResponse(responseStr);
-        } else {
-          // 发送重复指令响应
-          StaticJsonDocument<128> response;
-          response["status"] = "success";
-          response["movementMode"] = movementMode;
-          response["message"] = "Movement mode already set";
-          
-          String responseStr;
-          serializeJson(response, responseStr);
-          sendSerialResponse(responseStr);
-        }
-        xSemaphoreGive(flagMutex);
-      } else {
-        Serial.println("UART2: Failed to acquire flag lock, command ignored");
-        sendSerialResponse("{\"status\":\"error\",\"message\":\"System busy, command ignored\"}");
+    int16_t movementMode = fields[cmdkeys::Key::MovementMode];
+
+    const cmddispatch::MovementResult result = cmddispatch::applyMovementMode(movementMode, "UART2");
+    switch (result) {
+      case cmddispatch::MovementResult::Changed:
+      case cmddispatch::MovementResult::Unchanged: {
+        JsonDocument& response = jsonpool::reply(jsonpool::Channel::Serial);
+        response["status"] = "success";
+        response["movementMode"] = movementMode;
+        response["message"] = result == cmddispatch::MovementResult::Changed
+            ? "Movement command executed" : "Movement mode already set";
+        sendSerialReply(response);
+        break;
       }
-    } else {
-      sendSerialResponse("{\"status\":\"error\",\"message\":\"Invalid movement mode\"}");
+      case cmddispatch::MovementResult::Busy:
+        Serial.println("UART2: Failed to acquire flag lock, command ignored");
+        sendSerialError("System busy, command ignored");
+        break;
+      case cmddispatch::MovementResult::Invalid:
+        sendSerialError("Invalid movement mode");
+        break;
     }
   }
   
   // Handle speed control
-  if (json.containsKey("speed")) {
+  if (fields.has(cmdkeys::Key::Speed)) {
     hasValidCommand = true;
-    float speed = json["speed"];
+    float speed = fields[cmdkeys::Key::Speed];
     if (hexapod::Robot) {
       hexapod::Robot->setMovementSpeed(speed);
     }
     Serial.printf("UART2: Speed set to %.2f\n", speed);
     
-    StaticJsonDocument<128> response;
+    JsonDocument& response = jsonpool::reply(jsonpool::Channel::Serial);
     response["status"] = "success";
     response["speed"] = hexapod::Robot ? hexapod::Robot->getMovementSpeed() : 0.0f;
     response["message"] = "Speed updated";
     
-    String responseStr;
-    serializeJson(response, responseStr);
-    sendSerialResponse(responseStr);
+    sendSerialReply(response);
   }
   
   // Handle speed level control
-  if (json.containsKey("speedLevel")) {
+  if (fields.has(cmdkeys::Key::SpeedLevel)) {
     hasValidCommand = true;
-    int level = json["speedLevel"];
+    int level = fields[cmdkeys::Key::SpeedLevel];
     if (level >= hexapod::SPEED_SLOWEST && level <= hexapod::SPEED_FAST) {
       if (hexapod::Robot) {
         hexapod::Robot->setMovementSpeedLevel((hexapod::SpeedLevel)level);
       }
       Serial.printf("UART2: Speed level set to %d\n", level);
       
-      StaticJsonDocument<128> response;
+      JsonDocument& response = jsonpool::reply(jsonpool::Channel::Serial);
       response["status"] = "success";
       response["speedLevel"] = level;
       response["speed"] = hexapod::Robot ? hexapod::Robot->getMovementSpeed() : 0.0f;
       response["message"] = "Speed level updated";
       
-      String responseStr;
-      serializeJson(response, responseStr);
-      sendSerialResponse(responseStr);
+      sendSerialReply(response);
     } else {
-      sendSerialResponse("{\"status\":\"error\",\"message\":\"Invalid speed level\"}");
+      sendSerialError("Invalid speed level");
     }
   }
 
   // Handle gait mode control (可选字段，六足实现会忽略)
-  if (json.containsKey("gaitMode")) {
+  if (fields.has(cmdkeys::Key::GaitMode)) {
     hasValidCommand = true;
-    int gaitMode = json["gaitMode"];
+    int gaitMode = fields[cmdkeys::Key::GaitMode];
     if (hexapod::Robot) {
       hexapod::Robot->setGaitMode(gaitMode);
     }
@@ -1786,116 +1850,153 @@ void parseSerialMovementCommand(const String& jsonString) {
   
   if (!hasValidCommand) {
     // 如果不是有效的指令格式，发送错误响应
-    sendSerialResponse("{\"status\":\"error\",\"message\":\"No valid command field found\"}");
+    sendSerialError("No valid command field found");
   }
 }
 
-/* 串口指令处理任务
+/* 串口帧处理（在 SerialLink 任务中调用，frame 为接收缓冲内的完整一帧）
 */
-void SerialCommandTask(void *pvParameters) {
-  Serial.println("SerialCommandTask started - waiting for UART2 data...");
-  
-  // 初始化串口缓冲区状态
-  serialBuffer = "";
-  frameStarted = false;
-  lastSerialDataTime = 0;
-  
-  while(1) {
-    // 检查UART2是否有可用数据
-    while (Serial2.available()) {
-      char c = Serial2.read();
-      lastSerialDataTime = millis();
-      
-      // 调试输出：显示接收到的字符
-      #ifdef DEBUG_FRAME_RECEIVE
-      Serial.printf("UART2 received char: '%c' (0x%02X)\n", c, c);
-      #endif
-      
-      // 帧接收状态机
-      if (!frameStarted) {
-        // 等待起始符$
-        if (c == '$') {
-          frameStarted = true;
-          serialBuffer = "";  // 清空缓冲区，准备接收新帧
-          #ifdef DEBUG_FRAME_RECEIVE
-          Serial.println("Frame start detected: $");
-          #endif
-        }
-        // 其他字符都丢弃
-      } else {
-        // 正在接收数据帧
-        if (c == '\n' || c == '\r') {
-          // 帧结束，处理接收到的数据
-          if (serialBuffer.length() > 0) {
-            Serial.printf("Serial2 received complete frame: [%s]\n", serialBuffer.c_str());
-            
-            // 检查是否是简单测试消息
-            if (serialBuffer == "Hello from NodeMCU!") {
-              Serial.println("Received test message from NodeMCU!");
-              Serial2.println("Hello back from Hexapod!");
-              Serial.println("Test response sent via UART2");
-            } else {
-              // 解析串口指令
-              parseSerialMovementCommand(serialBuffer);
-            }
-          }
-          
-          // 重置帧接收状态
-          frameStarted = false;
-          serialBuffer = "";
-        } else {
-          // 将字符添加到缓冲区
-          serialBuffer += c;
-        }
+void handleSerialFrame(char* frame, size_t length) {
+  #ifdef DEBUG_FRAME_RECEIVE
+  Serial.printf("Serial2 received complete frame: [%s]\n", frame);
+  #endif
+
+  // 检查是否是简单测试消息
+  if (strcmp(frame, "Hello from NodeMCU!") == 0) {
+    Serial.println("Received test message from NodeMCU!");
+    static const char kReply[] = "Hello back from Hexapod!\r\n";
+    seriallink::write(kReply, sizeof(kReply) - 1);
+    Serial.println("Test response sent via UART2");
+    return;
+  }
+
+  // 解析串口指令（文本链路以换行分帧，只承载 JSON）
+  parseSerialMovementCommand(frame, length, jsonpool::Format::Json);
+}
+
+/* 二进制链路指令处理（在 SerialLink 任务中调用）
+*/
+void handleSerialPacket(const seriallink::Packet& packet) {
+  switch (packet.id) {
+    case seriallink::MessageId::JsonCommand:
+      // 与文本链路相同的指令集（JSON 或 MessagePack，按首字节识别），应答以 JsonResponse 按同一格式回送
+      parseSerialMovementCommand(reinterpret_cast<char*>(packet.payload), packet.payloadLength,
+                                 jsonpool::detectFormat(packet.payload, packet.payloadLength));
+      return;
+
+    case seriallink::MessageId::SetMovement: {
+      if (packet.payloadLength != 2 && packet.payloadLength != 6) {
+        seriallink::sendAck(packet, seriallink::AckStatus::Invalid);
+        return;
       }
+      sessionrec::record(sessionrec::Source::SerialPacket, static_cast<uint8_t>(packet.id),
+                         packet.payload, packet.payloadLength);
+      if (isLowBatteryLatched()) {
+        cmddispatch::stopAll("[Power] low battery, command ignored");
+        seriallink::sendAck(packet, seriallink::AckStatus::LowBattery);
+        return;
+      }
+      int16_t movementMode;
+      memcpy(&movementMode, packet.payload, sizeof(movementMode));
+      const cmddispatch::MovementResult result = cmddispatch::applyMovementMode(movementMode, "UART2");
+      if (result == cmddispatch::MovementResult::Busy || result == cmddispatch::MovementResult::Invalid) {
+        seriallink::sendAck(packet, result == cmddispatch::MovementResult::Busy
+            ? seriallink::AckStatus::Busy : seriallink::AckStatus::Invalid);
+        return;
+      }
+      if (packet.payloadLength == 6 && hexapod::Robot) {
+        float speed;
+        memcpy(&speed, packet.payload + 2, sizeof(speed));
+        hexapod::Robot->setMovementSpeed(speed);
+      }
+      seriallink::sendAck(packet, seriallink::AckStatus::Ok);
+      return;
     }
-    
-    // 检查串口数据超时，防止缓冲区溢出
-    if (serialBuffer.length() > 0 && (millis() - lastSerialDataTime) > SERIAL_TIMEOUT) {
-      Serial.printf("Serial2 timeout, received: [%s]\n", serialBuffer.c_str());
-      Serial.println("Serial2 command timeout, clearing buffer");
-      serialBuffer = "";
-      frameStarted = false;  // 超时时也重置帧状态
-    }
-    
-    // 减少任务延时，提高响应速度
-    vTaskDelay(pdMS_TO_TICKS(10));  // 10ms延时，100Hz处理频率，提高响应速度
+
+    case seriallink::MessageId::Stop:
+      sessionrec::record(sessionrec::Source::SerialPacket, static_cast<uint8_t>(packet.id), packet.payload, 0);
+      cmddispatch::stopAll("[SerialLink] stop");
+      seriallink::sendAck(packet, seriallink::AckStatus::Ok);
+      return;
+
+    default:
+      seriallink::sendAck(packet, seriallink::AckStatus::Unsupported);
+      return;
   }
 }
 
-/* 发送串口响应
+/* 二进制链路遥测内容（小端，共 14 字节）：
+   [uptimeMs:u32][batteryMv:u16][movementMode:i16][speed:f32][flags:u8][motionFreeSlots:u8]
+   flags: bit0 低电量锁存, bit1 动作队列执行中, bit2 表演执行中, bit3 单腿控制中
 */
-void sendSerialResponse(const String& message) {
-  // 通过UART2发送响应，保持与接收格式一致
-  Serial2.print("$");
-  Serial2.println(message);
-  
-  // 同时在调试串口打印响应信息
-  Serial.printf("Response sent via UART2: $%s\n", message.c_str());
+size_t fillSerialTelemetry(uint8_t* out, size_t capacity) {
+  static constexpr size_t kTelemetrySize = 14;
+  if (capacity < kTelemetrySize) {
+    return 0;
+  }
+  const uint32_t uptime = millis();
+  const uint16_t batteryMv = getBatteryState().loadedMv;
+  const int16_t movementMode = cmddispatch::movementFlag();
+  const float speed = hexapod::Robot ? hexapod::Robot->getMovementSpeed() : 0.0f;
+  uint8_t flags = 0;
+  if (isLowBatteryLatched()) flags |= 0x01;
+  if (motion::controller().hasActiveAction()) flags |= 0x02;
+  if (performance::controller().isActive()) flags |= 0x04;
+  if (singleleg::controller().isActive()) flags |= 0x08;
+  const size_t freeSlots = motion::controller().freeSlots();
+
+  memcpy(out, &uptime, 4);
+  memcpy(out + 4, &batteryMv, 2);
+  memcpy(out + 6, &movementMode, 2);
+  memcpy(out + 8, &speed, 4);
+  out[12] = flags;
+  out[13] = static_cast<uint8_t>(freeSlots > 255 ? 255 : freeSlots);
+  return kTelemetrySize;
+}
+
+/* 发送串口指令应答（SerialLink 任务中调用，序列化进串口通道的静态缓冲）
+*/
+static void sendSerialReply(JsonDocument& response) {
+  const char* payload = nullptr;
+  const size_t length = jsonpool::serializeReply(jsonpool::Channel::Serial, response, payload);
+  seriallink::sendJson(payload, length);
+
+  #ifdef DEBUG_FRAME_RECEIVE
+  if (jsonpool::format(jsonpool::Channel::Serial) == jsonpool::Format::Json) {
+    Serial.printf("Response sent via UART2: $%s\n", payload);
+  }
+  #endif
+}
+
+static void sendSerialError(const char* message) {
+  JsonDocument& response = jsonpool::reply(jsonpool::Channel::Serial);
+  response["status"] = "error";
+  response["message"] = message;
+  sendSerialReply(response);
+}
+
+/* 串口主动推送的格式：二进制链路上沿用上位机最近一次指令的格式，文本链路总是 JSON
+*/
+static jsonpool::Format serialEventFormat() {
+  return seriallink::mode() == seriallink::LinkMode::Binary
+      ? jsonpool::format(jsonpool::Channel::Serial) : jsonpool::Format::Json;
+}
+
+/* 串口主动推送（可在任意任务中调用）
+*/
+static void sendSerialEvent(const JsonDocument& event) {
+  char payload[192];
+  const size_t length = jsonpool::serialize(serialEventFormat(), event, payload, sizeof(payload));
+  if (length > 0) {
+    seriallink::sendJson(payload, length);
+  }
 }
 
 /* 测试UART2连接
 */
 void testUART2Connection() {
-  Serial.println("Testing UART2 connection...");
-  
-  // 发送测试消息
-  Serial2.println("UART2 Test Message from Hexapod");
+  // 只发送测试消息；对端的回复由 SerialLink 任务按帧接收，不在这里抢读
+  static const char kMessage[] = "UART2 Test Message from Hexapod\r\n";
+  seriallink::write(kMessage, sizeof(kMessage) - 1);
   Serial.println("Test message sent via UART2");
-  
-  // 等待一小段时间
-  delay(100);
-  
-  // 检查是否有响应
-  if (Serial2.available()) {
-    Serial.println("UART2 response detected:");
-    while (Serial2.available()) {
-      char c = Serial2.read();
-      Serial.printf("Response char: '%c' (0x%02X)\n", c, c);
-    }
-  } else {
-    Serial.println("No UART2 response detected");
-  }
-  
-  Serial.println("UART2 test completed");
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "motion_controller.h"
 
+#include <cassert>
 #include <cmath>
 
 #include "debug.h"
@@ -29,11 +30,19 @@ void MotionController::setSequenceCallback(void (*callback)(uint32_t sequenceId)
 }
 
 bool MotionController::enqueue(const Action& action) {
+    return enqueueSequence(&action, 1);
+}
+
+bool MotionController::enqueueSequence(const Action* actions, size_t count) {
+    if (!actions || count == 0) {
+        return false;
+    }
     if (!mutex_) begin();
     if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE) {
         return false;
     }
-    bool pushed = queue_.push(action);
+    // 一次加锁完成整批入队，失败时池内状态不变
+    bool pushed = pool_.pushBack(actions, count, actions[0].priority);
     if (pushed && !active_.inUse) {
         startNextAction();
     }
@@ -41,32 +50,50 @@ bool MotionController::enqueue(const Action& action) {
     return pushed;
 }
 
-bool MotionController::enqueueSequence(const Action* actions, size_t count) {
-    if (!actions || count == 0) {
+bool MotionController::cancelSequence(uint32_t sequenceId, const char* reason) {
+    if (sequenceId == 0) {
         return false;
     }
-    bool result = true;
-    for (size_t i = 0; i < count; ++i) {
-        if (!enqueue(actions[i])) {
-            result = false;
-            break;
-        }
+    if (!mutex_) begin();
+    if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE) {
+        return false;
     }
-    return result;
+    bool found = pool_.removeSequence(sequenceId);
+    if (active_.inUse && active_.action.sequenceId == sequenceId) {
+        stopActive();
+        startNextAction();
+        found = true;
+    }
+    if (found && reason) {
+        LOG_INFO(reason);
+    }
+    xSemaphoreGive(mutex_);
+    return found;
 }
 
-void MotionController::clear(const char* reason) {
+void MotionController::clearLane(Priority priority, const char* reason) {
     if (!mutex_) begin();
     if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE) {
         return;
     }
-    queue_.clear();
-    if (active_.inUse && active_.restoreSpeed) {
-        if (Robot) {
-            Robot->setMovementSpeed(active_.previousSpeed);
-        }
+    pool_.clearLane(priority);
+    if (active_.inUse && active_.action.priority == priority) {
+        stopActive();
+        startNextAction();
     }
-    active_ = ActiveState{};
+    if (reason) {
+        LOG_INFO(reason);
+    }
+    xSemaphoreGive(mutex_);
+}
+
+void MotionController::clear(const char* reason) {
+    if (!mutex_) begin();
+    if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    pool_.clear();
+    stopActive();
     if (reason) {
         LOG_INFO(reason);
     }
@@ -81,26 +108,49 @@ hexapod::MovementMode MotionController::activeMode() const {
     return active_.inUse ? active_.action.mode : hexapod::MOVEMENT_STANDBY;
 }
 
+size_t MotionController::freeSlots() const {
+    return pool_.freeCount();
+}
+
 void MotionController::onLoopTick(MovementMode executedMode, uint32_t elapsedMs) {
-    if (!active_.inUse || active_.action.mode != executedMode) {
+    if (!mutex_) begin();
+    if (xSemaphoreTake(mutex_, portMAX_DELAY) != pdTRUE) {
         return;
     }
 
-    if (active_.targetCycles > 0.0f) {
+    uint32_t completedSequence = 0;
+    if (active_.inUse && active_.action.mode == executedMode) {
         float duration = calculateCycleDurationMs(active_.action);
-        if (duration <= 1e-3f) {
-            return;
-        }
-        active_.completedCycles += static_cast<float>(elapsedMs) / duration;
-        if (active_.completedCycles >= active_.targetCycles - 1e-3f) {
-            finishAction();
+        if (duration > 1e-3f) {
+            const float before = active_.completedCycles;
+            active_.completedCycles += static_cast<float>(elapsedMs) / duration;
+            // 周期边界：完成周期数的整数部分发生变化
+            const bool atCycleBoundary =
+                std::floor(active_.completedCycles + 1e-3f) > std::floor(before + 1e-3f);
+
+            if (active_.targetCycles > 0.0f
+                && active_.completedCycles >= active_.targetCycles - 1e-3f) {
+                completedSequence = finishAction();
+            } else if (shouldPreempt(atCycleBoundary)) {
+                preemptActive();
+            }
         }
+    } else if (active_.inUse && shouldPreempt(false)) {
+        // 尚未进入实际执行（例如四足切换对齐中）：只有安全通道可以直接抢占
+        preemptActive();
+    }
+
+    xSemaphoreGive(mutex_);
+
+    // 回调可能再次入队（例如表演循环），必须在释放互斥锁之后调用
+    if (completedSequence != 0 && sequenceCallback_) {
+        sequenceCallback_(completedSequence);
     }
 }
 
 void MotionController::startNextAction() {
     Action action;
-    if (!queue_.pop(action)) {
+    if (!pool_.popFront(action)) {
         return;
     }
     startAction(action);
@@ -125,34 +175,73 @@ void MotionController::startAction(const Action& action) {
         }
     }
 
-    char buffer[120];
-    snprintf(buffer, sizeof(buffer), "[MotionController] Start action mode=%d unit=%d targetCycles=%.2f sequence=%u",
-             action.mode, static_cast<int>(action.unit), active_.targetCycles, action.sequenceId);
+    char buffer[140];
+    snprintf(buffer, sizeof(buffer), "[MotionController] Start action mode=%d unit=%d targetCycles=%.2f sequence=%u priority=%d",
+             action.mode, static_cast<int>(action.unit), active_.targetCycles, action.sequenceId,
+             static_cast<int>(action.priority));
     LOG_INFO(buffer);
 }
 
-void MotionController::finishAction() {
+uint32_t MotionController::finishAction() {
     if (!active_.inUse) {
-        return;
-    }
-
-    if (active_.restoreSpeed) {
-        if (Robot) {
-            Robot->setMovementSpeed(active_.previousSpeed);
-        }
+        return 0;
     }
 
     uint32_t sequenceId = active_.action.sequenceId;
     bool isTail = active_.action.sequenceTail;
-    active_ = ActiveState{};
+    stopActive();
 
-    if (sequenceId != 0 && isTail && sequenceCallback_) {
-        sequenceCallback_(sequenceId);
+    if (!pool_.empty()) {
+        startNextAction();
     }
 
-    if (!queue_.empty()) {
-        startNextAction();
+    return (sequenceId != 0 && isTail) ? sequenceId : 0;
+}
+
+bool MotionController::shouldPreempt(bool atCycleBoundary) const {
+    Priority front;
+    if (!active_.inUse || !pool_.frontLane(front)) {
+        return false;
+    }
+    if (static_cast<uint8_t>(front) >= static_cast<uint8_t>(active_.action.priority)) {
+        return false;
     }
+    return front == Priority::Safety || atCycleBoundary;
+}
+
+void MotionController::preemptActive() {
+    // 先取出高优先级动作（释放一个节点），保证被抢占动作的剩余部分一定能放回
+    Action next;
+    if (!pool_.popFront(next)) {
+        return;
+    }
+
+    Action remain = active_.action;
+    if (active_.targetCycles > 0.0f) {
+        remain.unit = Unit::Cycles;
+        remain.value = active_.targetCycles - active_.completedCycles;
+    }
+    const bool keepRemain = active_.targetCycles <= 0.0f || remain.value > 1e-3f;
+    stopActive();
+    if (keepRemain) {
+        pool_.pushFront(remain, remain.priority);
+    }
+
+    char buffer[120];
+    snprintf(buffer, sizeof(buffer), "[MotionController] Preempt mode=%d (priority=%d) by priority=%d",
+             remain.mode, static_cast<int>(remain.priority), static_cast<int>(next.priority));
+    LOG_INFO(buffer);
+
+    startAction(next);
+}
+
+void MotionController::stopActive() {
+    if (active_.inUse && active_.restoreSpeed) {
+        if (Robot) {
+            Robot->setMovementSpeed(active_.previousSpeed);
+        }
+    }
+    active_ = ActiveState{};
 }
 
 float MotionController::convertToCycles(const Action& action) const {
@@ -180,28 +269,316 @@ float MotionController::calculateCycleDurationMs(const Action& action) const {
     return Robot->getMovementCycleDurationMs(action.mode);
 }
 
-bool MotionController::ActionQueue::push(const Action& action) {
-    if (count_ >= kMaxActions) {
+constexpr size_t MotionController::ActionPool::kCapacity;
+constexpr int16_t MotionController::ActionPool::kNil;
+constexpr size_t MotionController::ActionPool::kSequenceSlots;
+
+MotionController::ActionPool::ActionPool() {
+    clear();
+}
+
+int16_t MotionController::ActionPool::allocNode() {
+    if (freeHead_ == kNil) {
+        return kNil;
+    }
+    int16_t node = freeHead_;
+    freeHead_ = nodes_[node].next;
+    --freeCount_;
+    nodes_[node].prev = kNil;
+    nodes_[node].next = kNil;
+    return node;
+}
+
+void MotionController::ActionPool::releaseRange(int16_t first, int16_t last, size_t count) {
+    // 已从通道摘下的连续节点整段挂回空闲链表
+    nodes_[last].next = freeHead_;
+    freeHead_ = first;
+    freeCount_ += count;
+    assert(freeCount_ <= kCapacity);
+}
+
+void MotionController::ActionPool::linkBefore(Lane& lane, int16_t node, int16_t before) {
+    if (before == kNil) {
+        nodes_[node].prev = lane.tail;
+        nodes_[node].next = kNil;
+        if (lane.tail != kNil) {
+            nodes_[lane.tail].next = node;
+        } else {
+            lane.head = node;
+        }
+        lane.tail = node;
+        return;
+    }
+
+    nodes_[node].prev = nodes_[before].prev;
+    nodes_[node].next = before;
+    if (nodes_[before].prev != kNil) {
+        nodes_[nodes_[before].prev].next = node;
+    } else {
+        lane.head = node;
+    }
+    nodes_[before].prev = node;
+}
+
+void MotionController::ActionPool::unlinkRange(Lane& lane, int16_t first, int16_t last) {
+    const int16_t prev = nodes_[first].prev;
+    const int16_t next = nodes_[last].next;
+    if (prev != kNil) {
+        nodes_[prev].next = next;
+    } else {
+        lane.head = next;
+    }
+    if (next != kNil) {
+        nodes_[next].prev = prev;
+    } else {
+        lane.tail = prev;
+    }
+    nodes_[first].prev = kNil;
+    nodes_[last].next = kNil;
+}
+
+bool MotionController::ActionPool::pushBack(const Action* actions, size_t count, Priority priority) {
+    const size_t laneIndex = static_cast<size_t>(priority);
+    if (!actions || count == 0 || laneIndex >= kPriorityCount || count > freeCount_) {
         return false;
     }
-    buffer_[tail_] = action;
-    tail_ = (tail_ + 1) % kMaxActions;
-    ++count_;
+
+    // 同一批动作必须属于同一序列，保证序列在通道内连续
+    const uint32_t sequenceId = actions[0].sequenceId;
+    for (size_t i = 1; i < count; ++i) {
+        if (actions[i].sequenceId != sequenceId) {
+            return false;
+        }
+    }
+
+    Lane& lane = lanes_[laneIndex];
+    SequenceSpan* span = nullptr;
+    if (sequenceId != 0) {
+        span = findSequence(sequenceId);
+        // 追加到已有序列：只允许接在该序列尾部（即通道末尾），否则序列号冲突
+        if (span && (span->lane != laneIndex || span->last != lane.tail)) {
+            return false;
+        }
+        if (!span) {
+            span = insertSequence(sequenceId);
+            if (!span) {
+                return false;
+            }
+            span->lane = static_cast<uint8_t>(laneIndex);
+            span->first = kNil;
+            span->count = 0;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        int16_t node = allocNode();
+        nodes_[node].action = actions[i];
+        nodes_[node].action.priority = priority;
+        linkBefore(lane, node, kNil);
+        if (span) {
+            if (span->first == kNil) {
+                span->first = node;
+            }
+            span->last = node;
+            ++span->count;
+        }
+    }
     return true;
 }
 
-bool MotionController::ActionQueue::pop(Action& action) {
-    if (count_ == 0) {
+bool MotionController::ActionPool::pushFront(const Action& action, Priority priority) {
+    const size_t laneIndex = static_cast<size_t>(priority);
+    if (laneIndex >= kPriorityCount) {
         return false;
     }
-    action = buffer_[head_];
-    head_ = (head_ + 1) % kMaxActions;
-    --count_;
+    int16_t node = allocNode();
+    if (node == kNil) {
+        return false;
+    }
+    nodes_[node].action = action;
+    nodes_[node].action.priority = priority;
+
+    Lane& lane = lanes_[laneIndex];
+    SequenceSpan* span = action.sequenceId ? findSequence(action.sequenceId) : nullptr;
+    if (span && span->lane == laneIndex) {
+        // 放回所属序列的最前面，保持序列连续
+        linkBefore(lane, node, span->first);
+        span->first = node;
+        ++span->count;
+        return true;
+    }
+
+    linkBefore(lane, node, lane.head);
+    if (action.sequenceId && !span) {
+        span = insertSequence(action.sequenceId);
+        if (span) {
+            span->lane = static_cast<uint8_t>(laneIndex);
+            span->first = node;
+            span->last = node;
+            span->count = 1;
+        }
+    }
     return true;
 }
 
-void MotionController::ActionQueue::clear() {
-    head_ = tail_ = count_ = 0;
+bool MotionController::ActionPool::popFront(Action& action) {
+    Priority priority;
+    if (!frontLane(priority)) {
+        return false;
+    }
+    Lane& lane = lanes_[static_cast<size_t>(priority)];
+    const int16_t node = lane.head;
+    action = nodes_[node].action;
+
+    if (action.sequenceId != 0) {
+        SequenceSpan* span = findSequence(action.sequenceId);
+        if (span && span->first == node) {
+            if (span->count <= 1) {
+                eraseSequence(span);
+            } else {
+                span->first = nodes_[node].next;
+                --span->count;
+            }
+        }
+    }
+
+    unlinkRange(lane, node, node);
+    releaseRange(node, node, 1);
+    return true;
+}
+
+bool MotionController::ActionPool::removeSequence(uint32_t sequenceId) {
+    SequenceSpan* span = findSequence(sequenceId);
+    if (!span) {
+        return false;
+    }
+    const int16_t first = span->first;
+    const int16_t last = span->last;
+    const size_t count = span->count;
+    unlinkRange(lanes_[span->lane], first, last);
+    releaseRange(first, last, count);
+    eraseSequence(span);
+    return true;
+}
+
+void MotionController::ActionPool::clearLane(Priority priority) {
+    const size_t laneIndex = static_cast<size_t>(priority);
+    if (laneIndex >= kPriorityCount) {
+        return;
+    }
+    Lane& lane = lanes_[laneIndex];
+    if (lane.head == kNil) {
+        return;
+    }
+
+    size_t count = 0;
+    for (int16_t node = lane.head; node != kNil; node = nodes_[node].next) {
+        ++count;
+    }
+    size_t i = 0;
+    while (i < kSequenceSlots) {
+        if (sequences_[i].id != 0 && sequences_[i].lane == laneIndex) {
+            // 回移删除会把后续槽位前移到当前槽位，因此删除后重新检查当前槽位
+            eraseSequence(&sequences_[i]);
+        } else {
+            ++i;
+        }
+    }
+
+    const int16_t first = lane.head;
+    const int16_t last = lane.tail;
+    unlinkRange(lane, first, last);
+    releaseRange(first, last, count);
+}
+
+void MotionController::ActionPool::clear() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+        nodes_[i].prev = kNil;
+        nodes_[i].next = (i + 1 < kCapacity) ? static_cast<int16_t>(i + 1) : kNil;
+    }
+    freeHead_ = 0;
+    freeCount_ = kCapacity;
+    for (size_t i = 0; i < kPriorityCount; ++i) {
+        lanes_[i].head = kNil;
+        lanes_[i].tail = kNil;
+    }
+    for (size_t i = 0; i < kSequenceSlots; ++i) {
+        sequences_[i] = SequenceSpan{0, 0, kNil, kNil, 0};
+    }
+}
+
+bool MotionController::ActionPool::empty() const {
+    return freeCount_ == kCapacity;
+}
+
+bool MotionController::ActionPool::laneEmpty(Priority priority) const {
+    const size_t laneIndex = static_cast<size_t>(priority);
+    return laneIndex >= kPriorityCount || lanes_[laneIndex].head == kNil;
+}
+
+bool MotionController::ActionPool::frontLane(Priority& priority) const {
+    for (size_t i = 0; i < kPriorityCount; ++i) {
+        if (lanes_[i].head != kNil) {
+            priority = static_cast<Priority>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MotionController::ActionPool::sequenceHash(uint32_t id) {
+    // Knuth 乘法散列
+    return static_cast<size_t>((id * 2654435761u) >> 16) & (kSequenceSlots - 1);
+}
+
+MotionController::ActionPool::SequenceSpan* MotionController::ActionPool::findSequence(uint32_t id) {
+    size_t slot = sequenceHash(id);
+    for (size_t probe = 0; probe < kSequenceSlots; ++probe) {
+        SequenceSpan& span = sequences_[slot];
+        if (span.id == id) {
+            return &span;
+        }
+        if (span.id == 0) {
+            return nullptr;
+        }
+        slot = (slot + 1) & (kSequenceSlots - 1);
+    }
+    return nullptr;
+}
+
+MotionController::ActionPool::SequenceSpan* MotionController::ActionPool::insertSequence(uint32_t id) {
+    size_t slot = sequenceHash(id);
+    for (size_t probe = 0; probe < kSequenceSlots; ++probe) {
+        SequenceSpan& span = sequences_[slot];
+        if (span.id == 0) {
+            span.id = id;
+            return &span;
+        }
+        slot = (slot + 1) & (kSequenceSlots - 1);
+    }
+    return nullptr;
+}
+
+void MotionController::ActionPool::eraseSequence(SequenceSpan* span) {
+    // 线性探测的回移删除：把后续仍在探测链上的条目前移，避免留下墓碑
+    size_t hole = static_cast<size_t>(span - sequences_);
+    size_t slot = hole;
+    sequences_[hole].id = 0;
+    for (;;) {
+        slot = (slot + 1) & (kSequenceSlots - 1);
+        if (sequences_[slot].id == 0) {
+            return;
+        }
+        const size_t home = sequenceHash(sequences_[slot].id);
+        // home 不在 (hole, slot] 环形区间内时，该条目可以移到 hole
+        const bool movable = (hole <= slot) ? (home <= hole || home > slot)
+                                            : (home <= hole && home > slot);
+        if (movable) {
+            sequences_[hole] = sequences_[slot];
+            sequences_[slot].id = 0;
+            hole = slot;
+        }
+    }
 }
 
 } // namespace motion
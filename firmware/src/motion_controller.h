@@ -9,8 +9,29 @@
 #include "hexapod.h"
 #include "movement_profile.h"
 
+// 动作池容量（所有优先级通道共享，静态分配），可通过 build_flags 覆盖
+#ifndef MOTION_QUEUE_CAPACITY
+#define MOTION_QUEUE_CAPACITY 32
+#endif
+
 namespace motion {
 
+// 单条 sequence 指令允许的最大动作数（受动作池容量约束）
+constexpr size_t kMaxSequenceLength = MOTION_QUEUE_CAPACITY;
+
+// 优先级通道：数值越小优先级越高
+// - Safety：安全相关（立即在下一个控制周期抢占）
+// - User：用户指令（默认）
+// - Performance：表演编排
+// 低优先级动作在周期边界被高优先级动作抢占，剩余周期数放回其通道队首，之后继续执行。
+enum class Priority : uint8_t {
+    Safety = 0,
+    User,
+    Performance,
+};
+
+constexpr size_t kPriorityCount = 3;
+
 enum class Unit : uint8_t {
     Continuous = 0,
     Cycles,
@@ -26,6 +47,7 @@ struct Action {
     float speed = 0.0f;         // 可选速度覆盖
     uint32_t sequenceId = 0;    // 0 表示非序列动作
     bool sequenceTail = false;  // 是否为序列最后一段
+    Priority priority = Priority::User;
 };
 
 class MotionController {
@@ -36,31 +58,85 @@ public:
     void setSequenceCallback(void (*callback)(uint32_t sequenceId));
 
     bool enqueue(const Action& action);
+    // 原子批量入队：要么全部入队，要么一个都不入队（池空间不足/序列号冲突时返回 false）。
+    // 整批使用 actions[0].priority 所在通道。
     bool enqueueSequence(const Action* actions, size_t count);
+    // 按 sequenceId 取消（包括正在执行的动作），返回是否找到
+    bool cancelSequence(uint32_t sequenceId, const char* reason = nullptr);
+    // 清空指定通道（不影响其它通道正在排队的动作）；若当前动作属于该通道也一并停止
+    void clearLane(Priority priority, const char* reason = nullptr);
     void clear(const char* reason = nullptr);
 
     bool hasActiveAction() const;
     hexapod::MovementMode activeMode() const;
+    size_t capacity() const { return ActionPool::kCapacity; }
+    size_t freeSlots() const;
 
     void onLoopTick(hexapod::MovementMode executedMode, uint32_t elapsedMs);
 
 private:
-    struct QueueItem {
-        Action action;
-    };
-
-    class ActionQueue {
+    // 静态动作池：各优先级通道为池内节点组成的双向链表，空闲节点组成单向空闲链表；
+    // 同一 sequenceId 的动作在通道内连续存放，序列表记录其首尾节点，取消时 O(1) 摘除整段。
+    class ActionPool {
     public:
-        bool push(const Action& action);
-        bool pop(Action& action);
+        static constexpr size_t kCapacity = MOTION_QUEUE_CAPACITY;
+
+        ActionPool();
+
+        bool pushBack(const Action* actions, size_t count, Priority lane);
+        bool pushFront(const Action& action, Priority lane);
+        bool popFront(Action& action);
+        bool removeSequence(uint32_t sequenceId);
+        void clearLane(Priority lane);
         void clear();
-        bool empty() const { return count_ == 0; }
+
+        bool empty() const;
+        bool laneEmpty(Priority lane) const;
+        // 返回最高优先级的非空通道，全空时返回 false
+        bool frontLane(Priority& lane) const;
+        size_t freeCount() const { return freeCount_; }
+
     private:
-        static constexpr size_t kMaxActions = 8;
-        Action buffer_[kMaxActions];
-        size_t head_ = 0;
-        size_t tail_ = 0;
-        size_t count_ = 0;
+        static constexpr int16_t kNil = -1;
+        // 序列表：开放寻址（线性探测 + 删除时回移），容量为 2 的幂且不小于 2 倍池容量
+        static constexpr size_t kSequenceSlots =
+            (kCapacity <= 8) ? 16 : (kCapacity <= 16) ? 32 : (kCapacity <= 32) ? 64 :
+            (kCapacity <= 64) ? 128 : 256;
+
+        struct Node {
+            Action action;
+            int16_t prev;
+            int16_t next;
+        };
+
+        struct Lane {
+            int16_t head;
+            int16_t tail;
+        };
+
+        struct SequenceSpan {
+            uint32_t id;        // 0 表示空槽
+            uint8_t lane;
+            int16_t first;
+            int16_t last;
+            uint16_t count;
+        };
+
+        int16_t allocNode();
+        void releaseRange(int16_t first, int16_t last, size_t count);
+        void linkBefore(Lane& lane, int16_t node, int16_t before);
+        void unlinkRange(Lane& lane, int16_t first, int16_t last);
+
+        SequenceSpan* findSequence(uint32_t id);
+        SequenceSpan* insertSequence(uint32_t id);
+        void eraseSequence(SequenceSpan* span);
+        static size_t sequenceHash(uint32_t id);
+
+        Node nodes_[kCapacity];
+        Lane lanes_[kPriorityCount];
+        int16_t freeHead_;
+        size_t freeCount_;
+        SequenceSpan sequences_[kSequenceSlots];
     };
 
     struct ActiveState {
@@ -79,13 +155,17 @@ private:
 
     void startNextAction();
     void startAction(const Action& action);
-    void finishAction();
+    // 返回已完成序列的 sequenceId（需要在释放互斥锁后回调），无则返回 0
+    uint32_t finishAction();
+    bool shouldPreempt(bool atCycleBoundary) const;
+    void preemptActive();
+    void stopActive();
     float convertToCycles(const Action& action) const;
     float calculateCycleDurationMs(const Action& action) const;
     float sanitizedSpeed(const Action& action) const;
 
 private:
-    ActionQueue queue_;
+    ActionPool pool_;
     ActiveState active_;
     void (*sequenceCallback_)(uint32_t) = nullptr;
     SemaphoreHandle_t mutex_ = nullptr;
@@ -1,8 +1,10 @@
 #include "movement.h"
 #include "debug.h"
 #include "config.h"
+#include "rng.h"
+#include "transition_timing.h"
 
-#include <cstdlib>
+#include <math.h>
 
 namespace hexapod {
 
@@ -38,6 +40,30 @@ namespace hexapod {
         beatswayTable(),
     };
 
+    namespace {
+        // 入场帧评分：摆动/支撑状态与当前不一致的腿按该距离（mm）计入代价
+        const float kEntrySwingMismatchCostMm = 15.0f;
+        // 代价相差不超过该值（mm）的入场帧视为等价，随机选取其一（保持对称入场的左右交替）
+        const float kEntryTieToleranceMm = 0.5f;
+
+        float distance(const Point3D& a, const Point3D& b) {
+            const float dx = a.x_ - b.x_;
+            const float dy = a.y_ - b.y_;
+            const float dz = a.z_ - b.z_;
+            return sqrtf(dx * dx + dy * dy + dz * dz);
+        }
+
+        // 该腿在本表中的支撑相高度（最低的 Z）
+        float stanceHeight(const MovementTable& table, int leg) {
+            float stanceZ = table.table[0].get(leg).z_;
+            for (int f = 1; f < table.length; f++) {
+                if (table.table[f].get(leg).z_ < stanceZ)
+                    stanceZ = table.table[f].get(leg).z_;
+            }
+            return stanceZ;
+        }
+    }
+
     const MovementTable& getMovementTable(MovementMode mode) {
         if (mode < 0 || mode >= MOVEMENT_TOTAL) {
             return kTable[MOVEMENT_STANDBY];
@@ -62,13 +88,66 @@ namespace hexapod {
         }
 
         mode_ = newMode;
+        transiting_ = true;
 
         const MovementTable& table = kTable[mode_];
 
-        index_ = table.entries[std::rand() % table.entriesCount];
-        int actualDuration = (int)(table.stepDuration / speed_);
-        int actualSwitchDuration = (int)(config::movementSwitchDuration / speed_);
-        remainTime_ = actualSwitchDuration > actualDuration ? actualSwitchDuration : actualDuration;
+        index_ = selectEntry(table);
+
+        // 按关节限速计算，取整到控制周期（未设置计时器时只过渡一个控制周期）
+        const float travelMs = transitionTimer_ ? transitionTimer_(position_, table.table[index_]) : 0.0f;
+        remainTime_ = transition::durationMs(travelMs, speed_, 0);
+    }
+
+    int Movement::selectEntry(const MovementTable& table) const {
+        // 当前各腿是否离地（按目标表的支撑相高度判断）
+        bool lifted[6];
+        float stanceZ[6];
+        for (int i = 0; i < 6; i++) {
+            stanceZ[i] = stanceHeight(table, i);
+            lifted[i] = position_.get(i).z_ > stanceZ[i] + kSwingLiftThresholdMm;
+        }
+
+        // 代价 = 各腿位移之和 + 摆动/支撑状态不一致的惩罚
+        auto cost = [&](int entry) {
+            float sum = 0;
+            for (int i = 0; i < 6; i++) {
+                const Point3D& target = table.table[entry].get(i);
+                sum += distance(position_.get(i), target);
+                if ((target.z_ > stanceZ[i] + kSwingLiftThresholdMm) != lifted[i])
+                    sum += kEntrySwingMismatchCostMm;
+            }
+            return sum;
+        };
+        auto valid = [&](int entry) { return entry >= 0 && entry < table.length; };
+
+        float bestCost = -1;
+        for (int e = 0; e < table.entriesCount; e++) {
+            if (!valid(table.entries[e]))
+                continue;
+            const float c = cost(table.entries[e]);
+            if (bestCost < 0 || c < bestCost)
+                bestCost = c;
+        }
+
+        int index = 0;
+        if (bestCost >= 0) {
+            int ties = 0;
+            for (int e = 0; e < table.entriesCount; e++) {
+                if (valid(table.entries[e]) && cost(table.entries[e]) <= bestCost + kEntryTieToleranceMm)
+                    ties++;
+            }
+            int pick = ties > 1 ? (int)rng::below(rng::Subsystem::MovementEntry, ties) : 0;
+            for (int e = 0; e < table.entriesCount; e++) {
+                if (!valid(table.entries[e]) || cost(table.entries[e]) > bestCost + kEntryTieToleranceMm)
+                    continue;
+                if (pick-- == 0) {
+                    index = table.entries[e];
+                    break;
+                }
+            }
+        }
+        return index;
     }
 
     void Movement::snapToMode(MovementMode newMode) {
@@ -91,6 +170,7 @@ namespace hexapod {
         }
         position_ = table.table[index_];
         remainTime_ = 0;
+        transiting_ = false;
     }
 
     const Locations& Movement::next(int elapsed) {
@@ -113,10 +193,27 @@ namespace hexapod {
         auto ratio = (float)elapsed / remainTime_;
         position_ += (table.table[index_] - position_)*ratio;
         remainTime_ -= elapsed;
+        if (remainTime_ <= 0)
+            transiting_ = false;
 
         return position_;
     }
 
+    void Movement::contactStates(bool* contact) const {
+        const MovementTable& table = kTable[mode_];
+        for (int i = 0; i < 6; i++)
+            contact[i] = true;
+        if (!isLocomotionMode(mode_) || table.length <= 1)
+            return;
+
+        // 本帧已到达时，下一个目标是 index_ + 1
+        const int target = remainTime_ > 0 ? index_ : (index_ + 1) % table.length;
+        for (int i = 0; i < 6; i++) {
+            const float limit = stanceHeight(table, i) + kSwingLiftThresholdMm;
+            contact[i] = position_.get(i).z_ <= limit && table.table[target].get(i).z_ <= limit;
+        }
+    }
+
     void Movement::setSpeed(float speed) {
         // Clamp speed to valid range
         if (speed < config::minSpeed)
@@ -2,6 +2,8 @@
 
 #include "base.h"
 
+#include <functional>
+
 namespace hexapod {
 
     enum MovementMode {
@@ -30,6 +32,14 @@ namespace hexapod {
         return m;
     }
 
+    // 摆动腿判定阈值：足端高于站立（支撑相）高度该值（mm）视为离地
+    const float kSwingLiftThresholdMm = 1.0f;
+
+    // 行走类步态（抬腿高度可缩放）；姿态类动作（rotate/twist/climb 等）的 Z 变化不属于抬腿
+    inline bool isLocomotionMode(MovementMode mode) {
+        return mode >= MOVEMENT_FORWARD && mode <= MOVEMENT_SHIFTRIGHT;
+    }
+
     struct MovementTable {
         const Locations* table;
         int length;
@@ -42,24 +52,44 @@ namespace hexapod {
 
     class Movement {
     public:
+        // 过渡计时：足端从 from 线性插值到 to 所需的最短时长（ms，1.0 倍速），由持有腿运动学的一方提供
+        using TransitionTimer = std::function<float(const Locations& from, const Locations& to)>;
+
         Movement(MovementMode mode);
 
+        // 过渡时长按关节空间距离计算（见 transition_timing.h），HexapodClass 构造时设置
+        void setTransitionTimer(TransitionTimer timer) { transitionTimer_ = timer; }
+
         void setMode(MovementMode newMode);
         void snapToMode(MovementMode newMode);
 
         const Locations& next(int elapsed);
 
+        // 当前足端位置（上一次 next() 的结果）
+        const Locations& position() const { return position_; }
+
+        // 步态相位决定的触地状态（contact[6]）：行走类步态中，足端处于本表支撑相高度、
+        // 且正在插值的目标帧仍为支撑相时视为触地（即将抬起的腿提前按摆动处理）；姿态类动作全部触地
+        void contactStates(bool* contact) const;
+
+        // setMode 后仍在插值到新模式首帧
+        bool isTransiting() const { return transiting_; }
+
         // Speed control API
         void setSpeed(float speed);
         float getSpeed() const;
 
     private:
+        // 选取离当前足端位置最近的入场帧（位移 + 摆动/支撑一致性评分），返回帧号
+        int selectEntry(const MovementTable& table) const;
+
         MovementMode mode_;
         Locations position_;
         int index_;             // index in mode position table
         bool transiting_;       // if still in transiting to new mode
         int remainTime_;
         float speed_;           // speed multiplier, range: 0.25 - 1.0
+        TransitionTimer transitionTimer_;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+// 编译期生成的名字 -> 编号完美哈希表（与平台无关，可在主机上直接编译）
+// - 名字哈希为 FNV-1a（按 ASCII 小写计算，大小写不敏感的表与敏感的表共用），槽位为 (hash * seed) >> (32 - bits)
+// - 槽位表在编译期由 buildSlots() 生成；static_assert(isPerfect(...)) 保证所有名字落在不同槽位，
+//   新增名字出现冲突时编译失败，更换 seed 即可
+// - 运行时查找：一次哈希 + 一次字符串比较，未知名字返回 -1
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <strings.h>
+
+namespace namehash {
+
+struct Entry {
+  const char* name;
+  uint8_t value;
+};
+
+constexpr char lowerAscii(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+constexpr uint32_t hashName(const char* s, uint32_t h = 2166136261u) {
+  return *s ? hashName(s + 1, (h ^ static_cast<uint8_t>(lowerAscii(*s))) * 16777619u) : h;
+}
+
+// 运行时版本（与 hashName 结果一致，避免递归）
+inline uint32_t hashNameRuntime(const char* s) {
+  uint32_t h = 2166136261u;
+  for (; *s; ++s) {
+    h = (h ^ static_cast<uint8_t>(lowerAscii(*s))) * 16777619u;
+  }
+  return h;
+}
+
+constexpr uint8_t slotOf(uint32_t hash, uint32_t seed, uint8_t bits) {
+  return static_cast<uint8_t>(static_cast<uint32_t>(hash * seed) >> (32 - bits));
+}
+
+template <size_t Size>
+struct SlotTable {
+  int8_t index[Size];  // 槽位 -> 条目下标，-1 为空槽
+};
+
+template <size_t... I>
+struct Indices {};
+
+template <size_t N, size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct MakeIndices<0, I...> {
+  typedef Indices<I...> type;
+};
+
+template <size_t N>
+constexpr int8_t findEntry(const Entry (&entries)[N], uint32_t seed, uint8_t bits, size_t slot, size_t i) {
+  return i == N ? static_cast<int8_t>(-1)
+      : slotOf(hashName(entries[i].name), seed, bits) == slot ? static_cast<int8_t>(i)
+      : findEntry(entries, seed, bits, slot, i + 1);
+}
+
+template <size_t N, size_t... Slot>
+constexpr SlotTable<sizeof...(Slot)> buildSlots(const Entry (&entries)[N], uint32_t seed, uint8_t bits, Indices<Slot...>) {
+  return SlotTable<sizeof...(Slot)>{{findEntry(entries, seed, bits, Slot, 0)...}};
+}
+
+template <size_t N>
+constexpr bool noCollisionWith(const Entry (&entries)[N], uint32_t seed, uint8_t bits, size_t i, size_t j) {
+  return j == N ? true
+      : slotOf(hashName(entries[i].name), seed, bits) != slotOf(hashName(entries[j].name), seed, bits)
+          && noCollisionWith(entries, seed, bits, i, j + 1);
+}
+
+// 所有名字的槽位互不相同
+template <size_t N>
+constexpr bool isPerfect(const Entry (&entries)[N], uint32_t seed, uint8_t bits, size_t i = 0) {
+  return i == N ? true : noCollisionWith(entries, seed, bits, i, i + 1) && isPerfect(entries, seed, bits, i + 1);
+}
+
+// 查找名字，返回条目下标（未知返回 -1）
+template <size_t N, size_t Size>
+int8_t lookup(const Entry (&entries)[N], const SlotTable<Size>& slots, uint32_t seed, uint8_t bits,
+              const char* name, bool ignoreCase) {
+  if (!name) {
+    return -1;
+  }
+  const int8_t index = slots.index[slotOf(hashNameRuntime(name), seed, bits)];
+  if (index < 0) {
+    return -1;
+  }
+  const char* candidate = entries[index].name;
+  const bool match = ignoreCase ? strcasecmp(candidate, name) == 0 : strcmp(candidate, name) == 0;
+  return match ? index : static_cast<int8_t>(-1);
+}
+
+}  // namespace namehash
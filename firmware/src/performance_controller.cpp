@@ -3,6 +3,7 @@
 #include <cstdio>
 
 #include "debug.h"
+#include "rng.h"
 
 namespace performance {
 
@@ -76,6 +77,7 @@ void attachSequenceMetadata(Action* actions, size_t count, uint32_t sequenceId)
     for (size_t i = 0; i < count; ++i) {
         actions[i].sequenceId = sequenceId;
         actions[i].sequenceTail = (i + 1 == count);
+        actions[i].priority = motion::Priority::Performance;
     }
 }
 
@@ -120,10 +122,11 @@ bool isSupported(Kind kind) {
 }
 
 void Controller::begin() {
-    if (rngState_ == 0) {
-        rngState_ = micros();
-        if (rngState_ == 0) {
-            rngState_ = 0x13579BDFu;
+    // 编排默认每次上电都不同；显式设置过种子（协议 seed / 会话录制）时保持可复现
+    if (!rngSeeded_) {
+        rngSeeded_ = true;
+        if (!rng::isSeeded()) {
+            rng::seedSubsystem(rng::Subsystem::Performance, micros());
         }
     }
 }
@@ -205,7 +208,7 @@ void Controller::onSequenceComplete(uint32_t sequenceId) {
 
 bool Controller::enqueueRound(const State& state, bool clearQueue, String& error) {
     if (clearQueue) {
-        motion::controller().clear("[Performance] queue reset");
+        motion::controller().clearLane(motion::Priority::Performance, "[Performance] queue reset");
     }
 
     switch (state.kind) {
@@ -305,6 +308,7 @@ bool Controller::enqueueBeatSway(uint32_t sequenceId, String& error) {
     Action action = makeCyclesAction(MOVEMENT_BEATSWAY, kBeatSwayCyclesPerRound);
     action.sequenceId = sequenceId;
     action.sequenceTail = true;
+    action.priority = motion::Priority::Performance;
 
     if (!motion::controller().enqueue(action)) {
         error = "queue full";
@@ -327,20 +331,16 @@ uint32_t Controller::nextSequenceId() {
 }
 
 uint32_t Controller::nextRandom() {
-    if (rngState_ == 0) {
-        begin();
-    }
-    rngState_ ^= (rngState_ << 13);
-    rngState_ ^= (rngState_ >> 17);
-    rngState_ ^= (rngState_ << 5);
-    return rngState_;
+    begin();
+    return rng::next(rng::Subsystem::Performance);
 }
 
 int Controller::nextIndex(int limit) {
     if (limit <= 1) {
         return 0;
     }
-    return static_cast<int>(nextRandom() % static_cast<uint32_t>(limit));
+    begin();
+    return static_cast<int>(rng::below(rng::Subsystem::Performance, static_cast<uint32_t>(limit)));
 }
 
 }  // namespace performance
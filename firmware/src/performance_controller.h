@@ -52,7 +52,7 @@ private:
 
 private:
     State state_;
-    uint32_t rngState_ = 0;
+    bool rngSeeded_ = false;
     uint32_t sequenceCounter_ = 0;
 };
 
@@ -0,0 +1,99 @@
+// 功率调节器
+
+#include "power_governor.h"
+
+namespace powergovernor {
+
+namespace {
+
+float clampf(float value, float low, float high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+}  // namespace
+
+Governor::Governor(const Config& config) : config_(config) {
+  reset();
+}
+
+void Governor::reset() {
+  limits_ = Limits();
+  stats_ = Stats();
+  currentValid_ = false;
+}
+
+void Governor::setBattery(float openCircuitVoltage, float resistanceOhm, bool valid) {
+  openCircuitV_ = openCircuitVoltage;
+  resistanceOhm_ = resistanceOhm;
+  batteryValid_ = valid && resistanceOhm > 0.0f;
+}
+
+float Governor::targetScale(float budgetA, float dynamicAtFullA) const {
+  // 关节角速度与步态推进速度成正比，动态电流按 scale 线性估计
+  if (dynamicAtFullA < 1e-3f) {
+    return 1.0f;
+  }
+  return clampf((budgetA - config_.idleCurrentA) / dynamicAtFullA, config_.minSpeedScale, 1.0f);
+}
+
+float Governor::liftForSpeed(float speedScale) const {
+  const float span = 1.0f - config_.minSpeedScale;
+  if (span <= 0.0f) {
+    return 1.0f;
+  }
+  const float t = (speedScale - config_.minSpeedScale) / span;
+  return config_.minLiftScale + (1.0f - config_.minLiftScale) * clampf(t, 0.0f, 1.0f);
+}
+
+const Limits& Governor::update(float stanceDeg, float swingDeg, int elapsedMs) {
+  if (elapsedMs <= 0) {
+    return limits_;
+  }
+  const float dt = elapsedMs / 1000.0f;
+
+  const float sample = config_.idleCurrentA +
+                       config_.stanceAmpsPerDegS * stanceDeg / dt +
+                       config_.swingAmpsPerDegS * swingDeg / dt;
+  if (!currentValid_) {
+    stats_.currentA = sample;
+    currentValid_ = true;
+  } else {
+    stats_.currentA += dt / (config_.currentTauSec + dt) * (sample - stats_.currentA);
+  }
+
+  float scale = limits_.speedScale;
+  if (!config_.enabled || !batteryValid_) {
+    stats_.budgetA = 0.0f;
+    scale = clampf(scale + config_.releasePerSec * dt, config_.minSpeedScale, 1.0f);
+  } else {
+    // 当前估算电流对应的是已限速后的关节运动，折算回不限速时的动态电流
+    const float dynamicAtFull = (stats_.currentA - config_.idleCurrentA) / limits_.speedScale;
+    const float budgetDown = (openCircuitV_ - config_.floorVoltage) / resistanceOhm_;
+    const float budgetUp = (openCircuitV_ - config_.floorVoltage - config_.hysteresisVoltage) / resistanceOhm_;
+    stats_.budgetA = budgetDown > 0.0f ? budgetDown : 0.0f;
+
+    const float down = targetScale(budgetDown, dynamicAtFull);
+    const float up = targetScale(budgetUp, dynamicAtFull);
+    if (down < scale) {
+      scale = clampf(scale - config_.attackPerSec * dt, down, 1.0f);
+    } else if (up > scale) {
+      scale = clampf(scale + config_.releasePerSec * dt, config_.minSpeedScale, up);
+    }
+  }
+
+  limits_.speedScale = scale;
+  limits_.liftScale = liftForSpeed(scale);
+
+  const bool engaged = scale < 0.995f;
+  if (engaged && !stats_.engaged) {
+    ++stats_.engageCount;
+  }
+  if (engaged) {
+    stats_.throttledMs += static_cast<uint32_t>(elapsedMs);
+  }
+  stats_.engaged = engaged;
+  stats_.throttlePercent = static_cast<uint8_t>((1.0f - scale) * 100.0f + 0.5f);
+  return limits_;
+}
+
+}  // namespace powergovernor
@@ -0,0 +1,73 @@
+// 功率调节器（与平台无关，可在主机上直接编译）
+// - 由每个控制周期的关节角速度估算舵机电流：支撑腿关节带载，每 °/s 的电流高于摆动腿
+// - 结合电池估计（开路电压 + 内阻）算出保持带载端电压不低于下限的电流预算，
+//   超出预算时按比例降低步态推进速度与抬腿高度（指令速度不变，动作计时按实际速度换算）
+// - 回差：低于下限立即收紧，只有在下限 + 回差下仍有余量时才缓慢放开，避免在边界上来回切换
+#pragma once
+
+#include <cstdint>
+
+namespace powergovernor {
+
+struct Config {
+  bool enabled = true;
+  float floorVoltage = 7.0f;        // 带载端电压下限(V)
+  float hysteresisVoltage = 0.15f;  // 放开限速所需的额外余量(V)
+  float idleCurrentA = 0.6f;        // 站立保持电流
+  float stanceAmpsPerDegS = 0.0018f;  // 支撑腿关节每 °/s 的电流
+  float swingAmpsPerDegS = 0.0006f;   // 摆动腿关节每 °/s 的电流
+  float minSpeedScale = 0.5f;
+  float minLiftScale = 0.6f;
+  float attackPerSec = 2.0f;    // 收紧速率（scale/s）
+  float releasePerSec = 0.1f;   // 放开速率（scale/s）
+  float currentTauSec = 0.5f;   // 电流估计的滤波时间常数
+};
+
+struct Limits {
+  float speedScale = 1.0f;  // 步态推进速度倍率
+  float liftScale = 1.0f;   // 摆动腿抬腿高度倍率
+};
+
+struct Stats {
+  bool engaged = false;
+  uint8_t throttlePercent = 0;  // (1 - speedScale) * 100
+  float currentA = 0.0f;        // 由关节角速度估算的电流（滤波后）
+  float budgetA = 0.0f;         // 端电压保持在下限时允许的电流，电池估计无效时为 0
+  uint32_t throttledMs = 0;     // 累计限速时长
+  uint32_t engageCount = 0;
+};
+
+class Governor {
+public:
+  explicit Governor(const Config& config = Config());
+
+  void reset();
+  void setConfig(const Config& config) { config_ = config; }
+  const Config& config() const { return config_; }
+  void setEnabled(bool enabled) { config_.enabled = enabled; }
+  void setFloorVoltage(float volts) { config_.floorVoltage = volts; }
+
+  // 电池估计结果（约 1Hz 更新即可）
+  void setBattery(float openCircuitVoltage, float resistanceOhm, bool valid);
+
+  // 每个控制周期调用：stanceDeg/swingDeg 为该周期内支撑/摆动腿关节转过的角度之和
+  const Limits& update(float stanceDeg, float swingDeg, int elapsedMs);
+
+  const Limits& limits() const { return limits_; }
+  float currentA() const { return stats_.currentA; }
+  Stats stats() const { return stats_; }
+
+private:
+  float targetScale(float budgetA, float dynamicAtFullA) const;
+  float liftForSpeed(float speedScale) const;
+
+  Config config_;
+  Limits limits_;
+  Stats stats_;
+  float openCircuitV_ = 0.0f;
+  float resistanceOhm_ = 0.0f;
+  bool batteryValid_ = false;
+  bool currentValid_ = false;
+};
+
+}  // namespace powergovernor
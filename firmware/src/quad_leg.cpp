@@ -133,6 +133,12 @@ namespace quadruped {
         moveTipLocal(to);
     }
 
+    void Leg::jointAnglesFor(const hexapod::Point3D& world, float angles[3]) const {
+        hexapod::Point3D local;
+        localConv_(world - mountPosition_, local);
+        _inverseKinematics(local, angles);
+    }
+
     void Leg::moveTip(const hexapod::Point3D& to) {
         if (to == tipPos_)
             return;
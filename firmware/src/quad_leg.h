@@ -17,6 +17,9 @@ namespace quadruped {
 
         void setJointAngle(float angle[3]);
 
+        // 足端移动到 world（世界坐标）时的关节角度（度，未经舵机限幅），不驱动舵机
+        void jointAnglesFor(const hexapod::Point3D& world, float angles[3]) const;
+
         // 使用世界坐标控制足端
         void moveTip(const hexapod::Point3D& to);
         const hexapod::Point3D& getTipPosition(void);
@@ -3,6 +3,9 @@
 #include "quad_movement.h"
 #include "config.h"
 #include "debug.h"
+#include "transition_timing.h"
+
+#include <math.h>
 
 using namespace hexapod;
 
@@ -47,6 +50,8 @@ namespace quadruped {
     extern const QuadMovementTable& quad_rotatezTable();
     extern const QuadMovementTable& quad_twistTable();
 
+    static_assert(QUAD_GAIT_TOTAL <= transition::kMaxGaits, "transition stats need a slot per quad gait");
+
     namespace {
 
         inline bool isPostureMode(MovementMode mode) {
@@ -107,7 +112,7 @@ namespace quadruped {
         }
 
         inline int alignPhaseDurationMs(int phase, float speed) {
-            // 对齐过程使用独立的慢速节奏（更稳）。
+            // 没有关节运动学信息时的回退：对齐过程使用独立的慢速节奏（更稳）。
             // phase: 0=lift(Z-first), 1=moveXY, 2=lower
             const int base =
                 (phase == 1) ? 120 : 60; // moveXY 更长
@@ -140,6 +145,68 @@ namespace quadruped {
             return out;
         }
         
+        // 步态过渡：各腿相位变化超过该值（周期的比例）时用两个周期完成，否则一个周期
+        constexpr float kMorphSingleCycleShift = 0.25f;
+        // 过渡中收到新的模式请求时，剩余部分至多再用这么多个周期完成（之后按新步态规划模式切换）
+        constexpr float kMorphInterruptCycles = 0.5f;
+
+        inline float wrapPhase(float phase) {
+            return phase - floorf(phase);  // [0, 1)
+        }
+
+        inline float wrapPhaseDelta(float delta) {
+            return delta - floorf(delta + 0.5f);  // [-0.5, 0.5)
+        }
+
+        // 每条腿每周期恰好一段摆动时返回 true（现有行走表都满足）；摆动判定与 contactStates 相同
+        bool analyzeSwings(const QuadMovementTable& table, QuadLegSwing* out) {
+            if (!table.table || table.length < 4) {
+                return false;
+            }
+            for (int i = 0; i < 4; ++i) {
+                float stanceZ = table.table[0].p[i].z_;
+                for (int f = 1; f < table.length; ++f) {
+                    if (table.table[f].p[i].z_ < stanceZ) stanceZ = table.table[f].p[i].z_;
+                }
+                const float limit = stanceZ + hexapod::kSwingLiftThresholdMm;
+                int lifts = 0;
+                int swingFrames = 0;
+                int liftFrame = 0;
+                for (int f = 0; f < table.length; ++f) {
+                    const int prev = (f + table.length - 1) % table.length;
+                    const bool swing = table.table[f].p[i].z_ > limit;
+                    if (swing) {
+                        ++swingFrames;
+                        if (table.table[prev].p[i].z_ <= limit) {
+                            ++lifts;
+                            liftFrame = prev;
+                        }
+                    }
+                }
+                if (lifts != 1 || swingFrames + 1 >= table.length) {
+                    return false;
+                }
+                out[i].liftFrame = liftFrame;
+                out[i].swingFrames = swingFrames + 1;
+            }
+            return true;
+        }
+
+        // 按摆动进度取单腿位置：progress 0~1 为摆动段，1~2 为支撑段；帧之间线性插值（与正常迭代一致）
+        hexapod::Point3D sampleLeg(const QuadMovementTable& table, const QuadLegSwing& swing, int leg, float progress) {
+            float frame = progress < 1.0f
+                ? progress * swing.swingFrames
+                : swing.swingFrames + (progress - 1.0f) * (table.length - swing.swingFrames);
+            frame += swing.liftFrame;
+            const int base = static_cast<int>(floorf(frame));
+            const float t = frame - base;
+            const int f0 = base % table.length;
+            const int f1 = (f0 + 1) % table.length;
+            hexapod::Point3D p = table.table[f0].p[leg];
+            p += (table.table[f1].p[leg] - p) * t;
+            return p;
+        }
+
         inline int entryIndexOf(const QuadMovementTable& table) {
             if (!table.entries || table.entriesCount <= 0 || table.length <= 0) {
                 return 0;
@@ -279,21 +346,37 @@ namespace quadruped {
           position_{},
           index_{0},
           remainTime_{0},
-          speed_{config::defaultSpeed} {
+          speed_{config::defaultSpeed},
+          requestedGait_{gait} {
     }
 
     void QuadMovement::setMode(MovementMode newMode) {
         requestedMode_ = newMode;
 
+        // 步态过渡中：加快完成过渡，结束后按新步态重新规划（见 nextGaitMorph）
+        if (morphing_) {
+            if (requestedMode_ != mode_) {
+                const float rate = (1.0f - morphWeight_) / kMorphInterruptCycles;
+                if (rate > morphRate_) morphRate_ = rate;
+            }
+            return;
+        }
+
+        // 待机与姿态动作的表不分步态：此前推迟的步态请求直接生效，按新步态规划切换
+        if (!isLocomotionMode(mode_)) {
+            gaitMode_ = requestedGait_;
+        }
+
         // 若处于过渡中（grounding/aligning），新请求到来则直接打断，按新目标重新规划
         grounding_ = false;
         groundRemainTime_ = 0;
         groundTotalTime_ = 0;
         aligning_ = false;
+        switching_ = false;
+        switchTotalTime_ = 0;
         alignLegCount_ = 0;
         alignLegPos_ = 0;
         alignPhase_ = 0;
-        alignLiftZ_ = 0.0f;
 
         if (requestedMode_ == mode_) {
             pendingSwitch_ = QUAD_SWITCH_NONE;
@@ -324,10 +407,12 @@ namespace quadruped {
             mode_ = requestedMode_;
             pendingSwitch_ = QUAD_SWITCH_NONE;
 
-            // 给一个更长的切换时长（独立于 gait step），让姿态动作切换更柔和
+            // 切换时长按关节角度差计算（独立于 gait step），让姿态动作切换更柔和
             const int actualSwitchDuration = static_cast<int>(config::movementSwitchDuration / speed_);
             const int actualStepDuration = static_cast<int>(tgt.stepDuration / speed_);
-            remainTime_ = actualSwitchDuration > actualStepDuration ? actualSwitchDuration : actualStepDuration;
+            remainTime_ = transitionDurationMs(position_, tgt.table[index_], false,
+                actualSwitchDuration > actualStepDuration ? actualSwitchDuration : actualStepDuration);
+            switching_ = true;
             return;
         }
 
@@ -347,10 +432,12 @@ namespace quadruped {
                 pendingSwitch_ = QUAD_SWITCH_NONE;
                 index_ = tgtEntry;
 
-                // 给一个更长的切换时长（独立于 gait step），让从 standby 进入 trot 更柔和
+                // 切换时长按关节角度差计算（独立于 gait step），让从 standby 进入 trot 更柔和
                 const int actualSwitchDuration = static_cast<int>(config::movementSwitchDuration / speed_);
                 const int actualStepDuration = static_cast<int>(tgt.stepDuration / speed_);
-                remainTime_ = actualSwitchDuration > actualStepDuration ? actualSwitchDuration : actualStepDuration;
+                remainTime_ = transitionDurationMs(position_, tgt.table[index_], false,
+                    actualSwitchDuration > actualStepDuration ? actualSwitchDuration : actualStepDuration);
+                switching_ = true;
                 return;
             }
 
@@ -358,30 +445,7 @@ namespace quadruped {
             alignToIndex_ = tgtEntry;
             alignTarget_ = tgt.table[alignToIndex_];
 
-            // 构造对齐腿序：目标 entry 若存在悬空腿，则最后动
-            constexpr float kSkipDist2 = 1.0f;
-            static const int kOrder[4] = {0, 2, 3, 1};
-            int groundLegs[4] {0, 0, 0, 0};
-            int airLegs[4] {0, 0, 0, 0};
-            int groundCount = 0;
-            int airCount = 0;
-
-            for (int i = 0; i < 4; ++i) {
-                const int leg = kOrder[i];
-                if (dist2Point(position_.p[leg], alignTarget_.p[leg]) <= kSkipDist2) {
-                    continue;
-                }
-                if (isAirLegAt(alignTarget_, leg)) {
-                    airLegs[airCount++] = leg;
-                } else {
-                    groundLegs[groundCount++] = leg;
-                }
-            }
-
-            alignLegCount_ = 0;
-            for (int i = 0; i < groundCount; ++i) alignLegs_[alignLegCount_++] = groundLegs[i];
-            for (int i = 0; i < airCount; ++i) alignLegs_[alignLegCount_++] = airLegs[i];
-
+            buildAlignOrder();
             if (alignLegCount_ <= 0) {
                 // 已对齐：直接切到目标模式，从 entry 开始迭代
                 mode_ = requestedMode_;
@@ -396,24 +460,8 @@ namespace quadruped {
             pendingSwitch_ = QUAD_SWITCH_NONE;
             alignLegPos_ = 0;
             alignPhase_ = 0;
-
-            const int leg = alignLegs_[alignLegPos_];
-            const float z0 = position_.p[leg].z_;
-            const float zt = alignTarget_.p[leg].z_;
-            if (isAirLegAt(alignTarget_, leg)) {
-                // 目标本身是悬空腿：Z-first 直接抬到目标 Z（避免 +18mm 造成“腿抬太高/夹角怪”）
-                alignLiftZ_ = zt;
-            } else {
-                constexpr float kLiftHeightMm = 18.0f;
-                const float zBase = (z0 > zt) ? z0 : zt;
-                alignLiftZ_ = zBase + kLiftHeightMm;
-            }
-            remainTime_ = alignPhaseDurationMs(alignPhase_, speed_);
-            alignPhaseTotalTime_ = remainTime_;
-            alignPhaseStart_ = position_;
-            alignPhaseTarget_ = position_;
             // phase=0: lift(Z-first)
-            alignPhaseTarget_.p[leg].z_ = alignLiftZ_;
+            beginAlignStep();
             return;
         }
 
@@ -429,17 +477,16 @@ namespace quadruped {
     }
 
     void QuadMovement::setGaitMode(QuadGaitMode gait) {
-        // 仅在稳定 standby 允许切换步态（避免打断停靠/对齐流程）。
-        if (mode_ != MOVEMENT_STANDBY ||
-            requestedMode_ != MOVEMENT_STANDBY ||
-            pendingSwitch_ != QUAD_SWITCH_NONE ||
-            grounding_ ||
-            aligning_) {
-            LOG_INFO("[QuadMovement] Ignore gait switch: not in stable standby.");
-            return;
+        requestedGait_ = gait;
+        // 稳定 standby 立即切换；其余情况在 next() 的帧边界处理（避免打断停靠/对齐流程）
+        if (!morphing_ &&
+            mode_ == MOVEMENT_STANDBY &&
+            requestedMode_ == MOVEMENT_STANDBY &&
+            pendingSwitch_ == QUAD_SWITCH_NONE &&
+            !grounding_ &&
+            !aligning_) {
+            gaitMode_ = gait;
         }
-
-        gaitMode_ = gait;
     }
 
     const QuadLocations& QuadMovement::next(int elapsedMs) {
@@ -459,28 +506,7 @@ namespace quadruped {
                 const QuadMovementTable& tgt = tableForMode(alignToMode_);
                 alignTarget_ = tgt.table[alignToIndex_];
 
-                constexpr float kSkipDist2 = 1.0f;
-                static const int kOrder[4] = {0, 2, 3, 1};
-                int groundLegs[4] {0, 0, 0, 0};
-                int airLegs[4] {0, 0, 0, 0};
-                int groundCount = 0;
-                int airCount = 0;
-
-                for (int i = 0; i < 4; ++i) {
-                    const int leg = kOrder[i];
-                    if (dist2Point(position_.p[leg], alignTarget_.p[leg]) <= kSkipDist2) {
-                        continue;
-                    }
-                    if (isAirLegAt(alignTarget_, leg)) {
-                        airLegs[airCount++] = leg;
-                    } else {
-                        groundLegs[groundCount++] = leg;
-                    }
-                }
-
-                alignLegCount_ = 0;
-                for (int i = 0; i < groundCount; ++i) alignLegs_[alignLegCount_++] = groundLegs[i];
-                for (int i = 0; i < airCount; ++i) alignLegs_[alignLegCount_++] = airLegs[i];
+                buildAlignOrder();
 
                 if (alignLegCount_ <= 0) {
                     // 对齐完成：切到目标模式，从 entry 开始
@@ -496,21 +522,7 @@ namespace quadruped {
                 aligning_ = true;
                 alignLegPos_ = 0;
                 alignPhase_ = 0;
-                const int leg = alignLegs_[alignLegPos_];
-                const float z0 = position_.p[leg].z_;
-                const float zt = alignTarget_.p[leg].z_;
-                if (isAirLegAt(alignTarget_, leg)) {
-                    alignLiftZ_ = zt;
-                } else {
-                    constexpr float kLiftHeightMm = 18.0f;
-                    const float zBase = (z0 > zt) ? z0 : zt;
-                    alignLiftZ_ = zBase + kLiftHeightMm;
-                }
-                remainTime_ = alignPhaseDurationMs(alignPhase_, speed_);
-                alignPhaseTotalTime_ = remainTime_;
-                alignPhaseStart_ = position_;
-                alignPhaseTarget_ = position_;
-                alignPhaseTarget_.p[leg].z_ = alignLiftZ_;
+                beginAlignStep();
                 // 继续走 aligning_ 分支（不丢 elapsedMs）
             } else {
                 if (elapsedMs >= groundRemainTime_)
@@ -567,39 +579,12 @@ namespace quadruped {
                     return position_;
                 }
 
-                // 注意：alignLiftZ_ 只能在“开始一条新腿(phase=0)”时计算。
-                // 否则在同一条腿的 phase 0->1->2 过程中重复叠加，会导致抬腿高度越来越高，
-                // 最终出现“戳地/砸地”。
+                // 为当前 phase 设置“起点/终点”，用于平滑插值（尤其是落脚避免“戳地”）；
+                // 新的一条腿（phase=0）先计算抬腿高度
                 if (alignPhase_ == 0) {
-                    const int nextLeg = alignLegs_[alignLegPos_];
-                    const float z0 = position_.p[nextLeg].z_;
-                    const float zt = alignTarget_.p[nextLeg].z_;
-                    if (isAirLegAt(alignTarget_, nextLeg)) {
-                        alignLiftZ_ = zt;
-                    } else {
-                        constexpr float kLiftHeightMm = 18.0f;
-                        const float zBase = (z0 > zt) ? z0 : zt;
-                        alignLiftZ_ = zBase + kLiftHeightMm;
-                    }
-                }
-                remainTime_ = alignPhaseDurationMs(alignPhase_, speed_);
-
-                // 为当前 phase 设置“起点/终点”，用于平滑插值（尤其是落脚避免“戳地”）
-                alignPhaseTotalTime_ = remainTime_;
-                alignPhaseStart_ = position_;
-                alignPhaseTarget_ = position_;
-                const int curLeg = alignLegs_[alignLegPos_];
-                if (alignPhase_ == 0) {
-                    // lift(Z-first)
-                    alignPhaseTarget_.p[curLeg].z_ = alignLiftZ_;
-                } else if (alignPhase_ == 1) {
-                    // moveXY
-                    alignPhaseTarget_.p[curLeg].x_ = alignTarget_.p[curLeg].x_;
-                    alignPhaseTarget_.p[curLeg].y_ = alignTarget_.p[curLeg].y_;
-                    alignPhaseTarget_.p[curLeg].z_ = alignLiftZ_;
+                    beginAlignStep();
                 } else {
-                    // lower(to target)
-                    alignPhaseTarget_.p[curLeg] = alignTarget_.p[curLeg];
+                    startAlignPhase();
                 }
             }
 
@@ -618,6 +603,11 @@ namespace quadruped {
             return position_;
         }
 
+        // ---- 步态过渡 ----
+        if (morphing_) {
+            return nextGaitMorph(elapsedMs);
+        }
+
         // ---- 正常迭代（含 pending switch 触发）----
         const QuadMovementTable* table = &currentTable();
         int actualStepDuration = static_cast<int>(table->stepDuration / speed_);
@@ -629,22 +619,27 @@ namespace quadruped {
             const int curEntry = entryIndexOf(*table);
             if (index_ == curEntry) {
                 if (pendingSwitch_ == QUAD_SWITCH_WAIT_ENTRY_PAIR) {
-                    // 组内切换：在 entry 处瞬时跳表到目标模式的 entry
+                    // 组内切换：在 entry 处跳表到目标模式的 entry。两个 entry 不一定等效（如 trot -> standby
+                    // 时两条腿还悬在空中），按关节角度差计算时长，smoothstep 插值过去，不瞬移
                     const QuadMovementTable& tgt = tableForMode(requestedMode_);
                     if (tgt.table && tgt.length > 0) {
                         const int tgtEntry = entryIndexOf(tgt);
                         mode_ = requestedMode_;
                         pendingSwitch_ = QUAD_SWITCH_NONE;
                         index_ = tgtEntry;
-                        position_ = tgt.table[tgtEntry]; // entry 等效，直接对齐以消除累计误差
-                        remainTime_ = 0;                 // 立即进入下一帧
                         table = &currentTable();         // 更新 table/stepDuration
                         actualStepDuration = static_cast<int>(table->stepDuration / speed_);
+                        switchStart_ = position_;
+                        switchTotalTime_ = transitionDurationMs(position_, tgt.table[tgtEntry], true, actualStepDuration);
+                        remainTime_ = switchTotalTime_;
+                        switching_ = true;
                     } else {
                         pendingSwitch_ = QUAD_SWITCH_NONE;
                     }
                 } else {
-                    // 跨组切换：entry-ground -> aligning(to target entry)
+                    // 跨组切换：entry-ground -> aligning(to target entry)。反正要逐腿重新对齐，
+                    // 推迟的步态请求在这里直接生效，不必先按旧步态走目标模式再做相位过渡
+                    gaitMode_ = requestedGait_;
                     const QuadMovementTable& tgt = tableForMode(requestedMode_);
                     if (!tgt.table || tgt.length <= 0) {
                         pendingSwitch_ = QUAD_SWITCH_NONE;
@@ -657,11 +652,12 @@ namespace quadruped {
                         groundTarget_ = makeEntryGround(table->table[curEntry]);
                         // entry-ground 的落地过程也要更慢一些，否则会有“砸地/晃”的感觉
                         constexpr int kGroundMsBase = 120;
-                        groundTotalTime_ = roundUpTo(
+                        int groundFallbackMs = roundUpTo(
                             static_cast<int>(static_cast<float>(kGroundMsBase) / speed_),
                             hexapod::config::movementInterval);
-                        if (groundTotalTime_ < hexapod::config::movementInterval)
-                            groundTotalTime_ = hexapod::config::movementInterval;
+                        if (groundFallbackMs < hexapod::config::movementInterval)
+                            groundFallbackMs = hexapod::config::movementInterval;
+                        groundTotalTime_ = transitionDurationMs(position_, groundTarget_, true, groundFallbackMs);
                         groundRemainTime_ = groundTotalTime_;
                         groundStart_ = position_;
                         grounding_ = true;
@@ -673,6 +669,31 @@ namespace quadruped {
             }
         }
 
+        // ---- 推迟的步态请求：模式稳定后在帧边界生效（此时 position_ 恰好是当前帧）----
+        if (requestedGait_ != gaitMode_ && requestedMode_ == mode_ && remainTime_ <= 0) {
+            if (!isLocomotionMode(mode_)) {
+                gaitMode_ = requestedGait_;
+                table = &currentTable();
+                actualStepDuration = static_cast<int>(table->stepDuration / speed_);
+            } else if (startGaitMorph()) {
+                return nextGaitMorph(elapsedMs);
+            }
+        }
+
+        // ---- entry 处组内切换的插值 ----
+        if (switching_ && switchTotalTime_ > 0) {
+            if (elapsedMs >= remainTime_)
+                elapsedMs = remainTime_;
+            remainTime_ -= elapsedMs;
+            const float p = 1.0f - static_cast<float>(remainTime_) / static_cast<float>(switchTotalTime_);
+            position_ = lerpLocations(switchStart_, table->table[index_], smoothstep(p));
+            if (remainTime_ <= 0) {
+                switching_ = false;
+                switchTotalTime_ = 0;
+            }
+            return position_;
+        }
+
         // ---- 正常 gait 帧推进 ----
         if (remainTime_ <= 0) {
             index_ = (index_ + 1) % table->length;
@@ -688,9 +709,212 @@ namespace quadruped {
             position_.p[i] += diff * ratio;
         }
         remainTime_ -= elapsedMs;
+        if (remainTime_ <= 0) {
+            switching_ = false;
+        }
         return position_;
     }
 
+    bool QuadMovement::startGaitMorph() {
+        const QuadMovementTable& from = currentTable();
+        const QuadMovementTable& to = selectTable(requestedGait_, mode_);
+        if (!analyzeSwings(from, morphFromLegs_) || !analyzeSwings(to, morphToLegs_)) {
+            return false;
+        }
+
+        // 各腿抬腿相位之差扣除一个公共偏移后才是真正要改变的量；公共偏移取使总变化量最小的一个
+        // （最优值必在某条腿的相位差上）
+        float delta[4];
+        for (int i = 0; i < 4; ++i) {
+            delta[i] = static_cast<float>(morphToLegs_[i].liftFrame) / to.length
+                     - static_cast<float>(morphFromLegs_[i].liftFrame) / from.length;
+        }
+        float bestCost = 0.0f;
+        for (int j = 0; j < 4; ++j) {
+            float cost = 0.0f;
+            for (int i = 0; i < 4; ++i) {
+                cost += fabsf(wrapPhaseDelta(delta[i] - delta[j]));
+            }
+            if (j == 0 || cost < bestCost) {
+                bestCost = cost;
+                morphShift_ = delta[j];
+            }
+        }
+        float maxShift = 0.0f;
+        for (int i = 0; i < 4; ++i) {
+            morphLiftShift_[i] = wrapPhaseDelta(delta[i] - morphShift_);
+            if (fabsf(morphLiftShift_[i]) > maxShift) maxShift = fabsf(morphLiftShift_[i]);
+        }
+
+        morphPhase_ = static_cast<float>(index_) / from.length;
+        morphWeight_ = 0.0f;
+        morphRate_ = maxShift > kMorphSingleCycleShift ? 0.5f : 1.0f;
+        morphToGait_ = requestedGait_;
+        morphing_ = true;
+        LOG_INFO("[QuadMovement] Gait morph %d -> %d over %d cycle(s).", gaitMode_, morphToGait_, morphRate_ < 1.0f ? 2 : 1);
+        return true;
+    }
+
+    const QuadLocations& QuadMovement::nextGaitMorph(int elapsedMs) {
+        const QuadMovementTable& from = currentTable();
+        const QuadMovementTable& to = selectTable(morphToGait_, mode_);
+        const float fromCycleMs = static_cast<float>(from.length * from.stepDuration);
+        const float toCycleMs = static_cast<float>(to.length * to.stepDuration);
+
+        // 周期按 weight 在两种步态之间插值；相位与 weight 一起推进
+        float w = morphWeight_;
+        const float dPhase = static_cast<float>(elapsedMs) * speed_ / (fromCycleMs + (toCycleMs - fromCycleMs) * w);
+        morphPhase_ = wrapPhase(morphPhase_ + dPhase);
+        morphWeight_ += dPhase * morphRate_;
+        if (morphWeight_ > 1.0f) morphWeight_ = 1.0f;
+        w = morphWeight_;
+
+        // 每条腿：抬腿相位与摆动段占比插值（摆动段时长按毫秒插值），在两张表的同一摆动进度上取位置再按 weight 混合；
+        // weight=0 时恰好是原表的插值结果，weight=1 时恰好是目标表
+        const float cycleMs = fromCycleMs + (toCycleMs - fromCycleMs) * w;
+        for (int i = 0; i < 4; ++i) {
+            const float fromSwingMs = static_cast<float>(morphFromLegs_[i].swingFrames * from.stepDuration);
+            const float toSwingMs = static_cast<float>(morphToLegs_[i].swingFrames * to.stepDuration);
+            const float swingRatio = (fromSwingMs + (toSwingMs - fromSwingMs) * w) / cycleMs;
+            const float liftPhase = static_cast<float>(morphFromLegs_[i].liftFrame) / from.length + morphLiftShift_[i] * w;
+            const float u = wrapPhase(morphPhase_ - liftPhase);
+            const float progress = u < swingRatio ? u / swingRatio : 1.0f + (u - swingRatio) / (1.0f - swingRatio);
+
+            hexapod::Point3D p = sampleLeg(from, morphFromLegs_[i], i, progress);
+            p += (sampleLeg(to, morphToLegs_[i], i, progress) - p) * w;
+            position_.p[i] = p;
+            morphSwing_[i] = progress < 1.0f;
+        }
+
+        if (morphWeight_ >= 1.0f) {
+            // 交给目标表：从当前相位所在帧的下一帧继续，剩余时间按相位折算（位置已在两帧之间的连线上）
+            morphing_ = false;
+            gaitMode_ = morphToGait_;
+            const float frame = wrapPhase(morphPhase_ + morphShift_) * to.length;
+            const int nextFrame = static_cast<int>(floorf(frame)) + 1;
+            const int actualStepDuration = static_cast<int>(to.stepDuration / speed_);
+            remainTime_ = static_cast<int>((nextFrame - frame) * actualStepDuration + 0.5f);
+            index_ = nextFrame % to.length;
+            if (requestedMode_ != mode_) {
+                setMode(requestedMode_);
+            }
+        }
+        return position_;
+    }
+
+    int QuadMovement::transitionDurationMs(const QuadLocations& from, const QuadLocations& to,
+                                           bool smooth, int fallbackMs) const {
+        if (!transitionTimer_) {
+            return fallbackMs;
+        }
+        float travelMs = transitionTimer_(from, to);
+        if (smooth) {
+            travelMs *= transition::kSmoothstepPeakRatio;
+        }
+        return transition::durationMs(travelMs, speed_, 0);
+    }
+
+    void QuadMovement::buildAlignOrder() {
+        // 对齐腿序：斜对角顺序，目标 entry 的悬空腿最后动；已在目标位置的腿跳过
+        constexpr float kSkipDist2 = 1.0f;
+        static const int kOrder[4] = {0, 2, 3, 1};
+        int groundLegs[4] {0, 0, 0, 0};
+        int airLegs[4] {0, 0, 0, 0};
+        int groundCount = 0;
+        int airCount = 0;
+
+        for (int i = 0; i < 4; ++i) {
+            const int leg = kOrder[i];
+            if (dist2Point(position_.p[leg], alignTarget_.p[leg]) <= kSkipDist2) {
+                continue;
+            }
+            if (isAirLegAt(alignTarget_, leg)) {
+                airLegs[airCount++] = leg;
+            } else {
+                groundLegs[groundCount++] = leg;
+            }
+        }
+
+        alignLegCount_ = 0;
+        for (int i = 0; i < groundCount; ++i) alignLegs_[alignLegCount_++] = groundLegs[i];
+        for (int i = 0; i < airCount; ++i) alignLegs_[alignLegCount_++] = airLegs[i];
+    }
+
+    void QuadMovement::beginAlignStep() {
+        // 抬腿高度只在一条腿开始时计算：同一条腿 phase 0->1->2 中重复叠加会导致抬腿越来越高，最终“戳地/砸地”
+        const int leg = alignLegs_[alignLegPos_];
+        const float z0 = position_.p[leg].z_;
+        const float zt = alignTarget_.p[leg].z_;
+        if (isAirLegAt(alignTarget_, leg)) {
+            // 目标本身是悬空腿：Z-first 直接抬到目标 Z（避免 +18mm 造成“腿抬太高/夹角怪”）
+            alignLiftZ_ = zt;
+        } else {
+            constexpr float kLiftHeightMm = 18.0f;
+            const float zBase = (z0 > zt) ? z0 : zt;
+            alignLiftZ_ = zBase + kLiftHeightMm;
+        }
+        startAlignPhase();
+    }
+
+    void QuadMovement::startAlignPhase() {
+        const int leg = alignLegs_[alignLegPos_];
+        alignPhaseStart_ = position_;
+        alignPhaseTarget_ = position_;
+        if (alignPhase_ == 0) {
+            // lift(Z-first)
+            alignPhaseTarget_.p[leg].z_ = alignLiftZ_;
+        } else if (alignPhase_ == 1) {
+            // moveXY
+            alignPhaseTarget_.p[leg].x_ = alignTarget_.p[leg].x_;
+            alignPhaseTarget_.p[leg].y_ = alignTarget_.p[leg].y_;
+            alignPhaseTarget_.p[leg].z_ = alignLiftZ_;
+        } else {
+            // lower(to target)
+            alignPhaseTarget_.p[leg] = alignTarget_.p[leg];
+        }
+        remainTime_ = transitionDurationMs(alignPhaseStart_, alignPhaseTarget_, true,
+                                           alignPhaseDurationMs(alignPhase_, speed_));
+        alignPhaseTotalTime_ = remainTime_;
+    }
+
+    void QuadMovement::contactStates(bool* contact) const {
+        if (morphing_) {
+            for (int i = 0; i < 4; ++i) {
+                contact[i] = !morphSwing_[i];
+            }
+            return;
+        }
+
+        if (grounding_ || aligning_) {
+            for (int i = 0; i < 4; ++i) {
+                contact[i] = !isAirLegAt(position_, i);
+            }
+            if (aligning_ && alignLegPos_ < alignLegCount_) {
+                contact[alignLegs_[alignLegPos_]] = false;
+            }
+            return;
+        }
+
+        const QuadMovementTable& table = currentTable();
+        for (int i = 0; i < 4; ++i) {
+            contact[i] = true;
+        }
+        if (!hexapod::isLocomotionMode(mode_) || !table.table || table.length <= 1) {
+            return;
+        }
+
+        // 本帧已到达时，下一个目标是 index_ + 1
+        const int target = remainTime_ > 0 ? index_ : (index_ + 1) % table.length;
+        for (int i = 0; i < 4; ++i) {
+            float stanceZ = table.table[0].p[i].z_;
+            for (int f = 1; f < table.length; ++f) {
+                if (table.table[f].p[i].z_ < stanceZ) stanceZ = table.table[f].p[i].z_;
+            }
+            const float limit = stanceZ + hexapod::kSwingLiftThresholdMm;
+            contact[i] = position_.p[i].z_ <= limit && table.table[target].p[i].z_ <= limit;
+        }
+    }
+
     void QuadMovement::setSpeed(float speed) {
         if (speed < config::minSpeed)
             speed = config::minSpeed;
@@ -3,6 +3,8 @@
 #include "movement.h"
 #include "quad_tables.h"
 
+#include <functional>
+
 namespace quadruped {
 
     enum QuadGaitMode {
@@ -21,17 +23,56 @@ namespace quadruped {
         QUAD_SWITCH_WAIT_ENTRY_ALIGN,
     };
 
+    // 步态表中单腿的摆动段（每周期一段）：liftFrame 为抬腿前最后一个支撑帧，swingFrames 为摆动段帧数（含落地帧）
+    struct QuadLegSwing {
+        int liftFrame;
+        int swingFrames;
+    };
+
     // 四足版本的 Movement，实现与 hexapod::Movement 类似的插值逻辑
     class QuadMovement {
     public:
+        // 过渡计时：足端从 from 插值到 to 所需的最短时长（ms，1.0 倍速，线性插值），由持有腿运动学的一方提供
+        using TransitionTimer = std::function<float(const QuadLocations& from, const QuadLocations& to)>;
+
         explicit QuadMovement(hexapod::MovementMode mode,
                               QuadGaitMode gait = QUAD_GAIT_CREEP);
 
+        // 设置后切换插值、落地与逐腿对齐各段的时长按关节空间距离计算（见 transition_timing.h），
+        // 否则使用固定时长
+        void setTransitionTimer(TransitionTimer timer) { transitionTimer_ = timer; }
+
         void setMode(hexapod::MovementMode newMode);
+        // 待机/姿态动作时立即生效（这些表不分步态）；行走中在下一个帧边界开始相位保持的步态过渡：
+        // 各腿抬腿相位与占空比在 1~2 个周期内逐渐变为目标步态，不回到待机；
+        // 等待 entry、落地或逐腿对齐期间先记下，模式稳定后再开始
         void setGaitMode(QuadGaitMode gait);
+        // 当前执行的步态（过渡期间仍为原步态，过渡结束才变为目标步态）
+        QuadGaitMode gaitMode() const { return gaitMode_; }
+        QuadGaitMode requestedGaitMode() const { return requestedGait_; }
+        bool isGaitMorphing() const { return morphing_; }
 
         const QuadLocations& next(int elapsedMs);
 
+        // 当前足端位置（上一次 next() 的结果）
+        const QuadLocations& position() const { return position_; }
+
+        // 触地状态（contact[4]）：正常步态按相位判断（同 hexapod::Movement::contactStates）；
+        // 落地/逐腿对齐过渡期间正在对齐的腿与高于最低足端的腿视为悬空
+        void contactStates(bool* contact) const;
+
+        // creep/walk 依靠三腿支撑保持静态平衡，切换过渡（落地/逐腿对齐）同样是准静态的；
+        // trot 为双腿支撑，gallop 表的三腿支撑相重心本就会越出支撑多边形，二者都属于动态步态
+        // 切换过渡中：等待 entry、落地、逐腿对齐，或直接切换后插值到新模式首帧
+        bool isTransiting() const {
+            return requestedMode_ != mode_ || pendingSwitch_ != QUAD_SWITCH_NONE || grounding_ || aligning_ || switching_;
+        }
+
+        // 步态过渡期间两种步态都是静态步态才算
+        bool isStaticallyBalanced() const {
+            return grounding_ || aligning_ || (isStaticGait(gaitMode_) && (!morphing_ || isStaticGait(morphToGait_)));
+        }
+
         // 当前实际执行的 mode（切换过程中可能与 requestedMode_ 不同）
         hexapod::MovementMode executedMode() const { return mode_; }
 
@@ -43,9 +84,26 @@ namespace quadruped {
         float cycleDurationMsForMode(hexapod::MovementMode mode) const;
 
     private:
+        static bool isStaticGait(QuadGaitMode gait) {
+            return gait == QUAD_GAIT_WALK || gait == QUAD_GAIT_CREEP;
+        }
+
         const QuadMovementTable& currentTable() const;
         const QuadMovementTable& tableForMode(hexapod::MovementMode mode) const;
 
+        // from -> to 的过渡时长（ms，已按速度缩放）；smooth 表示按 smoothstep 插值；没有计时器时返回 fallbackMs
+        int transitionDurationMs(const QuadLocations& from, const QuadLocations& to, bool smooth, int fallbackMs) const;
+        // 按当前位置与 alignTarget_ 构造对齐腿序（alignLegs_ / alignLegCount_）
+        void buildAlignOrder();
+        // 开始对齐 alignLegs_[alignLegPos_]：计算抬腿高度，进入 phase 0
+        void beginAlignStep();
+        // 按 alignPhase_ 设置当前腿本段的起点/终点与时长
+        void startAlignPhase();
+        // 在帧边界开始从 gaitMode_ 到 requestedGait_ 的步态过渡；两张表不能按相位过渡时返回 false
+        bool startGaitMorph();
+        // 步态过渡的一个控制周期，weight 到 1 时交给目标步态的表继续迭代
+        const QuadLocations& nextGaitMorph(int elapsedMs);
+
     private:
         hexapod::MovementMode mode_;
         hexapod::MovementMode requestedMode_;
@@ -56,6 +114,12 @@ namespace quadruped {
         int index_{0};
         int remainTime_{0};
         float speed_;
+        bool switching_{false};  // 直接切换（standby/姿态/trot 入场）后的首段插值
+        // entry 处的组内切换：从 switchStart_ 按 smoothstep 插值到目标 entry，时长按关节角度差计算；
+        // 为 0 时 switching_ 按普通帧推进（线性）插值
+        QuadLocations switchStart_{};
+        int switchTotalTime_{0};
+        TransitionTimer transitionTimer_;
 
         // ---- entry-ground：把当前 entry 的悬空腿落地，形成稳定的“四足触地”姿态 ----
         bool grounding_{false};
@@ -77,6 +141,19 @@ namespace quadruped {
         int alignLegPos_{0};
         int alignPhase_{0}; // 0=lift(Z-first), 1=moveXY, 2=lower(to target if needed)
         float alignLiftZ_{0.0f};
+
+        // ---- 步态过渡：行走中相位保持地切换步态 ----
+        QuadGaitMode requestedGait_;
+        bool morphing_{false};
+        QuadGaitMode morphToGait_{QUAD_GAIT_CREEP};
+        QuadLegSwing morphFromLegs_[4] {};
+        QuadLegSwing morphToLegs_[4] {};
+        float morphPhase_{0.0f};          // 全局相位（周期的比例，0~1），开始时等于原步态表的相位
+        float morphWeight_{0.0f};         // 0=原步态，1=目标步态
+        float morphRate_{1.0f};           // 每个周期 weight 的增量
+        float morphShift_{0.0f};          // 过渡结束时目标表的相位 = 全局相位 + morphShift_
+        float morphLiftShift_[4] {};      // 各腿抬腿相位的总变化量（-0.5~0.5 个周期）
+        bool morphSwing_[4] {};           // 各腿当前是否处于摆动段（触地状态）
     };
 
 } // namespace quadruped
@@ -2,26 +2,70 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
-#include <SPIFFS.h>
+#include "storage.h"
 
 #include "quad_robot.h"
 #include "debug.h"
 #include "config.h"
+#include "transition_timing.h"
+
+#include <cmath>
 
 namespace quadruped {
 
     using namespace hexapod;
 
+    namespace {
+        // 四足机体小、支撑多边形窄：阈值低于六足默认值，停顿也更短
+        stability::Config stabilityConfig() {
+            stability::Config config;
+            config.slowMarginMm = 12.0f;
+            config.pauseMarginMm = 3.0f;
+            config.minTimeScale = 0.5f;
+            config.settleMs = 60;
+            return config;
+        }
+
+        // creep 的 forwardfast 步幅超出舵机行程、shiftleft/shiftright 的进出对齐会越限（见 sim/gait_sim），
+        // 自动步态在这些模式下不选 creep
+        inline bool creepClampsIn(MovementMode mode) {
+            return mode == MOVEMENT_FORWARDFAST
+                || mode == MOVEMENT_SHIFTLEFT
+                || mode == MOVEMENT_SHIFTRIGHT;
+        }
+    }
+
     QuadRobot::QuadRobot()
         : speed_{config::defaultSpeed},
           legs_{Leg(0), Leg(1), Leg(2), Leg(3)},
           mode_{MOVEMENT_STANDBY},
-          movement_{MOVEMENT_STANDBY, QUAD_GAIT_CREEP} {
+          movement_{MOVEMENT_STANDBY, QUAD_GAIT_CREEP},
+          stability_{stabilityConfig()} {
+        // 过渡时长按各腿沿插值路径的关节角度变化与关节限速计算
+        movement_.setTransitionTimer([this](const QuadLocations& from, const QuadLocations& to) {
+            float slowest = 0.0f;
+            for (int i = 0; i < 4; ++i) {
+                float angles[transition::kPathSegments + 1][3];
+                for (int s = 0; s <= transition::kPathSegments; ++s) {
+                    Point3D tip = from.p[i];
+                    tip += (to.p[i] - from.p[i]) * (static_cast<float>(s) / transition::kPathSegments);
+                    legs_[i].jointAnglesFor(tip, angles[s]);
+                }
+                const float ms = transition::pathTravelMs(angles, transition::kPathSegments,
+                                                          config::quadJointSpeedLimitDegPerSec);
+                if (ms > slowest) {
+                    slowest = ms;
+                }
+            }
+            return slowest;
+        });
     }
 
     void QuadRobot::init(bool setting, bool isReset) {
         ServoQuad::init();
         calibrationLoad();
+        // 驱动板可能刚复位（或校准参数已变）：不再信任上一次下发的 tick
+        invalidateServos();
 
         if (isReset) {
             forceResetAllLegTippos();
@@ -39,15 +83,138 @@ namespace quadruped {
     }
 
     void QuadRobot::processMovement(MovementMode mode, int elapsedMs) {
+        refreshServos(elapsedMs);
+
         if (mode_ != mode) {
             mode_ = mode;
+            // 自动步态与模式有关（见 autoGaitFor），先更新步态，跨组切换时按新步态对齐
+            if (autoGait_) {
+                applyGait(autoGaitFor(speed_), kAutoGaitMode);
+            }
             movement_.setMode(mode_);
         }
 
-        const QuadLocations& loc = movement_.next(elapsedMs);
+        // 稳定裕度：creep/walk 的三腿支撑相在高速下裕度最小（walk 每次抬腿时重心正好落在对角线上），
+        // 不足时放慢或暂停摆动；trot/gallop 为动态步态，不做调节
+        float timeScale = 1.0f;
+        if (elapsedMs > 0 && movement_.isStaticallyBalanced()) {
+            bool contact[4];
+            movement_.contactStates(contact);
+            const float pace = movement_.getSpeed() / config::maxSpeed * speedScale_;
+            timeScale = stability_.update(movement_.position().p, contact, 4, elapsedMs, pace);
+        }
+
+        const int step = clock_.advance(elapsedMs, speedScale_ * timeScale);
+        advancedMs_ = step;
+        if (elapsedMs > 0 && step <= 0) {
+            // 停顿：保持当前姿态
+            jointTravel_ = JointTravel();
+            return;
+        }
+
+        const QuadLocations& loc = movement_.next(step);
+
+        // 功率调节：行走时按 liftScale_ 压低摆动腿高度（以实际执行的 mode 判断）
+        const bool scaleLift = liftScale_ < 1.0f && isLocomotionMode(movement_.executedMode());
+        const QuadLocations& standby = standbyTable().table[0];
+        JointTravel travel;
         for (int i = 0; i < 4; ++i) {
-            legs_[i].moveTip(loc.p[i]);
+            Point3D tip = loc.p[i];
+            const float standZ = standby.p[i].z_;
+            if (scaleLift && tip.z_ > standZ) {
+                tip.z_ = standZ + (tip.z_ - standZ) * liftScale_;
+            }
+            legs_[i].moveTip(tip);
+            tips_[i] = tip;
+
+            const bool swing = tip.z_ > standZ + kSwingLiftThresholdMm;
+            for (int j = 0; j < 3; ++j) {
+                const float angle = legs_[i].get(j)->getAngle();
+                if (jointAnglesValid_) {
+                    const float delta = std::fabs(angle - jointAngles_[i][j]);
+                    if (swing) {
+                        travel.swingDeg += delta;
+                    } else {
+                        travel.stanceDeg += delta;
+                    }
+                }
+                jointAngles_[i][j] = angle;
+            }
+        }
+        jointAnglesValid_ = true;
+        jointTravel_ = travel;
+    }
+
+    void QuadRobot::invalidateServos() {
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                legs_[i].get(j)->invalidate();
+            }
+        }
+    }
+
+    void QuadRobot::refreshServos(int elapsedMs) {
+        // 每 servoRefreshIntervalMs 轮完 12 路：每次只重发一路，把 I2C 写入分散到各个控制周期；
+        // 每轮开始时检查驱动板，复位后所有通道都没有输出，立即全部重发
+        servoRefreshMs_ += elapsedMs;
+        if (servoRefreshMs_ < config::servoRefreshIntervalMs / 12) {
+            return;
         }
+        servoRefreshMs_ = 0;
+        if (servoRefreshIndex_ == 0 && ServoQuad::recoverBoard()) {
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    legs_[i].get(j)->refresh();
+                }
+            }
+            return;
+        }
+        legs_[servoRefreshIndex_ / 3].get(servoRefreshIndex_ % 3)->refresh();
+        servoRefreshIndex_ = (servoRefreshIndex_ + 1) % 12;
+    }
+
+    void QuadRobot::setPowerLimits(float speedScale, float liftScale) {
+        speedScale_ = speedScale;
+        liftScale_ = liftScale;
+    }
+
+    JointTravel QuadRobot::lastJointTravel() const {
+        return jointTravel_;
+    }
+
+    int QuadRobot::lastMovementAdvanceMs(int requestedMs) const {
+        (void)requestedMs;
+        return advancedMs_;
+    }
+
+    stability::Stats QuadRobot::stabilityStats() const {
+        return stability_.stats();
+    }
+
+    int QuadRobot::legCount() const {
+        return 4;
+    }
+
+    bool QuadRobot::footTip(int legIndex, Point3D& tip) const {
+        if (legIndex < 0 || legIndex >= 4 || !jointAnglesValid_) {
+            return false;
+        }
+        tip = tips_[legIndex];
+        return true;
+    }
+
+    bool QuadRobot::jointAngles(int legIndex, float angles[3]) const {
+        if (legIndex < 0 || legIndex >= 4 || !jointAnglesValid_) {
+            return false;
+        }
+        for (int j = 0; j < 3; ++j) {
+            angles[j] = jointAngles_[legIndex][j];
+        }
+        return true;
+    }
+
+    bool QuadRobot::isTransitioning() const {
+        return movement_.isTransiting();
     }
 
     void QuadRobot::setMovementSpeed(float speed) {
@@ -62,6 +229,10 @@ namespace quadruped {
         snprintf(buffer, sizeof(buffer), "[Quad] 运动速度已设置为: %.2f (范围: %.1f - %.1f)",
                  speed_, config::minSpeed, config::maxSpeed);
         LOG_INFO(buffer);
+
+        if (autoGait_) {
+            applyGait(autoGaitFor(speed_), kAutoGaitMode);
+        }
     }
 
     void QuadRobot::setMovementSpeedLevel(SpeedLevel level) {
@@ -94,7 +265,8 @@ namespace quadruped {
 
     void QuadRobot::calibrationSave() {
         // {"leg0": [0, 0, 0], ..., "leg3": [0, 0, 0]}
-        StaticJsonDocument<512> doc;
+        // 存在多点校准曲线的腿额外写入 "curveN": [[5 个锚点修正量] x 3]
+        StaticJsonDocument<2048> doc;
 
         for (int i = 0; i < 4; i++) {
             char leg[5];
@@ -105,19 +277,41 @@ namespace quadruped {
                 legs_[i].get(j)->getParameter(offset);
                 legData.add((short)offset);
             }
-        }
 
-        File file = SPIFFS.open(kCalibrationFilePath, FILE_WRITE);
-        if (!file) {
-            LOG_INFO("[Quad] Failed to open calibration file for writing");
-            return;
-        }
+            bool hasCurve = false;
+            for (int j = 0; j < 3; j++) {
+                for (int k = 0; k < ServoCurve::kPointCount; k++) {
+                    int correction;
+                    legs_[i].get(j)->getCurvePoint(k, correction);
+                    if (correction != 0)
+                        hasCurve = true;
+                }
+            }
+            if (!hasCurve)
+                continue;
 
-        if (serializeJson(doc, file) == 0) {
-            LOG_INFO("[Quad] Failed to write calibration to file");
+            char curve[8];
+            sprintf(curve, "curve%d", i);
+            JsonArray curveData = doc.createNestedArray(curve);
+            for (int j = 0; j < 3; j++) {
+                JsonArray jointCurve = curveData.createNestedArray();
+                for (int k = 0; k < ServoCurve::kPointCount; k++) {
+                    int correction;
+                    legs_[i].get(j)->getCurvePoint(k, correction);
+                    jointCurve.add((short)correction);
+                }
+            }
         }
 
-        file.close();
+        // 原子写入（临时文件 + rename），写到一半掉电时保留旧的校准文件
+        String output;
+        serializeJson(doc, output);
+        String error;
+        if (!storage::writeRecord(kCalibrationFilePath, output, error)) {
+            char buffer[96];
+            snprintf(buffer, sizeof(buffer), "[Quad] Failed to save calibration: %s", error.c_str());
+            LOG_INFO(buffer);
+        }
     }
 
     void QuadRobot::calibrationGet(int legIndex, int partIndex, int& offset) {
@@ -142,6 +336,11 @@ namespace quadruped {
     }
 
     void QuadRobot::calibrationSet(CalibrationData& calibrationData) {
+        if (calibrationData.curvePoint >= 0) {
+            calibrationCurveSet(calibrationData.legIndex, calibrationData.partIndex,
+                                calibrationData.curvePoint, calibrationData.curveValue);
+            return;
+        }
         calibrationSet(calibrationData.legIndex, calibrationData.partIndex, calibrationData.offset);
     }
 
@@ -159,9 +358,37 @@ namespace quadruped {
         }
     }
 
+    void QuadRobot::calibrationCurveGet(int legIndex, int partIndex, int point, int& correctionUs) {
+        if (legIndex < 0 || legIndex >= 4 || partIndex < 0 || partIndex >= 3) {
+            correctionUs = 0;
+            return;
+        }
+        legs_[legIndex].get(partIndex)->getCurvePoint(point, correctionUs);
+    }
+
+    void QuadRobot::calibrationCurveSet(int legIndex, int partIndex, int point, int correctionUs) {
+        if (legIndex < 0 || legIndex >= 4 || partIndex < 0 || partIndex >= 3)
+            return;
+
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer),
+                 "[Quad] 腿部关节舵机曲线校准: 腿部索引[%d] 关节索引[%d] 锚点[%d] 修正量[%dus]",
+                 legIndex, partIndex, point, correctionUs);
+        LOG_INFO(buffer);
+
+        legs_[legIndex].get(partIndex)->setCurvePoint(point, correctionUs, false);
+    }
+
+    void QuadRobot::calibrationCurveTest(int legIndex, int partIndex, int point) {
+        if (legIndex < 0 || legIndex >= 4 || partIndex < 0 || partIndex >= 3)
+            return;
+        legs_[legIndex].get(partIndex)->testCurvePoint(point);
+    }
+
     void QuadRobot::clearOffset() {
         for (int i = 0; i < 4; i++) {
             for (int j = 0; j < 3; j++) {
+                legs_[i].get(j)->clearCurve(false);
                 legs_[i].get(j)->setParameter(0, true);
             }
         }
@@ -174,14 +401,15 @@ namespace quadruped {
     }
 
     void QuadRobot::setGaitMode(int gaitMode) {
-        // 约束：仅允许在待机模式切换步态，避免运动中切换导致过渡畸形
-        if (mode_ != MOVEMENT_STANDBY) {
-            char buffer[96];
-            snprintf(buffer, sizeof(buffer),
-                     "[Quad] 忽略步态切换(%d)：仅待机模式允许切换步态", gaitMode);
-            LOG_INFO(buffer);
+        if (gaitMode == kAutoGaitMode) {
+            if (!autoGait_) {
+                LOG_INFO("[Quad] 自动步态：按运动速度与模式选择 CREEP/WALK/TROT");
+            }
+            autoGait_ = true;
+            applyGait(autoGaitFor(speed_), gaitMode);
             return;
         }
+        autoGait_ = false;
 
         QuadGaitMode newGait = QUAD_GAIT_TROT;
         switch (gaitMode) {
@@ -199,29 +427,78 @@ namespace quadruped {
             newGait = QUAD_GAIT_TROT;
             break;
         }
+        applyGait(newGait, gaitMode);
+    }
 
-        movement_.setGaitMode(newGait);
+    void QuadRobot::applyGait(QuadGaitMode gait, int requested) {
+        if (gait == movement_.requestedGaitMode()) {
+            return;
+        }
+        movement_.setGaitMode(gait);
 
         const char* gaitNames[] = {"TROT", "WALK", "GALLOP", "CREEP"};
-        int idx = static_cast<int>(newGait);
+        int idx = static_cast<int>(gait);
         if (idx < 0 || idx >= 4) idx = 0;
-        char buffer[80];
-        snprintf(buffer, sizeof(buffer), "[Quad] 切换步态模式为: %s(%d)", gaitNames[idx], gaitMode);
+        char buffer[112];
+        snprintf(buffer, sizeof(buffer), "[Quad] 切换步态模式为: %s(%d)%s", gaitNames[idx], requested,
+                 movement_.gaitMode() == gait ? "" : "，行走中按相位平滑过渡");
         LOG_INFO(buffer);
     }
 
+    QuadGaitMode QuadRobot::autoGaitFor(float speed) const {
+        // gallop 的三腿支撑相重心越出支撑多边形，不参与自动选择；
+        // 从当前档位出发，升档要超过阈值 + 回差，降档要低于阈值 - 回差
+        static const QuadGaitMode kLevels[3] = {QUAD_GAIT_CREEP, QUAD_GAIT_WALK, QUAD_GAIT_TROT};
+        const float thresholds[2] = {config::quadAutoGaitWalkSpeed, config::quadAutoGaitTrotSpeed};
+        const float hysteresis = config::quadAutoGaitHysteresis;
+
+        int level = 0;
+        switch (movement_.requestedGaitMode()) {
+        case QUAD_GAIT_WALK:
+            level = 1;
+            break;
+        case QUAD_GAIT_TROT:
+            level = 2;
+            break;
+        case QUAD_GAIT_CREEP:
+            level = 0;
+            break;
+        default:
+            // 手动选的 gallop：不做回差，直接按阈值选
+            level = -1;
+            break;
+        }
+        if (level < 0) {
+            level = 0;
+            while (level < 2 && speed >= thresholds[level]) ++level;
+        } else {
+            while (level < 2 && speed >= thresholds[level] + hysteresis) ++level;
+            while (level > 0 && speed < thresholds[level - 1] - hysteresis) --level;
+        }
+        if (level == 0 && creepClampsIn(mode_)) {
+            level = 1;
+        }
+        return kLevels[level];
+    }
+
+    int QuadRobot::getGaitMode() const {
+        return static_cast<int>(movement_.gaitMode());
+    }
+
     void QuadRobot::calibrationLoad() {
-        File file = SPIFFS.open(kCalibrationFilePath, FILE_READ);
-        if (!file) {
-            LOG_INFO("[Quad] No calibration file, using default servo parameters.");
+        String payload;
+        String readError;
+        if (!storage::readRecord(kCalibrationFilePath, payload, readError)) {
+            char buffer[96];
+            snprintf(buffer, sizeof(buffer), "[Quad] Calibration file unavailable (%s), using default servo parameters.", readError.c_str());
+            LOG_INFO(buffer);
             return;
         }
 
-        StaticJsonDocument<512> doc;
-        DeserializationError error = deserializeJson(doc, file);
+        StaticJsonDocument<2048> doc;
+        DeserializationError error = deserializeJson(doc, payload);
         if (error) {
             LOG_INFO("[Quad] Failed to read calibration file, using default configuration.");
-            file.close();
             return;
         }
 
@@ -241,9 +518,19 @@ namespace quadruped {
                 // 等后续 standby/动作下发时再统一 setAngle。
                 legs_[i].get(j)->setParameter(param, false);
             }
-        }
 
-        file.close();
+            // 旧版校准文件没有曲线字段，此时保持线性（曲线全零）
+            char curve[8];
+            sprintf(curve, "curve%d", i);
+            JsonArray curveData = doc[curve];
+            for (int j = 0; j < 3; j++) {
+                JsonArray jointCurve = curveData[j];
+                for (int k = 0; k < ServoCurve::kPointCount; k++) {
+                    int correction = jointCurve[k] | 0;
+                    legs_[i].get(j)->setCurvePoint(k, correction, false);
+                }
+            }
+        }
     }
 
 } // namespace quadruped
@@ -30,25 +30,62 @@ namespace quadruped {
         void calibrationSet(CalibrationData& calibrationData) override;
         void calibrationTest(int legIndex, int partIndex, float angle) override;
         void calibrationTestAllLeg(float angle) override;
+        void calibrationCurveGet(int legIndex, int partIndex, int point, int& correctionUs) override;
+        void calibrationCurveSet(int legIndex, int partIndex, int point, int correctionUs) override;
+        void calibrationCurveTest(int legIndex, int partIndex, int point) override;
         void clearOffset() override;
         void forceResetAllLegTippos() override;
 
-        // 步态模式控制：0-trot,1-walk,2-gallop,3-creep
+        // 步态模式控制：0-trot,1-walk,2-gallop,3-creep,4-自动（按速度在 creep/walk/trot 间选择）；
+        // 行走中切换步态按相位平滑过渡，不需要先回到待机（见 QuadMovement::setGaitMode）
         void setGaitMode(int gaitMode) override;
+        int getGaitMode() const override;
+        bool isAutoGait() const override { return autoGait_; }
         hexapod::MovementMode executedMovementMode(hexapod::MovementMode requestedMode) const override;
 
+        // 功率调节
+        void setPowerLimits(float speedScale, float liftScale) override;
+        hexapod::JointTravel lastJointTravel() const override;
+        int lastMovementAdvanceMs(int requestedMs) const override;
+
+        // 稳定裕度
+        stability::Stats stabilityStats() const override;
+
+        // 运动学状态
+        int legCount() const override;
+        bool footTip(int legIndex, hexapod::Point3D& tip) const override;
+        bool jointAngles(int legIndex, float angles[3]) const override;
+        bool isTransitioning() const override;
+
     private:
         void calibrationLoad();
+        void invalidateServos();
+        void refreshServos(int elapsedMs);
+        QuadGaitMode autoGaitFor(float speed) const;
+        void applyGait(QuadGaitMode gait, int requested);
 
     private:
         // 校准文件（四足）
         static constexpr const char* kCalibrationFilePath = "/calibration_quad.json";
 
         float speed_;
+        bool autoGait_{false};
 
         Leg legs_[4];
         hexapod::MovementMode mode_;
         QuadMovement movement_;
+
+        float speedScale_{1.0f};
+        float liftScale_{1.0f};
+        hexapod::ScaledClock clock_;
+        hexapod::Point3D tips_[4];
+        float jointAngles_[4][3] {};
+        bool jointAnglesValid_{false};
+        hexapod::JointTravel jointTravel_;
+        int advancedMs_{0};
+        int servoRefreshMs_{0};
+        int servoRefreshIndex_{0};  // 下一路周期重发的舵机（腿 * 3 + 关节）
+        stability::Monitor stability_;
     };
 
 } // namespace quadruped
@@ -2,14 +2,13 @@
 
 #include "quad_servo.h"
 #include "debug.h"
+#include "config.h"
 #include "pwm.h"
 
 namespace quadruped {
 
     namespace {
-        // freq = 50, 1 tick = 1000000 / (50*4096) ~= 5us
-        const static int kFrequency = 50;
-        const static int kTickUs = 5;
+        // freq 与 us->tick 换算见 config.h / hal::PCA9685（50Hz 时 1 tick ~= 4.9us）
         const static int kServoMiddle = 1500;
         const static int kServoMax = 2500;
         const static int kServoMin = 500;
@@ -24,8 +23,12 @@ namespace quadruped {
                 return;
 
             pwm.begin();
-            pwm.setPWMFreq(kFrequency);
+            pwm.setOscillatorFrequency(hexapod::config::pca9685OscillatorHz);
+            pwm.setPWMFreq(hexapod::config::servoPwmFrequency);
+            pwm.setStagger(hexapod::config::servoPwmStagger);
             pwmInited = true;
+
+            LOG_INFO("[Quad] PWM: %.1fHz (tick %.2fus)", pwm.actualFrequency(), pwm.tickUs());
         }
 
         // legIndex: 0=FR, 1=BR, 2=BL, 3=FL
@@ -47,6 +50,15 @@ namespace quadruped {
         initPWM();
     }
 
+    bool ServoQuad::recoverBoard(void) {
+        if (!pwmInited)
+            return false;
+        if (!pwm.recoverFromReset())
+            return false;
+        LOG_INFO("[Quad] PWM board was reset, re-initialized");
+        return true;
+    }
+
     ServoQuad::ServoQuad(int legIndex, int partIndex) {
         pwmIndex_ = quad2pwm(legIndex, partIndex);
         inverse_ = (partIndex == 1);        // 与六足保持一致：第二关节反向
@@ -54,6 +66,20 @@ namespace quadruped {
         range_ = (partIndex == 0) ? 45 : 60;
         angle_ = 0.0f;
         offset_ = 0;
+        lastTicks_ = -1;
+        driven_ = false;
+        rebuildCurve();
+    }
+
+    void ServoQuad::rebuildCurve() {
+        curve_.build(offset_, kServoRange / 90.0f);
+    }
+
+    void ServoQuad::testCurvePoint(int point) {
+        float angle = static_cast<float>(hexapod::ServoCurve::anchorAngle(point));
+        if (inverse_)
+            angle = -angle;
+        setAngle(angle + adjust_angle_);
     }
 
     void ServoQuad::setAngle(float angle) {
@@ -75,14 +101,24 @@ namespace quadruped {
         if (inverse_)
             angle = -angle;
 
-        int us = kServoMiddle + static_cast<int>((angle + offset_) * (kServoRange / 90.0f));
+        // 偏移量与多点校准曲线已折算进 LUT；保留小数部分，按实际 tick 长度四舍五入
+        float us = curve_.evaluate(angle);
         if (us > kServoMax)
             us = kServoMax;
         else if (us < kServoMin)
             us = kServoMin;
 
-        pwm.setPWM(idx, 0, us / kTickUs);
-        LOG_DEBUG("Quad setAngle(%.2f, %d)", angle, us);
+        // 小幅插值/待机漂移时经常算出与上次相同的 tick，此时跳过 I2C 写入
+        int ticks = pwm.usToTicks(us);
+        if (ticks == lastTicks_) {
+            hexapod::hal::recordPwmSkip();
+            return;
+        }
+
+        pwm.setPulseTicks(idx, ticks);
+        lastTicks_ = ticks;
+        driven_ = true;
+        LOG_DEBUG("Quad setAngle(%.2f, %.1f)", angle, us);
     }
 
     float ServoQuad::getAngle(void) {
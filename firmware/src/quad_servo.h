@@ -2,12 +2,17 @@
 
 #include <cstdint>
 
+#include "servo_calibration.h"
+
 namespace quadruped {
 
     // 四足版本的舵机类：使用单片 PCA9685，顺序映射 12 路通道
     class ServoQuad {
     public:
         static void init(void);
+        // 检查驱动板是否复位过（见 hal::PCA9685::recoverFromReset），复位后已重新初始化，
+        // 返回 true 时调用方需重发所有舵机
+        static bool recoverBoard(void);
 
     public:
         ServoQuad(int legIndex, int partIndex);
@@ -22,10 +27,50 @@ namespace quadruped {
 
         void setParameter(int offset, bool update = true) {
             offset_ = offset;
+            rebuildCurve();
+            if (update)
+                setAngle(angle_);
+        }
+
+        // 多点校准曲线：point 为锚点索引，correctionUs 为该锚点的脉宽修正量
+        void getCurvePoint(int point, int& correctionUs) {
+            correctionUs = curve_.getPoint(point);
+        }
+
+        void setCurvePoint(int point, int correctionUs, bool update = true) {
+            if (!curve_.setPoint(point, correctionUs))
+                return;
+            rebuildCurve();
+            if (update)
+                setAngle(angle_);
+        }
+
+        void clearCurve(bool update = true) {
+            curve_.clear();
+            rebuildCurve();
             if (update)
                 setAngle(angle_);
         }
 
+        // 将舵机转到指定锚点对应的输出角，便于目测/测量该点的误差
+        void testCurvePoint(int point);
+
+        // 脏标记：强制下一次 setAngle 重新下发 PWM（例如驱动板复位后）
+        void invalidate() {
+            lastTicks_ = -1;
+        }
+
+        // 按当前角度重新下发一次 PWM；从未输出过的舵机保持无输出（避免上电时打一帧 0°）
+        void refresh() {
+            if (!driven_)
+                return;
+            invalidate();
+            setAngle(angle_);
+        }
+
+    private:
+        void rebuildCurve();
+
     private:
         float angle_{0.0f};
         int   pwmIndex_{0};
@@ -33,6 +78,9 @@ namespace quadruped {
         int   offset_{0};
         int   range_{60};
         float adjust_angle_{0.0f};
+        hexapod::ServoCurve curve_;
+        int   lastTicks_{-1};   // 上一次下发的 tick，-1 表示需要重新下发
+        bool  driven_{false};   // 是否已经输出过 PWM
     };
 
 } // namespace quadruped
@@ -0,0 +1,70 @@
+// 可指定种子的伪随机数
+
+#include "rng.h"
+
+#include <freertos/FreeRTOS.h>
+
+namespace rng {
+
+namespace {
+
+constexpr int kSubsystemCount = static_cast<int>(Subsystem::Count);
+
+constexpr uint32_t kDefaultSeed = 0x2545F491u;
+
+Pcg32 generators[kSubsystemCount];
+bool seeded = false;
+uint32_t seedValue = 0;
+// 取一次数只有几条指令，用自旋临界区而不是互斥量（不会引起任务切换，也可在双核间互斥）
+portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+
+// 默认种子同样按子系统区分序列
+struct DefaultSeeds {
+  DefaultSeeds() {
+    for (int i = 0; i < kSubsystemCount; ++i) {
+      generators[i].seed(kDefaultSeed, static_cast<uint64_t>(i));
+    }
+  }
+} defaultSeeds;
+
+}  // namespace
+
+uint32_t next(Subsystem subsystem) {
+  portENTER_CRITICAL(&mux);
+  const uint32_t value = generators[static_cast<int>(subsystem)].next();
+  portEXIT_CRITICAL(&mux);
+  return value;
+}
+
+uint32_t below(Subsystem subsystem, uint32_t bound) {
+  portENTER_CRITICAL(&mux);
+  const uint32_t value = generators[static_cast<int>(subsystem)].below(bound);
+  portEXIT_CRITICAL(&mux);
+  return value;
+}
+
+void seedSubsystem(Subsystem subsystem, uint32_t seed) {
+  portENTER_CRITICAL(&mux);
+  generators[static_cast<int>(subsystem)].seed(seed, static_cast<uint64_t>(subsystem));
+  portEXIT_CRITICAL(&mux);
+}
+
+void seedAll(uint32_t seed) {
+  portENTER_CRITICAL(&mux);
+  for (int i = 0; i < kSubsystemCount; ++i) {
+    generators[i].seed(seed, static_cast<uint64_t>(i));
+  }
+  seeded = true;
+  seedValue = seed;
+  portEXIT_CRITICAL(&mux);
+}
+
+bool isSeeded() {
+  return seeded;
+}
+
+uint32_t lastSeed() {
+  return seedValue;
+}
+
+}  // namespace rng
@@ -0,0 +1,73 @@
+// 可指定种子的伪随机数（PCG32，与平台无关，可在主机上直接编译）
+// - 每个子系统持有独立的生成器，各自的序列互不影响：一处多取一次随机数不会改变另一处的选择
+// - 生成器状态为 64 位，32 位核上读写不是原子的；设置种子（WebSocket 指令、HTTP 会话录制）与取数
+//   （主循环的入场帧选择，主循环与 WebSocket 任务中的表演编排）可能在不同任务中，都在 portMUX 临界区内完成。
+//   临界区只包住几条整数运算，取数路径上没有互斥量/可重入锁（rand() 的 newlib 锁因此不再需要）
+// - seedAll(seed) 用同一个种子给所有子系统设置不同的 PCG 序列（stream = 子系统编号），
+//   协议 {"seed": n}、会话录制（session_recorder.h）与主机回放通过它复现随机选择
+// - 未显式设置种子时各子系统使用固定的默认种子，上电后的行为可复现；需要每次上电都不同的子系统
+//   （表演编排）在自己的 begin() 中用 seedSubsystem 设置
+#pragma once
+
+#include <cstdint>
+
+namespace rng {
+
+class Pcg32 {
+public:
+  Pcg32() { seed(0x853C49E6748FEA9Bull, 0); }
+
+  void seed(uint64_t initState, uint64_t stream) {
+    state_ = 0;
+    increment_ = (stream << 1) | 1u;
+    next();
+    state_ += initState;
+    next();
+  }
+
+  uint32_t next() {
+    const uint64_t old = state_;
+    state_ = old * 6364136223846793005ull + increment_;
+    const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+    const uint32_t rot = static_cast<uint32_t>(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+  }
+
+  // [0, bound) 内均匀分布（拒绝采样，避免取模偏差）；bound 为 0 时返回 0
+  uint32_t below(uint32_t bound) {
+    if (bound == 0) {
+      return 0;
+    }
+    const uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+    for (;;) {
+      const uint32_t r = next();
+      if (r >= threshold) {
+        return r % bound;
+      }
+    }
+  }
+
+private:
+  uint64_t state_;
+  uint64_t increment_;
+};
+
+enum class Subsystem : uint8_t {
+  MovementEntry = 0,  // 六足 Movement 切换模式时的入场帧选择
+  Performance,        // 表演编排（performance::Controller）
+  Count,
+};
+
+// 从子系统的生成器取数
+uint32_t next(Subsystem subsystem);
+uint32_t below(Subsystem subsystem, uint32_t bound);
+
+// 按子系统编号选择序列，给所有子系统设置种子
+void seedAll(uint32_t seed);
+void seedSubsystem(Subsystem subsystem, uint32_t seed);
+
+// 是否调用过 seedAll，以及最近一次的种子
+bool isSeeded();
+uint32_t lastSeed();
+
+}  // namespace rng
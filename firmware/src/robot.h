@@ -5,9 +5,40 @@
 #include "movement.h"
 #include "calibration.h"
 #include "config.h"
+#include "stability.h"
 
 namespace hexapod {
 
+    // 一个控制周期内各关节转过的角度之和（度），按支撑腿/摆动腿分开
+    struct JointTravel {
+        float stanceDeg = 0.0f;
+        float swingDeg = 0.0f;
+    };
+
+    // 按倍率推进的控制周期时间（保留小数部分，避免 20ms * 0.93 这类舍入误差逐周期累积）
+    class ScaledClock {
+    public:
+        int advance(int elapsedMs, float scale) {
+            if (elapsedMs <= 0 || scale >= 1.0f) {
+                carry_ = 0.0f;
+                return elapsedMs;
+            }
+            if (scale <= 0.0f) {
+                return 0;  // 本周期停顿
+            }
+            carry_ += elapsedMs * scale;
+            int step = static_cast<int>(carry_);
+            if (step < 1) {
+                step = 1;
+            }
+            carry_ -= step;
+            return step;
+        }
+
+    private:
+        float carry_ = 0.0f;
+    };
+
     // 统一的机器人控制抽象接口
     class RobotBase {
     public:
@@ -34,6 +65,53 @@ namespace hexapod {
             return requestedMode;
         }
 
+        // 功率调节（见 power_governor.h）：speedScale 缩放步态时间推进（不改变 getMovementSpeed()），
+        // liftScale 缩放行走时摆动腿的抬腿高度
+        virtual void setPowerLimits(float speedScale, float liftScale) {
+            (void)speedScale;
+            (void)liftScale;
+        }
+
+        // 上一次 processMovement 中各关节转过的角度，用于估算舵机功率
+        virtual JointTravel lastJointTravel() const {
+            return JointTravel();
+        }
+
+        // 上一次 processMovement 中步态实际推进的时间（ms）。功率调节与稳定裕度会放慢或停顿步态，
+        // 运动规划按此累计周期数（getMovementCycleDurationMs 不含这些临时倍率），动作序列不会因此被截短。
+        // 默认实现：按请求的 elapsedMs 全速推进。
+        virtual int lastMovementAdvanceMs(int requestedMs) const {
+            return requestedMs;
+        }
+
+        // 稳定裕度统计（见 stability.h），不支持的机型返回空统计
+        virtual stability::Stats stabilityStats() const {
+            return stability::Stats();
+        }
+
+        // 运动学状态（主机仿真 sim/gait_sim.cpp 与诊断使用）：
+        // 腿数、上一次 processMovement 下发的足端位置（机体坐标系）与关节角度（度，限幅后）
+        virtual int legCount() const {
+            return 0;
+        }
+
+        virtual bool footTip(int legIndex, Point3D& tip) const {
+            (void)legIndex;
+            (void)tip;
+            return false;
+        }
+
+        virtual bool jointAngles(int legIndex, float angles[3]) const {
+            (void)legIndex;
+            (void)angles;
+            return false;
+        }
+
+        // 是否仍处于模式切换过渡（插值到新模式首帧、四足的等待 entry/落地/逐腿对齐）
+        virtual bool isTransitioning() const {
+            return false;
+        }
+
         // 校准相关
         virtual void calibrationSave() = 0;
         virtual void calibrationGet(int legIndex, int partIndex, int& offset) = 0;
@@ -41,14 +119,26 @@ namespace hexapod {
         virtual void calibrationSet(CalibrationData& calibrationData) = 0;
         virtual void calibrationTest(int legIndex, int partIndex, float angle) = 0;
         virtual void calibrationTestAllLeg(float angle) = 0;
+        // 多点校准曲线（锚点索引 0~ServoCurve::kPointCount-1，修正量单位 us）
+        virtual void calibrationCurveGet(int legIndex, int partIndex, int point, int& correctionUs) = 0;
+        virtual void calibrationCurveSet(int legIndex, int partIndex, int point, int correctionUs) = 0;
+        virtual void calibrationCurveTest(int legIndex, int partIndex, int point) = 0;
         virtual void clearOffset() = 0;
         virtual void forceResetAllLegTippos() = 0;
 
         // 步态模式控制（默认空实现，保证向后兼容）
         // 对六足模型或不支持多步态的实现，可以忽略此调用。
+        // kAutoGaitMode 表示按运动速度（与运动模式）自动选择步态；getGaitMode() 返回当前执行的步态
+        static constexpr int kAutoGaitMode = 4;
         virtual void setGaitMode(int gaitMode) {
             (void)gaitMode;
         }
+        virtual int getGaitMode() const {
+            return 0;
+        }
+        virtual bool isAutoGait() const {
+            return false;
+        }
 
         // 单腿控制能力（默认不支持，具体机型按需覆盖）
         virtual bool supportsSingleLegControl() const {
@@ -0,0 +1,66 @@
+#include "serial_frame.h"
+
+namespace seriallink {
+
+constexpr size_t FrameAssembler::kMaxFrameLength;
+constexpr char FrameAssembler::kStartChar;
+
+FrameAssembler::FrameAssembler()
+    : length_(0), started_(false), overflowed_(false), overflows_(0), framing_(Framing::Text) {
+    buffer_[0] = '\0';
+}
+
+size_t FrameAssembler::feed(const uint8_t* data, size_t length, Handler handler, void* context) {
+    size_t frames = 0;
+    for (size_t i = 0; i < length; ++i) {
+        const char c = static_cast<char>(data[i]);
+        const bool cobs = framing_ == Framing::Cobs;
+
+        if (!started_ && !cobs) {
+            // 等待起始符，其余字节丢弃
+            if (c == kStartChar) {
+                started_ = true;
+                overflowed_ = false;
+                length_ = 0;
+            }
+            continue;
+        }
+
+        // COBS 帧内不会出现 0x00，0x00 即帧结束
+        const bool frameEnd = cobs ? (c == '\0') : (c == '\n' || c == '\r');
+        if (frameEnd) {
+            if (!overflowed_ && length_ > 0 && handler) {
+                buffer_[length_] = '\0';
+                handler(buffer_, length_, context);
+                ++frames;
+            }
+            reset();
+            continue;
+        }
+        started_ = true;
+
+        if (overflowed_) {
+            continue;
+        }
+        if (length_ >= kMaxFrameLength) {
+            overflowed_ = true;
+            ++overflows_;
+            continue;
+        }
+        buffer_[length_++] = c;
+    }
+    return frames;
+}
+
+void FrameAssembler::setFraming(Framing framing) {
+    framing_ = framing;
+    reset();
+}
+
+void FrameAssembler::reset() {
+    started_ = false;
+    overflowed_ = false;
+    length_ = 0;
+}
+
+}  // namespace seriallink
@@ -0,0 +1,56 @@
+// 串口帧组装（与平台无关，可在主机上直接编译）
+// - 文本帧：'$' + 内容 + '\n'（或 '\r'），起始符之前的字节丢弃
+// - COBS 帧：COBS 编码内容 + 0x00 分隔符（二进制链路，见 serial_packet.h）
+// 使用固定大小缓冲区就地组帧，不做堆分配；完成的帧以 '\0' 结尾、可写，
+// 便于 ArduinoJson 直接在缓冲区上零拷贝解析。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 单帧最大长度（不含起始符与换行），可通过 build_flags 覆盖
+#ifndef SERIAL_FRAME_MAX_LENGTH
+#define SERIAL_FRAME_MAX_LENGTH 512
+#endif
+
+namespace seriallink {
+
+enum class Framing : uint8_t {
+    Text = 0,
+    Cobs,
+};
+
+class FrameAssembler {
+public:
+    static constexpr size_t kMaxFrameLength = SERIAL_FRAME_MAX_LENGTH;
+    static constexpr char kStartChar = '$';
+
+    // frame 在回调返回前有效，回调内可以就地修改
+    typedef void (*Handler)(char* frame, size_t length, void* context);
+
+    FrameAssembler();
+
+    // 处理一段字节流，每完成一帧调用一次 handler，返回本次完成的帧数
+    size_t feed(const uint8_t* data, size_t length, Handler handler, void* context);
+
+    // 丢弃当前未完成的帧（超时/接收溢出时调用）
+    void reset();
+
+    // 切换帧格式（同时丢弃未完成的帧）
+    void setFraming(Framing framing);
+    Framing framing() const { return framing_; }
+
+    bool inFrame() const { return started_; }
+    size_t pendingLength() const { return length_; }
+    uint32_t overflowCount() const { return overflows_; }
+
+private:
+    char buffer_[kMaxFrameLength + 1];
+    size_t length_;
+    bool started_;
+    bool overflowed_;   // 当前帧超长，丢弃到行尾
+    uint32_t overflows_;
+    Framing framing_;
+};
+
+}  // namespace seriallink
@@ -0,0 +1,421 @@
+// UART2 指令链路（事件驱动接收 + 固定缓冲组帧）
+
+#include "serial_link.h"
+
+#include <driver/uart.h>
+#include <freertos/queue.h>
+
+#include "debug.h"
+
+namespace seriallink {
+
+namespace {
+
+static constexpr uart_port_t kPort = UART_NUM_2;
+static constexpr int kRxBufferSize = 1024;
+static constexpr int kTxBufferSize = 1024;
+static constexpr int kEventQueueLength = 20;
+static constexpr int kPatternQueueLength = 16;
+static constexpr size_t kReadChunk = 128;
+static constexpr size_t kMaxEncodedPacket = encodedPacketSize(FrameAssembler::kMaxFrameLength);
+static constexpr uint16_t kMinTelemetryPeriodMs = 20;
+static constexpr size_t kMaxTelemetryPayload = 64;
+
+QueueHandle_t eventQueue = nullptr;
+SemaphoreHandle_t txMutex = nullptr;  // 发送：整帧/整包写出与 txSeq
+TaskHandle_t linkTask = nullptr;
+FrameAssembler assembler;
+FrameHandler frameHandler = nullptr;
+PacketHandler packetHandler = nullptr;
+TelemetryProvider telemetryProvider = nullptr;
+uint32_t idleTimeout = 1000;
+uint32_t defaultBaud = 115200;
+uint32_t wakeUs = 0;
+Stats stats;
+
+LinkMode linkMode = LinkMode::Text;
+uint32_t currentBaud = 115200;
+bool switchPending = false;
+LinkMode pendingMode = LinkMode::Text;
+uint32_t pendingBaud = 115200;
+
+// 二进制链路状态（仅在 SerialLink 任务中访问；txSeq 链路任务与主循环都会递增，由 txMutex 保护）
+const Packet* dispatching = nullptr;  // 正在处理的指令
+bool hasLastPacket = false;
+MessageId lastPacketId = MessageId::Ack;
+uint8_t lastPacketSeq = 0;
+uint32_t lastPacketMs = 0;
+uint8_t lastReply[kMaxEncodedPacket];  // 最近一条应答（编码后），用于重发
+size_t lastReplyLength = 0;
+uint8_t txSeq = 0;                     // 设备主动推送的 seq
+uint16_t telemetryPeriodMs = 0;
+uint32_t lastTelemetryMs = 0;
+
+bool currentTaskIsLink() {
+  return linkTask != nullptr && xTaskGetCurrentTaskHandle() == linkTask;
+}
+
+void writeEncoded(const uint8_t* data, size_t length) {
+  xSemaphoreTake(txMutex, portMAX_DELAY);
+  uart_write_bytes(kPort, reinterpret_cast<const char*>(data), length);
+  xSemaphoreGive(txMutex);
+}
+
+uint8_t nextTxSeq() {
+  xSemaphoreTake(txMutex, portMAX_DELAY);
+  const uint8_t seq = txSeq++;
+  xSemaphoreGive(txMutex);
+  return seq;
+}
+
+void applyMode(LinkMode mode, uint32_t baud) {
+  // 等待切换前的应答发完，再改波特率与帧格式
+  uart_wait_tx_done(kPort, pdMS_TO_TICKS(100));
+  uart_set_baudrate(kPort, baud);
+  uart_disable_pattern_det_intr(kPort);
+  uart_enable_pattern_det_baud_intr(kPort, mode == LinkMode::Binary ? '\0' : '\n', 1, 9, 0, 0);
+  uart_pattern_queue_reset(kPort, kPatternQueueLength);
+  uart_flush_input(kPort);
+  assembler.setFraming(mode == LinkMode::Binary ? Framing::Cobs : Framing::Text);
+
+  linkMode = mode;
+  currentBaud = baud;
+  hasLastPacket = false;
+  lastReplyLength = 0;
+  telemetryPeriodMs = 0;
+  lastPacketMs = millis();
+  ++stats.modeSwitches;
+
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "[SerialLink] %s link, %u baud",
+           mode == LinkMode::Binary ? "binary" : "text", static_cast<unsigned>(baud));
+  LOG_INFO(buffer);
+}
+
+void sendNack(NackReason reason) {
+  const uint8_t payload = static_cast<uint8_t>(reason);
+  sendPacket(MessageId::Nack, nextTxSeq(), &payload, 1);
+}
+
+// 链路自身处理的报文，返回 true 表示已处理
+bool handleLinkPacket(const Packet& packet) {
+  switch (packet.id) {
+    case MessageId::Ping: {
+      uint8_t payload[1 + 32];
+      payload[0] = kProtocolVersion;
+      const size_t echo = packet.payloadLength < 32 ? packet.payloadLength : 32;
+      memcpy(payload + 1, packet.payload, echo);
+      sendPacket(MessageId::Pong, packet.seq, payload, 1 + echo);
+      return true;
+    }
+    case MessageId::LinkReset:
+      sendAck(packet, AckStatus::Ok);
+      requestMode(LinkMode::Text, defaultBaud);
+      return true;
+    case MessageId::TelemetryConfig: {
+      if (packet.payloadLength < 2) {
+        sendAck(packet, AckStatus::Invalid);
+        return true;
+      }
+      uint16_t period = static_cast<uint16_t>(packet.payload[0] | (packet.payload[1] << 8));
+      if (period != 0 && period < kMinTelemetryPeriodMs) {
+        period = kMinTelemetryPeriodMs;
+      }
+      telemetryPeriodMs = telemetryProvider ? period : 0;
+      lastTelemetryMs = millis();
+      sendAck(packet, telemetryProvider ? AckStatus::Ok : AckStatus::Unsupported);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+void dispatchPacket(char* frame, size_t length) {
+  Packet packet;
+  NackReason reason;
+  if (!decodePacket(reinterpret_cast<uint8_t*>(frame), length, packet, reason)) {
+    ++stats.badPackets;
+    sendNack(reason);
+    return;
+  }
+  ++stats.packets;
+  lastPacketMs = millis();
+
+  // 重发：上位机没收到应答，按原样回送最近一条应答，不重复执行
+  if (hasLastPacket && packet.seq == lastPacketSeq && packet.id == lastPacketId) {
+    ++stats.duplicates;
+    if (lastReplyLength > 0) {
+      writeEncoded(lastReply, lastReplyLength);
+    }
+    return;
+  }
+  if (hasLastPacket && packet.seq != static_cast<uint8_t>(lastPacketSeq + 1)) {
+    ++stats.seqGaps;
+  }
+  hasLastPacket = true;
+  lastPacketId = packet.id;
+  lastPacketSeq = packet.seq;
+  lastReplyLength = 0;
+
+  dispatching = &packet;
+  if (!handleLinkPacket(packet)) {
+    if (packetHandler) {
+      packetHandler(packet);
+    } else {
+      sendAck(packet, AckStatus::Unsupported);
+    }
+  }
+  dispatching = nullptr;
+}
+
+void dispatchFrame(char* frame, size_t length, void* context) {
+  (void)context;
+  if (linkMode == LinkMode::Binary) {
+    dispatchPacket(frame, length);
+  } else if (frameHandler) {
+    frameHandler(frame, length);
+  }
+  const uint32_t elapsed = micros() - wakeUs;
+  ++stats.frames;
+  stats.lastDispatchUs = elapsed;
+  if (elapsed > stats.maxDispatchUs) {
+    stats.maxDispatchUs = elapsed;
+  }
+}
+
+// 读出驱动环形缓冲中的全部数据并组帧
+void drainRx() {
+  uint8_t chunk[kReadChunk];
+  size_t buffered = 0;
+  uart_get_buffered_data_len(kPort, &buffered);
+  while (buffered > 0) {
+    const size_t want = buffered < sizeof(chunk) ? buffered : sizeof(chunk);
+    const int n = uart_read_bytes(kPort, chunk, want, 0);
+    if (n <= 0) {
+      break;
+    }
+    stats.bytes += n;
+    assembler.feed(chunk, static_cast<size_t>(n), dispatchFrame, nullptr);
+    buffered -= static_cast<size_t>(n);
+    // 切换链路后剩余字节属于旧格式，由 applyMode 清空
+    if (switchPending) {
+      break;
+    }
+  }
+  stats.frameOverflows = assembler.overflowCount();
+}
+
+void pushTelemetry() {
+  uint8_t payload[kMaxTelemetryPayload];
+  const size_t length = telemetryProvider(payload, sizeof(payload));
+  if (length > 0 && sendPacket(MessageId::Telemetry, nextTxSeq(), payload, length)) {
+    ++stats.telemetrySent;
+  }
+}
+
+// 计算下一次需要主动唤醒的等待时间
+TickType_t nextWait(uint32_t now, uint32_t lastDataMs) {
+  uint32_t waitMs = UINT32_MAX;
+  if (assembler.inFrame()) {
+    const uint32_t since = now - lastDataMs;
+    waitMs = since >= idleTimeout ? 0 : idleTimeout - since;
+  }
+  if (linkMode == LinkMode::Binary) {
+    const uint32_t since = now - lastPacketMs;
+    const uint32_t idleLeft = since >= SERIAL_BINARY_IDLE_MS ? 0 : SERIAL_BINARY_IDLE_MS - since;
+    waitMs = idleLeft < waitMs ? idleLeft : waitMs;
+    if (telemetryPeriodMs > 0) {
+      const uint32_t elapsed = now - lastTelemetryMs;
+      const uint32_t left = elapsed >= telemetryPeriodMs ? 0 : telemetryPeriodMs - elapsed;
+      waitMs = left < waitMs ? left : waitMs;
+    }
+  }
+  return waitMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(waitMs);
+}
+
+void SerialLinkTask(void* pvParameters) {
+  (void)pvParameters;
+  uart_event_t event;
+  uint32_t lastDataMs = millis();
+
+  while (true) {
+    if (xQueueReceive(eventQueue, &event, nextWait(millis(), lastDataMs)) == pdTRUE) {
+      wakeUs = micros();
+      switch (event.type) {
+        case UART_DATA:
+          lastDataMs = millis();
+          drainRx();
+          break;
+        case UART_PATTERN_DET:
+          // 数据已在 drainRx 中整体读出，这里只需弹出模式位置，避免位置队列写满
+          uart_pattern_pop_pos(kPort);
+          lastDataMs = millis();
+          drainRx();
+          break;
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+          ++stats.rxOverflows;
+          uart_flush_input(kPort);
+          xQueueReset(eventQueue);
+          assembler.reset();
+          LOG_INFO("[SerialLink] rx overflow, input flushed");
+          break;
+        default:
+          break;
+      }
+    }
+
+    if (switchPending) {
+      switchPending = false;
+      applyMode(pendingMode, pendingBaud);
+      continue;
+    }
+
+    const uint32_t now = millis();
+    if (assembler.inFrame() && now - lastDataMs > idleTimeout) {
+      char buffer[80];
+      snprintf(buffer, sizeof(buffer), "[SerialLink] frame timeout, dropped %u bytes",
+               static_cast<unsigned>(assembler.pendingLength()));
+      LOG_INFO(buffer);
+      ++stats.timeouts;
+      assembler.reset();
+    }
+
+    if (linkMode == LinkMode::Binary) {
+      if (now - lastPacketMs >= SERIAL_BINARY_IDLE_MS) {
+        // 上位机掉线/复位：回到文本链路，便于重新协商
+        applyMode(LinkMode::Text, defaultBaud);
+        continue;
+      }
+      if (telemetryPeriodMs > 0 && telemetryProvider && now - lastTelemetryMs >= telemetryPeriodMs) {
+        lastTelemetryMs = now;
+        pushTelemetry();
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool begin(uint32_t baud, int rxPin, int txPin, uint32_t idleTimeoutMs, UBaseType_t taskPriority, FrameHandler handler) {
+  frameHandler = handler;
+  idleTimeout = idleTimeoutMs;
+  defaultBaud = baud;
+  currentBaud = baud;
+  txMutex = xSemaphoreCreateMutex();
+
+  uart_config_t config = {};
+  config.baud_rate = static_cast<int>(baud);
+  config.data_bits = UART_DATA_8_BITS;
+  config.parity = UART_PARITY_DISABLE;
+  config.stop_bits = UART_STOP_BITS_1;
+  config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  config.source_clk = UART_SCLK_APB;
+
+  if (uart_driver_install(kPort, kRxBufferSize, kTxBufferSize, kEventQueueLength, &eventQueue, 0) != ESP_OK) {
+    LOG_INFO("[SerialLink] uart_driver_install failed");
+    return false;
+  }
+  uart_param_config(kPort, &config);
+  uart_set_pin(kPort, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+
+  // 行尾 '\n' 触发模式检测事件，帧结束时立即唤醒，而不是等接收超时
+  uart_enable_pattern_det_baud_intr(kPort, '\n', 1, 9, 0, 0);
+  uart_pattern_queue_reset(kPort, kPatternQueueLength);
+  uart_flush_input(kPort);
+
+  return xTaskCreate(SerialLinkTask, "SerialLink", 6144, NULL, taskPriority, &linkTask) == pdPASS;
+}
+
+void setPacketHandler(PacketHandler handler) {
+  packetHandler = handler;
+}
+
+void setTelemetryProvider(TelemetryProvider provider) {
+  telemetryProvider = provider;
+}
+
+bool isSupportedBaud(uint32_t baud) {
+  return baud == 115200 || baud == 230400 || baud == 460800 || baud == 921600;
+}
+
+void requestMode(LinkMode mode, uint32_t baud) {
+  pendingMode = mode;
+  pendingBaud = baud;
+  switchPending = true;
+  if (!currentTaskIsLink()) {
+    // 从其它任务请求时唤醒链路任务
+    uart_event_t wake = {};
+    wake.type = UART_EVENT_MAX;
+    xQueueSend(eventQueue, &wake, 0);
+  }
+}
+
+LinkMode mode() {
+  return linkMode;
+}
+
+uint32_t baudRate() {
+  return currentBaud;
+}
+
+void write(const char* data, size_t length) {
+  if (eventQueue) {
+    xSemaphoreTake(txMutex, portMAX_DELAY);
+    uart_write_bytes(kPort, data, length);
+    xSemaphoreGive(txMutex);
+  }
+}
+
+void writeFrame(const char* payload, size_t length) {
+  if (!eventQueue) {
+    return;
+  }
+  // 整帧在同一次加锁内写出：链路任务的应答与主循环的推送（sendJson）不会插到帧中间
+  xSemaphoreTake(txMutex, portMAX_DELAY);
+  uart_write_bytes(kPort, "$", 1);
+  uart_write_bytes(kPort, payload, length);
+  uart_write_bytes(kPort, "\n", 1);
+  xSemaphoreGive(txMutex);
+}
+
+void sendJson(const char* json, size_t length) {
+  if (linkMode != LinkMode::Binary) {
+    writeFrame(json, length);
+    return;
+  }
+  const bool reply = dispatching != nullptr && currentTaskIsLink();
+  sendPacket(MessageId::JsonResponse, reply ? dispatching->seq : nextTxSeq(),
+             reinterpret_cast<const uint8_t*>(json), length);
+}
+
+bool sendPacket(MessageId id, uint8_t seq, const uint8_t* payload, size_t length) {
+  if (!eventQueue || linkMode != LinkMode::Binary) {
+    return false;
+  }
+  uint8_t encoded[kMaxEncodedPacket];
+  const size_t size = encodePacket(id, seq, payload, length, encoded, sizeof(encoded));
+  if (size == 0) {
+    return false;
+  }
+  writeEncoded(encoded, size);
+
+  // 对当前指令的应答保留一份，重发时直接回送
+  if (dispatching != nullptr && seq == dispatching->seq && currentTaskIsLink()) {
+    memcpy(lastReply, encoded, size);
+    lastReplyLength = size;
+  }
+  return true;
+}
+
+void sendAck(const Packet& packet, AckStatus status) {
+  const uint8_t payload[2] = {static_cast<uint8_t>(packet.id), static_cast<uint8_t>(status)};
+  sendPacket(MessageId::Ack, packet.seq, payload, sizeof(payload));
+}
+
+Stats getStats() {
+  return stats;
+}
+
+}  // namespace seriallink
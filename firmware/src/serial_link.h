@@ -0,0 +1,76 @@
+// UART2 指令链路（与上位机/拓展板通讯）
+// - 使用 ESP-IDF UART 驱动的事件队列：数据到达/检测到帧尾时唤醒任务，不再 10ms 轮询
+// - 接收字节进入固定大小的帧缓冲（FrameAssembler），完成的帧就地交给回调解析，无堆分配
+// - 半帧超过 idleTimeoutMs 未收到后续数据时丢弃
+// - 默认为 '$' + JSON 文本链路；可协商切换到二进制链路（COBS + CRC16，见 serial_packet.h）
+#pragma once
+
+#include <Arduino.h>
+
+#include "serial_frame.h"
+#include "serial_packet.h"
+
+// 二进制链路空闲超时：超过该时间未收到有效报文则回到文本链路与默认波特率（上位机需定期发送 Ping 保活）
+#ifndef SERIAL_BINARY_IDLE_MS
+#define SERIAL_BINARY_IDLE_MS 3000
+#endif
+
+namespace seriallink {
+
+enum class LinkMode : uint8_t {
+  Text = 0,
+  Binary,
+};
+
+struct Stats {
+  uint32_t frames = 0;          // 完成并分发的帧数
+  uint32_t bytes = 0;           // 接收字节数
+  uint32_t frameOverflows = 0;  // 超过 SERIAL_FRAME_MAX_LENGTH 被丢弃的帧
+  uint32_t rxOverflows = 0;     // 驱动 FIFO/环形缓冲溢出
+  uint32_t timeouts = 0;        // 半帧超时丢弃
+  uint32_t lastDispatchUs = 0;  // 最近一帧：从事件唤醒到回调返回的耗时
+  uint32_t maxDispatchUs = 0;
+  // 二进制链路
+  uint32_t packets = 0;         // 校验通过的报文
+  uint32_t badPackets = 0;      // COBS/CRC 错误（已回 Nack）
+  uint32_t duplicates = 0;      // 重发的报文（只重新应答）
+  uint32_t seqGaps = 0;         // seq 不连续（上位机丢帧）
+  uint32_t telemetrySent = 0;
+  uint32_t modeSwitches = 0;
+};
+
+// 文本帧回调：frame 以 '\0' 结尾，仅在回调内有效，可就地修改（零拷贝 JSON 解析）
+typedef void (*FrameHandler)(char* frame, size_t length);
+// 二进制指令回调（链路类报文 Ping/LinkReset/TelemetryConfig 由链路自身处理）
+typedef void (*PacketHandler)(const Packet& packet);
+// 遥测内容填充，返回写入字节数
+typedef size_t (*TelemetryProvider)(uint8_t* out, size_t capacity);
+
+// 安装 UART 驱动并创建接收任务
+bool begin(uint32_t baud, int rxPin, int txPin, uint32_t idleTimeoutMs, UBaseType_t taskPriority, FrameHandler handler);
+void setPacketHandler(PacketHandler handler);
+void setTelemetryProvider(TelemetryProvider provider);
+
+// 二进制链路支持的波特率：115200/230400/460800/921600
+bool isSupportedBaud(uint32_t baud);
+// 请求切换链路，在当前帧处理完、应答发送完成后生效
+void requestMode(LinkMode mode, uint32_t baud);
+LinkMode mode();
+uint32_t baudRate();
+
+// 发送原始字节（可在任意任务中调用；与其它任务的 write/writeFrame/报文按调用整体写出，不会交错）
+void write(const char* data, size_t length);
+// 发送一帧文本：'$' + payload + '\n'，整帧持有发送锁，不会被其它任务的输出打断
+void writeFrame(const char* payload, size_t length);
+
+// 发送 JSON 应答：文本链路为 '$' 帧；二进制链路为 JsonResponse 报文（内容也可以是 MessagePack），
+// 在指令回调内调用时回送该指令的 seq，其它任务中调用时作为主动推送
+void sendJson(const char* json, size_t length);
+// 发送二进制报文（仅二进制链路有效）
+bool sendPacket(MessageId id, uint8_t seq, const uint8_t* payload, size_t length);
+// 应答当前正在处理的指令
+void sendAck(const Packet& packet, AckStatus status);
+
+Stats getStats();
+
+}  // namespace seriallink
@@ -0,0 +1,101 @@
+#include "serial_packet.h"
+
+#include <cstring>
+
+namespace seriallink {
+
+uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < length; ++i) {
+        if (in[i] == 0) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+            continue;
+        }
+        out[outIndex++] = in[i];
+        if (++code == 0xFF) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+    out[codeIndex] = code;
+    return outIndex;
+}
+
+bool cobsDecode(uint8_t* buffer, size_t length, size_t& decodedLength) {
+    // 解码结果总比输入短，从前向后就地写入不会覆盖未读数据
+    size_t in = 0;
+    size_t out = 0;
+    while (in < length) {
+        const uint8_t code = buffer[in++];
+        if (code == 0 || in + code - 1 > length) {
+            return false;
+        }
+        for (uint8_t i = 1; i < code; ++i) {
+            buffer[out++] = buffer[in++];
+        }
+        if (code != 0xFF && in < length) {
+            buffer[out++] = 0;
+        }
+    }
+    decodedLength = out;
+    return true;
+}
+
+bool decodePacket(uint8_t* frame, size_t length, Packet& packet, NackReason& reason) {
+    size_t decoded = 0;
+    if (!cobsDecode(frame, length, decoded) || decoded < kPacketOverhead) {
+        reason = NackReason::Framing;
+        return false;
+    }
+    const size_t body = decoded - 2;
+    const uint16_t expected = static_cast<uint16_t>(frame[body] | (frame[body + 1] << 8));
+    if (crc16(frame, body) != expected) {
+        reason = NackReason::Crc;
+        return false;
+    }
+    packet.id = static_cast<MessageId>(frame[0]);
+    packet.seq = frame[1];
+    packet.payload = frame + 2;
+    packet.payloadLength = body - 2;
+    return true;
+}
+
+size_t encodePacket(MessageId id, uint8_t seq, const uint8_t* payload, size_t payloadLength,
+                    uint8_t* out, size_t capacity) {
+    if (capacity < encodedPacketSize(payloadLength)) {
+        return 0;
+    }
+    // 原始报文先写到 out 尾部，再从头部做 COBS 编码（编码输出不会追上未读的输入）
+    const size_t rawLength = payloadLength + kPacketOverhead;
+    uint8_t* raw = out + capacity - rawLength;
+    raw[0] = static_cast<uint8_t>(id);
+    raw[1] = seq;
+    if (payloadLength > 0) {
+        memmove(raw + 2, payload, payloadLength);
+    }
+    const uint16_t crc = crc16(raw, payloadLength + 2);
+    raw[payloadLength + 2] = static_cast<uint8_t>(crc & 0xFF);
+    raw[payloadLength + 3] = static_cast<uint8_t>(crc >> 8);
+
+    const size_t encoded = cobsEncode(raw, rawLength, out);
+    out[encoded] = 0;
+    return encoded + 1;
+}
+
+}  // namespace seriallink
@@ -0,0 +1,81 @@
+// UART2 二进制链路报文（与平台无关，可在主机上直接编译）
+//
+// 线上格式：COBS(报文) + 0x00
+// 报文：    [id:u8][seq:u8][payload:0..N][crc16:u16 LE]
+// - crc16 为 CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF），覆盖 id、seq 与 payload
+// - 多字节字段均为小端
+// - 上位机发送的每条指令带递增 seq，设备以 Ack/JsonResponse 回送同一 seq；
+//   重发（seq 与 id 均与上一条相同）只重新应答，不重复执行
+// - 设备主动推送（Telemetry）使用设备侧独立的 seq
+//
+// 协商：文本链路下发送 ${"link":"binary","baud":921600}，收到成功应答后双方切换到二进制帧与新波特率；
+// 发送 LinkReset 或超过 SERIAL_BINARY_IDLE_MS 未收到有效报文时回到文本链路与默认波特率。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace seriallink {
+
+constexpr uint8_t kProtocolVersion = 1;
+
+enum class MessageId : uint8_t {
+    // 链路
+    Ack = 0x01,             // 设备 -> 上位机：[ackedId:u8][status:u8]
+    Nack = 0x02,            // 设备 -> 上位机：CRC/格式错误，[reason:u8]
+    Ping = 0x03,            // 上位机 -> 设备：任意 payload
+    Pong = 0x04,            // 设备 -> 上位机：[version:u8] + 原样回送 Ping 的 payload
+    LinkReset = 0x05,       // 上位机 -> 设备：回到文本链路
+    // 指令
+    JsonCommand = 0x10,     // 上位机 -> 设备：与文本链路相同的 JSON 指令（不含 '$'），或同一结构的 MessagePack
+    JsonResponse = 0x11,    // 设备 -> 上位机：应答/事件，格式与上位机最近一次 JsonCommand 相同
+    SetMovement = 0x20,     // 上位机 -> 设备：[movementMode:i16] 可选 [speed:f32]
+    Stop = 0x21,            // 上位机 -> 设备：停止并清空所有动作队列
+    // 遥测
+    TelemetryConfig = 0x30, // 上位机 -> 设备：[periodMs:u16]，0 关闭
+    Telemetry = 0x31,       // 设备 -> 上位机：见 main.cpp fillSerialTelemetry
+};
+
+enum class AckStatus : uint8_t {
+    Ok = 0,
+    Busy,
+    Invalid,
+    LowBattery,
+    Unsupported,
+};
+
+enum class NackReason : uint8_t {
+    Crc = 1,
+    Framing,
+};
+
+// 报文头 2 字节 + CRC 2 字节
+constexpr size_t kPacketOverhead = 4;
+
+struct Packet {
+    MessageId id;
+    uint8_t seq;
+    uint8_t* payload;   // 指向接收缓冲区内部，回调返回前有效
+    size_t payloadLength;
+};
+
+uint16_t crc16(const uint8_t* data, size_t length);
+
+// COBS 编码，out 至少 length + length / 254 + 1 字节，返回编码后长度（不含 0x00 分隔符）
+size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+// COBS 就地解码，格式错误返回 false
+bool cobsDecode(uint8_t* buffer, size_t length, size_t& decodedLength);
+
+// 就地解码一帧（COBS + CRC 校验），失败时 reason 给出原因
+bool decodePacket(uint8_t* frame, size_t length, Packet& packet, NackReason& reason);
+
+// 编码一帧到 out（含末尾 0x00），容量不足返回 0
+size_t encodePacket(MessageId id, uint8_t seq, const uint8_t* payload, size_t payloadLength,
+                    uint8_t* out, size_t capacity);
+
+// 编码后的最大长度
+constexpr size_t encodedPacketSize(size_t payloadLength) {
+    return payloadLength + kPacketOverhead + (payloadLength + kPacketOverhead) / 254 + 2;
+}
+
+}  // namespace seriallink
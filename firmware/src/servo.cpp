@@ -1,14 +1,13 @@
 #include "servo.h"
 #include "debug.h"
+#include "config.h"
 
 #include "pwm.h"
 
 namespace hexapod { 
 
     namespace {
-        // freq = 50, 1 tick = 1000000 / (50*4096) ~= 5us
-        const static int kFrequency = 50;
-        const static int kTickUs = 5;
+        // freq 与 us->tick 换算见 config.h / hal::PCA9685（50Hz 时 1 tick ~= 4.9us）
         const static int kServoMiddle = 1500;
         const static int kServoMax = 2500;
         const static int kServoMin = 500;
@@ -23,10 +22,20 @@ namespace hexapod {
                 return;
 
             pwmLeft.begin();  
-            pwmLeft.setPWMFreq(kFrequency);
+            pwmLeft.setOscillatorFrequency(config::pca9685OscillatorHz);
+            pwmLeft.setPWMFreq(config::servoPwmFrequencyLeft);
             pwmRight.begin();  
-            pwmRight.setPWMFreq(kFrequency);
+            pwmRight.setOscillatorFrequency(config::pca9685OscillatorHz);
+            pwmRight.setPWMFreq(config::servoPwmFrequencyRight);
+            // 两块板的通道号相同，左板再错开半个槽位（128 tick），使 18 路上升沿互不重合。
+            // 注：两块板振荡器相互独立，板间相位会缓慢漂移，板内错相始终有效。
+            pwmLeft.setStagger(config::servoPwmStagger, 128);
+            pwmRight.setStagger(config::servoPwmStagger, 0);
             pwmInited = true;
+
+            LOG_INFO("PWM left: %.1fHz (tick %.2fus), right: %.1fHz (tick %.2fus)",
+                     pwmLeft.actualFrequency(), pwmLeft.tickUs(),
+                     pwmRight.actualFrequency(), pwmRight.tickUs());
         }
 
         int hexapod2pwm(int legIndex, int partIndex) {
@@ -63,6 +72,21 @@ namespace hexapod {
         initPWM();
     }
 
+    bool Servo::recoverBoards(void) {
+        if (!pwmInited)
+            return false;
+        bool reset = false;
+        if (pwmLeft.recoverFromReset()) {
+            LOG_INFO("PWM left board was reset, re-initialized");
+            reset = true;
+        }
+        if (pwmRight.recoverFromReset()) {
+            LOG_INFO("PWM right board was reset, re-initialized");
+            reset = true;
+        }
+        return reset;
+    }
+
     Servo::Servo(int legIndex, int partIndex) {
         pwmIndex_ = hexapod2pwm(legIndex, partIndex);
         inverse_ = partIndex == 1 ? true : false;
@@ -70,6 +94,21 @@ namespace hexapod {
         range_ = partIndex == 0 ? 45 : 60;
         angle_ = 0;
         offset_ = 0;
+        lastTicks_ = -1;
+        driven_ = false;
+        rebuildCurve();
+    }
+
+    void Servo::rebuildCurve() {
+        // 与原先的整数换算保持一致：kServoRange/90 = 11us/°
+        curve_.build(offset_, static_cast<float>(kServoRange/90));
+    }
+
+    void Servo::testCurvePoint(int point) {
+        float angle = static_cast<float>(ServoCurve::anchorAngle(point));
+        if (inverse_)
+            angle = -angle;
+        setAngle(angle + adjust_angle_);
     }
 
     void Servo::setAngle(float angle) {
@@ -100,14 +139,24 @@ namespace hexapod {
         if (inverse_)
             angle = -angle;
 
-        int us = kServoMiddle + (angle + offset_)*(kServoRange/90);
+        // 偏移量与多点校准曲线已折算进 LUT；保留小数部分，按实际 tick 长度四舍五入
+        float us = curve_.evaluate(angle);
         if (us > kServoMax)
             us = kServoMax;
         else if(us < kServoMin)
             us = kServoMin;
 
-        pwm->setPWM(idx, 0, us/kTickUs);
-        LOG_DEBUG("setAngle(%.2f, %d)", angle, us);
+        // 小幅插值/待机漂移时经常算出与上次相同的 tick，此时跳过 I2C 写入
+        int ticks = pwm->usToTicks(us);
+        if (ticks == lastTicks_) {
+            hal::recordPwmSkip();
+            return;
+        }
+
+        pwm->setPulseTicks(idx, ticks);
+        lastTicks_ = ticks;
+        driven_ = true;
+        LOG_DEBUG("setAngle(%.2f, %.1f)", angle, us);
     }
 
     float Servo::getAngle(void) {
@@ -0,0 +1,86 @@
+#include "servo_calibration.h"
+
+#include <cmath>
+
+namespace hexapod {
+
+    namespace {
+        const static int kServoMiddle = 1500;
+        const static int kAnchorAngles[ServoCurve::kPointCount] = {-40, -20, 0, 20, 40};
+    }
+
+    constexpr int ServoCurve::kPointCount;
+    constexpr int ServoCurve::kMaxCorrectionUs;
+    constexpr int ServoCurve::kLutMinAngle;
+    constexpr int ServoCurve::kLutSize;
+    constexpr int ServoCurve::kLutScale;
+
+    int ServoCurve::anchorAngle(int point) {
+        if (point < 0 || point >= kPointCount)
+            return 0;
+        return kAnchorAngles[point];
+    }
+
+    ServoCurve::ServoCurve() {
+        clear();
+        build(0, 11.0f);
+    }
+
+    void ServoCurve::build(int offset, float usPerDegree) {
+        for (int i = 0; i < kLutSize; i++) {
+            const float angle = static_cast<float>(kLutMinAngle + i);
+            const float us = kServoMiddle + (angle + offset) * usPerDegree + correctionAt(angle);
+            lut_[i] = static_cast<int16_t>(std::lround(us * kLutScale));
+        }
+    }
+
+    int ServoCurve::getPoint(int point) const {
+        if (point < 0 || point >= kPointCount)
+            return 0;
+        return points_[point];
+    }
+
+    bool ServoCurve::setPoint(int point, int correctionUs) {
+        if (point < 0 || point >= kPointCount)
+            return false;
+        if (correctionUs > kMaxCorrectionUs)
+            correctionUs = kMaxCorrectionUs;
+        else if (correctionUs < -kMaxCorrectionUs)
+            correctionUs = -kMaxCorrectionUs;
+        points_[point] = static_cast<int16_t>(correctionUs);
+        return true;
+    }
+
+    void ServoCurve::clear() {
+        for (int i = 0; i < kPointCount; i++)
+            points_[i] = 0;
+    }
+
+    float ServoCurve::evaluate(float angle) const {
+        float pos = angle - kLutMinAngle;
+        if (pos <= 0.0f)
+            return static_cast<float>(lut_[0]) / kLutScale;
+        if (pos >= kLutSize - 1)
+            return static_cast<float>(lut_[kLutSize - 1]) / kLutScale;
+
+        const int i = static_cast<int>(pos);
+        const float t = pos - i;
+        return (lut_[i] + (lut_[i + 1] - lut_[i]) * t) / kLutScale;
+    }
+
+    float ServoCurve::correctionAt(float angle) const {
+        if (angle <= kAnchorAngles[0])
+            return points_[0];
+        if (angle >= kAnchorAngles[kPointCount - 1])
+            return points_[kPointCount - 1];
+
+        for (int i = 1; i < kPointCount; i++) {
+            if (angle <= kAnchorAngles[i]) {
+                const float t = (angle - kAnchorAngles[i - 1]) / (kAnchorAngles[i] - kAnchorAngles[i - 1]);
+                return points_[i - 1] + (points_[i] - points_[i - 1]) * t;
+            }
+        }
+        return points_[kPointCount - 1];
+    }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace hexapod {
+
+    // 舵机多点校准曲线：
+    // - 在若干固定的舵机输出角度（锚点）上记录 µs 修正量，锚点之间分段线性插值，锚点之外保持端点修正量；
+    // - 与整数偏移量 offset 一起折算进按 1° 步进的查找表（LUT），运行时每次 setAngle 只做一次查表 + 线性插值，
+    //   与原先的 "1500 + (angle+offset)*rate" 计算量相当，不增加控制周期开销。
+    class ServoCurve {
+    public:
+        static constexpr int kPointCount = 5;
+        static constexpr int kMaxCorrectionUs = 100;
+
+        // 锚点角度（舵机输出角，单位：度；已做反向与安装角修正，即 0 为舵机中位）
+        static int anchorAngle(int point);
+
+        ServoCurve();
+
+        // offset: 整数角度偏移；usPerDegree: 角度到脉宽的换算系数（六足沿用整数 11，四足为 1000/90）
+        void build(int offset, float usPerDegree);
+
+        int getPoint(int point) const;
+        // 返回 false 表示锚点索引非法；修正量会被限制在 ±kMaxCorrectionUs
+        bool setPoint(int point, int correctionUs);
+        void clear();
+
+        // angle: 舵机输出角（度），返回未限幅的脉宽（µs）
+        float evaluate(float angle) const;
+
+    private:
+        static constexpr int kLutMinAngle = -90;
+        static constexpr int kLutSize = 181;
+        // LUT 以 1/4 µs 为单位存储，保留换算系数中的小数部分
+        static constexpr int kLutScale = 4;
+
+        float correctionAt(float angle) const;
+
+        int16_t points_[kPointCount];
+        int16_t lut_[kLutSize];
+    };
+
+}
@@ -0,0 +1,248 @@
+// 控制会话录制
+
+#include "session_recorder.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace sessionrec {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'N', 'H', 'S', 'R'};
+
+SemaphoreHandle_t mutex = nullptr;
+uint8_t* buffer = nullptr;
+size_t used = 0;
+bool recording = false;
+uint32_t tick = 0;
+Header session;
+
+void putU16(uint8_t* out, uint16_t value) {
+  out[0] = static_cast<uint8_t>(value);
+  out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void putU32(uint8_t* out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint16_t getU16(const uint8_t* in) {
+  return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t getU32(const uint8_t* in) {
+  return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8)
+      | (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+void encodeHeader(const Header& header, uint8_t* out) {
+  memcpy(out, kMagic, sizeof(kMagic));
+  out[4] = header.version;
+  out[5] = static_cast<uint8_t>(header.model);
+  out[6] = header.gaitMode;
+  out[7] = header.flags;
+  putU32(out + 8, header.seed);
+  uint32_t speedBits;
+  memcpy(&speedBits, &header.speed, sizeof(speedBits));
+  putU32(out + 12, speedBits);
+  putU16(out + 16, header.tickMs);
+  putU16(out + 18, 0);
+  putU32(out + 20, header.commandCount);
+  putU32(out + 24, header.endTick);
+  putU32(out + 28, header.droppedCommands);
+}
+
+bool lock() {
+  return mutex && xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE;
+}
+
+void unlock() {
+  xSemaphoreGive(mutex);
+}
+
+}  // namespace
+
+void begin() {
+  if (!mutex) {
+    mutex = xSemaphoreCreateMutex();
+  }
+}
+
+bool start(const Header& header, String& error) {
+  begin();
+  if (!buffer) {
+    buffer = static_cast<uint8_t*>(malloc(kCapacity));
+    if (!buffer) {
+      error = "out of memory";
+      return false;
+    }
+  }
+  if (!lock()) {
+    error = "recorder busy";
+    return false;
+  }
+  session = header;
+  session.version = kFormatVersion;
+  session.flags = header.flags & kFlagAutoGait;
+  session.commandCount = 0;
+  session.endTick = 0;
+  session.droppedCommands = 0;
+  used = 0;
+  tick = 0;
+  recording = true;
+  unlock();
+  return true;
+}
+
+void stop() {
+  if (lock()) {
+    recording = false;
+    unlock();
+  }
+}
+
+bool isRecording() {
+  return recording;
+}
+
+void onLoopTick() {
+  if (!recording) {
+    return;
+  }
+  if (lock()) {
+    if (recording) {
+      ++tick;
+    }
+    unlock();
+  }
+}
+
+void record(Source source, uint8_t kind, const void* payload, size_t length) {
+  if (!recording) {
+    return;
+  }
+  if (!lock()) {
+    return;
+  }
+  if (recording) {
+    if (length > 0xFFFF || used + kCommandHeaderSize + length > kCapacity) {
+      ++session.droppedCommands;
+    } else {
+      uint8_t* out = buffer + used;
+      putU32(out, tick);
+      out[4] = static_cast<uint8_t>(source);
+      out[5] = kind;
+      putU16(out + 6, static_cast<uint16_t>(length));
+      memcpy(out + kCommandHeaderSize, payload, length);
+      used += kCommandHeaderSize + length;
+      ++session.commandCount;
+    }
+  }
+  unlock();
+}
+
+Stats getStats() {
+  Stats stats;
+  if (lock()) {
+    stats.recording = recording;
+    stats.commands = session.commandCount;
+    stats.droppedCommands = session.droppedCommands;
+    stats.bytes = used;
+    stats.ticks = tick;
+    unlock();
+  }
+  return stats;
+}
+
+size_t snapshot(Header& header) {
+  if (!lock()) {
+    return 0;
+  }
+  header = session;
+  header.endTick = tick;
+  header.flags = session.flags | (recording ? kFlagRecording : 0) | (session.droppedCommands ? kFlagOverflow : 0);
+  const size_t total = buffer ? kHeaderSize + used : 0;
+  unlock();
+  return total;
+}
+
+size_t read(const Header& header, size_t total, size_t offset, uint8_t* out, size_t capacity) {
+  if (total > kHeaderSize + kCapacity) {
+    total = kHeaderSize + kCapacity;
+  }
+  if (offset >= total) {
+    return 0;
+  }
+  if (capacity > total - offset) {
+    capacity = total - offset;
+  }
+  size_t written = 0;
+  if (offset < kHeaderSize) {
+    uint8_t encoded[kHeaderSize];
+    encodeHeader(header, encoded);
+    const size_t count = kHeaderSize - offset < capacity ? kHeaderSize - offset : capacity;
+    memcpy(out, encoded + offset, count);
+    written = count;
+    offset += count;
+  }
+  // 按 snapshot 时的长度读取，而不是当前的 used：start() 会把 used 清零并从头覆盖缓冲区；
+  // 加锁避免与 record() 写同一段内存时读到写了一半的指令
+  if (buffer && written < capacity && lock()) {
+    memcpy(out + written, buffer + (offset - kHeaderSize), capacity - written);
+    written = capacity;
+    unlock();
+  }
+  return written;
+}
+
+bool Reader::open(const uint8_t* data, size_t length, String& error) {
+  if (length < kHeaderSize || memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+    error = "not a session recording";
+    return false;
+  }
+  if (data[4] != kFormatVersion) {
+    error = "unsupported recording version";
+    return false;
+  }
+  header_.version = data[4];
+  header_.model = static_cast<Model>(data[5]);
+  header_.gaitMode = data[6];
+  header_.flags = data[7];
+  header_.seed = getU32(data + 8);
+  const uint32_t speedBits = getU32(data + 12);
+  memcpy(&header_.speed, &speedBits, sizeof(speedBits));
+  header_.tickMs = getU16(data + 16);
+  header_.commandCount = getU32(data + 20);
+  header_.endTick = getU32(data + 24);
+  header_.droppedCommands = getU32(data + 28);
+  data_ = data;
+  length_ = length;
+  offset_ = kHeaderSize;
+  return true;
+}
+
+bool Reader::next(Command& command) {
+  if (offset_ + kCommandHeaderSize > length_) {
+    return false;
+  }
+  const uint8_t* in = data_ + offset_;
+  const uint16_t payloadLength = getU16(in + 6);
+  if (offset_ + kCommandHeaderSize + payloadLength > length_) {
+    return false;
+  }
+  command.tick = getU32(in);
+  command.source = static_cast<Source>(in[4]);
+  command.kind = in[5];
+  command.length = payloadLength;
+  command.payload = in + kCommandHeaderSize;
+  offset_ += kCommandHeaderSize + payloadLength;
+  return true;
+}
+
+}  // namespace sessionrec
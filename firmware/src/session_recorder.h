@@ -0,0 +1,106 @@
+// 控制会话录制（RAM，供主机回放做确定性回归比较）
+// - 记录各通道收到的原始指令字节（在解析之前：ArduinoJson 会就地改写接收缓冲）与到达时的控制周期序号；
+//   主机回放程序（sim/replay.cpp）按周期序号把指令送回同一套执行代码（command_dispatch.h），逐周期输出舵机帧
+// - 开始录制时记下机型、速度、步态与随机数种子（并用该种子重设随机数，见 rng::seedAll），
+//   要求机器人处于待机且没有动作在执行，回放从同一个初始状态出发
+// - 缓冲写满后不再追加（计入 droppedCommands），而不是覆盖最早的记录：回放必须从会话开头的状态开始
+// - 下载格式（小端）：
+//     头部 32 字节：magic "NHSR" | version u8 | model u8 | gaitMode u8 | flags u8 | seed u32 | speed f32 |
+//                   tickMs u16 | reserved u16 | commandCount u32 | endTick u32 | droppedCommands u32
+//     每条指令：tick u32 | source u8 | kind u8 | length u16 | payload[length]
+//   kind：WebSocket / Serial 通道为 0=JSON、1=MessagePack；SerialPacket 为二进制链路的 MessageId
+#pragma once
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace sessionrec {
+
+enum class Source : uint8_t {
+  WebSocket = 0,     // /cmd WebSocket
+  Serial = 1,        // UART2 文本链路，或二进制链路的 JsonCommand
+  SerialPacket = 2,  // 二进制链路的 SetMovement / Stop
+};
+
+enum class Model : uint8_t {
+  Hexapod = 0,
+  Quad = 1,
+};
+
+static constexpr uint8_t kFormatVersion = 1;
+static constexpr size_t kHeaderSize = 32;
+static constexpr size_t kCommandHeaderSize = 8;
+static constexpr size_t kCapacity = 16 * 1024;  // 指令区大小（首次开始录制时分配）
+
+static constexpr uint8_t kFlagRecording = 0x01;  // 下载时仍在录制
+static constexpr uint8_t kFlagOverflow = 0x02;   // 有指令因缓冲写满被丢弃
+// 录制开始时四足处于自动步态（gaitMode 为当时执行的步态）：回放先设置 gaitMode 与速度，再打开自动步态
+static constexpr uint8_t kFlagAutoGait = 0x04;
+
+struct Header {
+  uint8_t version = kFormatVersion;
+  Model model = Model::Hexapod;
+  uint8_t gaitMode = 0;
+  uint8_t flags = 0;
+  uint32_t seed = 0;
+  float speed = 1.0f;
+  uint16_t tickMs = 0;
+  uint32_t commandCount = 0;
+  uint32_t endTick = 0;  // 下载时已经过的控制周期数
+  uint32_t droppedCommands = 0;
+};
+
+struct Command {
+  uint32_t tick = 0;
+  Source source = Source::WebSocket;
+  uint8_t kind = 0;
+  uint16_t length = 0;
+  const uint8_t* payload = nullptr;
+};
+
+struct Stats {
+  bool recording = false;
+  uint32_t commands = 0;
+  uint32_t droppedCommands = 0;
+  uint32_t bytes = 0;  // 指令区已用字节
+  uint32_t ticks = 0;
+};
+
+void begin();
+
+// 开始录制（清空上一次的记录）；header 中的 model/gaitMode/seed/speed/tickMs 与 kFlagAutoGait 由调用方填写
+bool start(const Header& header, String& error);
+void stop();
+bool isRecording();
+
+// 主循环每个控制周期开始时调用一次
+void onLoopTick();
+
+// 各通道收到指令时调用（可在任意任务中调用，未在录制时直接返回）
+void record(Source source, uint8_t kind, const void* payload, size_t length);
+
+Stats getStats();
+
+// 下载：snapshot 固定本次下载的头部与总长度 total，之后按偏移分块读取，读取范围不超过 total；
+// 录制中新追加的指令不影响已固定的范围。下载期间重新开始录制时，读取仍停留在缓冲区内、长度不变，
+// 但后续分块会混入新录制的内容（下载结果失效）
+size_t snapshot(Header& header);
+size_t read(const Header& header, size_t total, size_t offset, uint8_t* out, size_t capacity);
+
+// 解析下载内容（主机回放使用）
+class Reader {
+public:
+  bool open(const uint8_t* data, size_t length, String& error);
+  const Header& header() const { return header_; }
+  // 按录制顺序取下一条指令，读完或数据截断时返回 false
+  bool next(Command& command);
+
+private:
+  const uint8_t* data_ = nullptr;
+  size_t length_ = 0;
+  size_t offset_ = 0;
+  Header header_;
+};
+
+}  // namespace sessionrec
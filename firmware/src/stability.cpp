@@ -0,0 +1,188 @@
+// 静态稳定裕度
+
+#include "stability.h"
+
+#include <cmath>
+
+namespace stability {
+
+namespace {
+
+struct Point2 {
+  float x;
+  float y;
+};
+
+float cross(const Point2& o, const Point2& a, const Point2& b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+float clampf(float value, float low, float high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+// 最小二乘拟合地面 z = a*x + b*y + c（3 点时为精确解）；退化（足端共线）时取水平面
+void fitGroundPlane(const hexapod::Point3D* pts, int n, float& a, float& b, float& c) {
+  float sx = 0, sy = 0, sz = 0, sxx = 0, syy = 0, sxy = 0, sxz = 0, syz = 0;
+  for (int i = 0; i < n; ++i) {
+    const float x = pts[i].x_;
+    const float y = pts[i].y_;
+    const float z = pts[i].z_;
+    sx += x;
+    sy += y;
+    sz += z;
+    sxx += x * x;
+    syy += y * y;
+    sxy += x * y;
+    sxz += x * z;
+    syz += y * z;
+  }
+  // | sxx sxy sx | |a|   |sxz|
+  // | sxy syy sy | |b| = |syz|
+  // | sx  sy  n  | |c|   |sz |
+  const float det = sxx * (syy * n - sy * sy) - sxy * (sxy * n - sy * sx) + sx * (sxy * sy - syy * sx);
+  if (std::fabs(det) < 1e-3f) {
+    a = 0.0f;
+    b = 0.0f;
+    c = sz / n;
+    return;
+  }
+  a = (sxz * (syy * n - sy * sy) - sxy * (syz * n - sy * sz) + sx * (syz * sy - syy * sz)) / det;
+  b = (sxx * (syz * n - sz * sy) - sxz * (sxy * n - sy * sx) + sx * (sxy * sz - syz * sx)) / det;
+  c = (sxx * (syy * sz - sy * syz) - sxy * (sxy * sz - sy * sxz) + sx * (sxy * syz - syy * sxz)) / det;
+}
+
+// Andrew 单调链凸包，输出逆时针顶点，返回顶点数
+int convexHull(Point2* pts, int n, Point2* hull) {
+  // n <= kMaxFeet，插入排序即可
+  for (int i = 1; i < n; ++i) {
+    const Point2 p = pts[i];
+    int j = i - 1;
+    while (j >= 0 && (pts[j].x > p.x || (pts[j].x == p.x && pts[j].y > p.y))) {
+      pts[j + 1] = pts[j];
+      --j;
+    }
+    pts[j + 1] = p;
+  }
+  int k = 0;
+  for (int i = 0; i < n; ++i) {
+    while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0.0f) {
+      --k;
+    }
+    hull[k++] = pts[i];
+  }
+  for (int i = n - 2, lower = k + 1; i >= 0; --i) {
+    while (k >= lower && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0.0f) {
+      --k;
+    }
+    hull[k++] = pts[i];
+  }
+  return k - 1;  // 首尾重复
+}
+
+}  // namespace
+
+Result evaluate(const hexapod::Point3D* feet, const bool* contact, int count, const Config& config) {
+  Result result;
+  hexapod::Point3D grounded[kMaxFeet];
+  int n = 0;
+  for (int i = 0; i < count && i < kMaxFeet; ++i) {
+    if (contact[i]) {
+      grounded[n++] = feet[i];
+    }
+  }
+  result.contacts = static_cast<uint8_t>(n);
+  if (n < 3) {
+    return result;
+  }
+
+  // 重心沿地面法线 (-a, -b, 1) 投影到拟合平面
+  float a, b, c;
+  fitGroundPlane(grounded, n, a, b, c);
+  const float cx = config.comOffsetXMm;
+  const float cy = config.comOffsetYMm;
+  const float cz = config.comOffsetZMm;
+  const float t = (cz - (a * cx + b * cy + c)) / (1.0f + a * a + b * b);
+  result.comX = cx + t * a;
+  result.comY = cy + t * b;
+
+  // 支撑多边形取足端的 XY 投影（机体倾斜 15° 以内时与平面内距离相差不到 4%）
+  Point2 pts[kMaxFeet];
+  Point2 hull[kMaxFeet + 1];
+  for (int i = 0; i < n; ++i) {
+    pts[i] = {grounded[i].x_, grounded[i].y_};
+  }
+  const int m = convexHull(pts, n, hull);
+  if (m < 3) {
+    return result;  // 足端共线，没有支撑面积
+  }
+
+  const Point2 com = {result.comX, result.comY};
+  float margin = 0.0f;
+  for (int i = 0; i < m; ++i) {
+    const Point2& p = hull[i];
+    const Point2& q = hull[(i + 1) % m];
+    const float length = std::sqrt((q.x - p.x) * (q.x - p.x) + (q.y - p.y) * (q.y - p.y));
+    if (length <= 0.0f) {
+      continue;
+    }
+    const float distance = cross(p, q, com) / length;
+    if (i == 0 || distance < margin) {
+      margin = distance;
+    }
+  }
+  result.marginMm = margin;
+  result.valid = true;
+  return result;
+}
+
+float Monitor::update(const hexapod::Point3D* feet, const bool* contact, int count, int elapsedMs, float pace) {
+  const Result result = evaluate(feet, contact, count, config_);
+  stats_.last = result;
+  ++stats_.evaluations;
+
+  // 全部触地时没有摆动腿可放慢；动态支撑相没有静态裕度
+  if (!config_.enabled || !result.valid || result.contacts >= count) {
+    pauseArmed_ = true;
+    dwellMs_ = 0;
+    stats_.timeScale = 1.0f;
+    return stats_.timeScale;
+  }
+
+  if (!stats_.minMarginValid || result.marginMm < stats_.minMarginMm) {
+    stats_.minMarginMm = result.marginMm;
+    stats_.minMarginValid = true;
+  }
+
+  pace = clampf(pace, 0.0f, 1.0f);
+  const float slowMargin = config_.slowMarginMm * pace;
+  const float pauseMargin = config_.pauseMarginMm * pace;
+
+  if (result.marginMm >= slowMargin) {
+    pauseArmed_ = true;
+    dwellMs_ = 0;
+    stats_.timeScale = 1.0f;
+    return stats_.timeScale;
+  }
+
+  if (result.marginMm < pauseMargin && pauseArmed_) {
+    if (dwellMs_ == 0) {
+      ++stats_.pauses;
+    }
+    dwellMs_ += elapsedMs;
+    if (dwellMs_ <= config_.settleMs) {
+      stats_.timeScale = 0.0f;
+      return stats_.timeScale;
+    }
+    pauseArmed_ = false;
+    dwellMs_ = 0;
+  }
+
+  ++stats_.slowedTicks;
+  const float span = slowMargin - pauseMargin;
+  const float ratio = span > 0.0f ? clampf((result.marginMm - pauseMargin) / span, 0.0f, 1.0f) : 0.0f;
+  stats_.timeScale = config_.minTimeScale + (1.0f - config_.minTimeScale) * ratio;
+  return stats_.timeScale;
+}
+
+}  // namespace stability
@@ -0,0 +1,71 @@
+// 静态稳定裕度（与平台无关，可在主机上直接编译）
+// - 触地状态由步态相位给出（见 Movement::contactStates / QuadMovement::contactStates），不依赖足端高度的粗略判断
+// - 用触地足端拟合地面平面，重心（机体原点 + 偏移）沿地面法线投影，机体的 roll/pitch/平移姿态因此自然计入
+// - 裕度为重心投影到支撑多边形各边的最小有符号距离（内部为正，mm）；触地腿少于 3 条（trot/gallop 的双腿支撑相）
+//   属于动态平衡，不计算静态裕度
+// - Monitor 按裕度给出步态时间推进倍率：低于 slowMarginMm 线性放慢摆动，低于 pauseMarginMm 时先停顿 settleMs
+//   等机体稳住（每次进入只停一次，避免步态卡死），之后以最低倍率继续
+// - 两个阈值按步态速度（pace，0~1）缩放：低速接近准静态，裕度为 0 也能走稳；速度越高惯性越大，需要的裕度越多
+#pragma once
+
+#include <cstdint>
+
+#include "base.h"
+
+namespace stability {
+
+static constexpr int kMaxFeet = 6;
+
+struct Config {
+  bool enabled = true;
+  float comOffsetXMm = 0.0f;   // 重心相对机体原点的偏移（机体坐标系：X 向右，Y 向前，Z 向上）
+  float comOffsetYMm = 0.0f;
+  float comOffsetZMm = 0.0f;
+  float slowMarginMm = 15.0f;  // 全速时低于该裕度开始放慢
+  float pauseMarginMm = 5.0f;  // 全速时低于该裕度先停顿
+  float minTimeScale = 0.35f;
+  int settleMs = 80;
+};
+
+struct Result {
+  bool valid = false;        // 触地腿 >= 3 时才有静态裕度
+  uint8_t contacts = 0;
+  float marginMm = 0.0f;
+  float comX = 0.0f;         // 重心在地面上的投影（机体坐标系 XY）
+  float comY = 0.0f;
+};
+
+struct Stats {
+  Result last;
+  float timeScale = 1.0f;
+  float minMarginMm = 0.0f;  // 摆动期间出现过的最小裕度（未出现过时为 0）
+  bool minMarginValid = false;
+  uint32_t evaluations = 0;
+  uint32_t slowedTicks = 0;
+  uint32_t pauses = 0;
+};
+
+// 计算支撑多边形与重心投影；feet 为机体坐标系下的足端位置，contact 为对应的触地状态
+Result evaluate(const hexapod::Point3D* feet, const bool* contact, int count, const Config& config);
+
+class Monitor {
+public:
+  Monitor() = default;
+  explicit Monitor(const Config& config) : config_(config) {}
+
+  // 计算本周期的稳定裕度，返回步态时间推进倍率（0 表示本周期停顿）；pace 为当前步态速度相对最高速度的比例
+  float update(const hexapod::Point3D* feet, const bool* contact, int count, int elapsedMs, float pace);
+
+  const Result& result() const { return stats_.last; }
+  const Stats& stats() const { return stats_; }
+  const Config& config() const { return config_; }
+  void setConfig(const Config& config) { config_ = config; }
+
+private:
+  Config config_;
+  Stats stats_;
+  bool pauseArmed_ = true;
+  int dwellMs_ = 0;
+};
+
+}  // namespace stability
@@ -0,0 +1,335 @@
+// 持久化存储层（LittleFS）
+
+#include "storage.h"
+
+#include <LittleFS.h>
+#include <SPIFFS.h>
+
+#include "debug.h"
+
+namespace storage {
+
+namespace {
+
+static constexpr uint32_t kRecordMagic = 0x3152484E;  // "NHR1"
+static constexpr uint16_t kRecordVersion = 1;
+static constexpr size_t kHeaderSize = 16;
+static constexpr size_t kMaxRecordSize = 8192;
+static constexpr size_t kMaxPathLength = 32;
+
+// 旧固件（SPIFFS）中的校准文件：迁移为带校验的记录
+static constexpr const char* kMigratePaths[] = {
+  "/calibration.json",
+  "/calibration_quad.json",
+};
+// 其它文件（网页资源、/text.txt 等）按原样迁移；格式化前要全部读进内存，
+// 总量受空闲堆限制（留出余量），放不下的文件需要重新烧录文件系统镜像（pio run -t uploadfs）
+static constexpr size_t kMigrateMaxFiles = 32;
+static constexpr size_t kMigrateHeapReserve = 48 * 1024;
+
+struct RecordHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t length;
+  uint32_t crc;
+};
+static_assert(sizeof(RecordHeader) == kHeaderSize, "record header layout");
+
+bool mounted = false;
+Timings timings;
+
+// CRC-32（IEEE 802.3，反射多项式 0xEDB88320），半字节查表
+uint32_t recordCrc32(const uint8_t* data, size_t len) {
+  static const uint32_t kTable[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+  };
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; ++i) {
+    crc = kTable[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+    crc = kTable[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return crc ^ 0xFFFFFFFF;
+}
+
+// 读取文件剩余内容（不用 Stream::readString，它在文件末尾会等待读超时）
+void readRemaining(File& file, String& out) {
+  out = "";
+  out.reserve(file.size() - file.position());
+  char chunk[64];
+  size_t n;
+  while ((n = file.read(reinterpret_cast<uint8_t*>(chunk), sizeof(chunk))) > 0) {
+    out.concat(chunk, n);
+  }
+}
+
+bool readHeader(File& file, RecordHeader& header) {
+  if (file.size() < kHeaderSize) {
+    return false;
+  }
+  if (file.read(reinterpret_cast<uint8_t*>(&header), kHeaderSize) != kHeaderSize) {
+    return false;
+  }
+  return header.magic == kRecordMagic;
+}
+
+bool isMigratePath(const String& path) {
+  for (const char* p : kMigratePaths) {
+    if (path == p) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct MigratedFile {
+  String path;
+  uint8_t* data = nullptr;
+  size_t length = 0;
+};
+
+// 读取旧 SPIFFS 分区中的文件，然后格式化为 LittleFS 并写回
+bool migrateFromSpiffs() {
+  static const size_t kCount = sizeof(kMigratePaths) / sizeof(kMigratePaths[0]);
+  String contents[kCount];
+  bool found[kCount] = {};
+  MigratedFile files[kMigrateMaxFiles];
+  size_t fileCount = 0;
+
+  if (SPIFFS.begin(false)) {
+    for (size_t i = 0; i < kCount; ++i) {
+      File file = SPIFFS.open(kMigratePaths[i], FILE_READ);
+      if (file && file.size() > 0 && file.size() <= kMaxRecordSize) {
+        readRemaining(file, contents[i]);
+        found[i] = true;
+      }
+      if (file) {
+        file.close();
+      }
+    }
+
+    File root = SPIFFS.open("/");
+    for (File file = root.openNextFile(); file; file = root.openNextFile()) {
+      const String path = file.path();
+      const size_t length = file.size();
+      if (file.isDirectory() || isMigratePath(path)) {
+        file.close();
+        continue;
+      }
+      const uint32_t freeHeap = ESP.getFreeHeap();
+      uint8_t* data = nullptr;
+      if (fileCount < kMigrateMaxFiles && freeHeap > kMigrateHeapReserve && length <= freeHeap - kMigrateHeapReserve) {
+        data = static_cast<uint8_t*>(malloc(length ? length : 1));
+      }
+      if (data && file.read(data, length) == length) {
+        files[fileCount].path = path;
+        files[fileCount].data = data;
+        files[fileCount].length = length;
+        ++fileCount;
+      } else {
+        free(data);
+        ++timings.migrateSkipped;
+        char buffer[96];
+        snprintf(buffer, sizeof(buffer), "[Storage] not migrated (no memory): %s", path.c_str());
+        LOG_INFO(buffer);
+      }
+      file.close();
+    }
+    root.close();
+    SPIFFS.end();
+  }
+
+  if (!LittleFS.begin(true)) {
+    for (size_t i = 0; i < fileCount; ++i) {
+      free(files[i].data);
+    }
+    return false;
+  }
+  mounted = true;
+
+  for (size_t i = 0; i < fileCount; ++i) {
+    File out = LittleFS.open(files[i].path.c_str(), FILE_WRITE, true);
+    if (!out || out.write(files[i].data, files[i].length) != files[i].length) {
+      ++timings.migrateSkipped;
+      char buffer[96];
+      snprintf(buffer, sizeof(buffer), "[Storage] migrate %s failed: write error", files[i].path.c_str());
+      LOG_INFO(buffer);
+    }
+    if (out) {
+      out.close();
+    }
+    free(files[i].data);
+  }
+  if (timings.migrateSkipped > 0) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer),
+             "[Storage] %u file(s) were not migrated; reflash the filesystem image (pio run -t uploadfs)",
+             static_cast<unsigned>(timings.migrateSkipped));
+    LOG_INFO(buffer);
+  }
+
+  for (size_t i = 0; i < kCount; ++i) {
+    if (!found[i]) {
+      continue;
+    }
+    String error;
+    if (!writeRecord(kMigratePaths[i], contents[i], error)) {
+      char buffer[96];
+      snprintf(buffer, sizeof(buffer), "[Storage] migrate %s failed: %s", kMigratePaths[i], error.c_str());
+      LOG_INFO(buffer);
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool begin() {
+  if (mounted) {
+    return true;
+  }
+
+  const uint32_t start = millis();
+  if (LittleFS.begin(false)) {
+    mounted = true;
+  } else {
+    // 分区不是 LittleFS：旧固件升级上来的设备，或全新设备
+    LOG_INFO("[Storage] LittleFS mount failed, migrating from SPIFFS");
+    timings.migrated = migrateFromSpiffs();
+  }
+  timings.mountMs = millis() - start;
+
+  char buffer[96];
+  snprintf(buffer, sizeof(buffer), "[Storage] LittleFS %s in %ums%s",
+           mounted ? "mounted" : "unavailable",
+           static_cast<unsigned>(timings.mountMs),
+           timings.migrated ? " (migrated)" : "");
+  LOG_INFO(buffer);
+  return mounted;
+}
+
+bool isMounted() {
+  return mounted;
+}
+
+fs::FS& filesystem() {
+  return LittleFS;
+}
+
+bool exists(const char* path) {
+  return mounted && LittleFS.exists(path);
+}
+
+bool writeRecord(const char* path, const String& payload, String& error) {
+  if (!mounted) {
+    error = "filesystem not mounted";
+    return false;
+  }
+  if (strlen(path) + 4 >= kMaxPathLength || payload.length() > kMaxRecordSize) {
+    error = "path or payload too long";
+    return false;
+  }
+
+  const uint32_t start = micros();
+  RecordHeader header;
+  header.magic = kRecordMagic;
+  header.version = kRecordVersion;
+  header.reserved = 0;
+  header.length = payload.length();
+  header.crc = recordCrc32(reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length());
+
+  // 内容未变化（长度与 CRC 相同）时不写 flash
+  File current = LittleFS.open(path, FILE_READ);
+  if (current) {
+    RecordHeader existing;
+    const bool same = readHeader(current, existing)
+        && existing.length == header.length
+        && existing.crc == header.crc;
+    current.close();
+    if (same) {
+      ++timings.skippedWrites;
+      return true;
+    }
+  }
+
+  char tmpPath[kMaxPathLength];
+  snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+  File file = LittleFS.open(tmpPath, FILE_WRITE);
+  if (!file) {
+    error = "failed to open temp file";
+    return false;
+  }
+  const bool written = file.write(reinterpret_cast<const uint8_t*>(&header), kHeaderSize) == kHeaderSize
+      && file.write(reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length()) == payload.length();
+  file.close();
+  if (!written) {
+    LittleFS.remove(tmpPath);
+    error = "failed to write temp file";
+    return false;
+  }
+
+  if (!LittleFS.rename(tmpPath, path)) {
+    LittleFS.remove(tmpPath);
+    error = "failed to commit file";
+    return false;
+  }
+
+  ++timings.writes;
+  timings.lastWriteUs = micros() - start;
+  return true;
+}
+
+bool readRecord(const char* path, String& payload, String& error) {
+  if (!mounted) {
+    error = "filesystem not mounted";
+    return false;
+  }
+
+  const uint32_t start = micros();
+  File file = LittleFS.open(path, FILE_READ);
+  if (!file) {
+    error = "not found";
+    return false;
+  }
+
+  RecordHeader header;
+  if (!readHeader(file, header)) {
+    // 没有记录头：旧版直接写入的 JSON，原样返回（下次保存时升级为带 CRC 的格式）
+    file.seek(0);
+    readRemaining(file, payload);
+    file.close();
+    timings.lastReadUs = micros() - start;
+    if (payload.length() == 0) {
+      error = "empty file";
+      return false;
+    }
+    return true;
+  }
+
+  if (header.version != kRecordVersion || header.length > kMaxRecordSize
+      || header.length != file.size() - kHeaderSize) {
+    file.close();
+    ++timings.crcErrors;
+    error = "invalid record header";
+    return false;
+  }
+
+  readRemaining(file, payload);
+  file.close();
+  timings.lastReadUs = micros() - start;
+
+  if (payload.length() != header.length
+      || recordCrc32(reinterpret_cast<const uint8_t*>(payload.c_str()), payload.length()) != header.crc) {
+    ++timings.crcErrors;
+    error = "crc mismatch";
+    return false;
+  }
+  return true;
+}
+
+Timings getTimings() {
+  return timings;
+}
+
+}  // namespace storage
@@ -0,0 +1,43 @@
+// 持久化存储层（LittleFS）
+// - 记录格式：16 字节头（魔数、版本、长度、CRC32）+ 内容，读取时校验，损坏可被识别而不是静默回退
+// - 原子写：先写 <path>.tmp 再 rename 覆盖（LittleFS 的 rename 为原子替换），掉电时旧文件保持完整
+// - 内容未变化时跳过写入，减少 flash 擦写
+// - 首次从旧固件（SPIFFS 分区）升级时，先把分区中的文件读到内存，格式化为 LittleFS 后写回：
+//   校准文件转为记录格式，其它文件（网页资源等）原样写回；内存放不下的文件计入 migrateSkipped 并打印日志，
+//   这种情况需要重新烧录文件系统镜像（pio run -t uploadfs），否则网页会 404（WEB_ASSETS_EMBEDDED 除外）
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+namespace storage {
+
+struct Timings {
+  uint32_t mountMs = 0;        // 挂载（含迁移）耗时
+  bool migrated = false;       // 本次启动是否执行了 SPIFFS -> LittleFS 迁移
+  uint32_t migrateSkipped = 0; // 迁移时因内存不足或写入失败而丢失的文件数
+  uint32_t lastReadUs = 0;
+  uint32_t lastWriteUs = 0;
+  uint32_t writes = 0;
+  uint32_t skippedWrites = 0;  // 内容相同而跳过的写入
+  uint32_t crcErrors = 0;
+};
+
+// 挂载文件系统（setup() 中调用一次），失败返回 false
+bool begin();
+bool isMounted();
+
+// 底层文件系统（网页资源等只读文件直接使用）
+fs::FS& filesystem();
+
+bool exists(const char* path);
+
+// 原子写入一条记录
+bool writeRecord(const char* path, const String& payload, String& error);
+
+// 读取并校验一条记录；兼容没有记录头的旧版纯 JSON 文件
+bool readRecord(const char* path, String& payload, String& error);
+
+Timings getTimings();
+
+}  // namespace storage
@@ -0,0 +1,172 @@
+// 模式切换过渡的时长与延迟统计
+
+#include "transition_timing.h"
+
+#include <math.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "config.h"
+
+namespace transition {
+
+namespace {
+
+constexpr int kModeCount = hexapod::MOVEMENT_TOTAL;
+
+SemaphoreHandle_t mutex = nullptr;
+PairStats pairs[kModeCount][kModeCount];
+PairStats gaits[kMaxGaits];
+
+// 控制任务内的状态（只在 onTick 中读写）
+hexapod::MovementMode current = hexapod::MOVEMENT_STANDBY;
+hexapod::MovementMode from = hexapod::MOVEMENT_STANDBY;
+bool pending = false;
+uint32_t pendingMs = 0;
+int pendingGait = 0;
+
+bool lock() {
+  return mutex && xSemaphoreTake(mutex, portMAX_DELAY) == pdTRUE;
+}
+
+void unlock() {
+  xSemaphoreGive(mutex);
+}
+
+bool validMode(hexapod::MovementMode mode) {
+  return mode >= 0 && mode < kModeCount;
+}
+
+void addSample(PairStats& stats, uint32_t ms) {
+  if (stats.count == 0 || ms < stats.minMs) {
+    stats.minMs = ms;
+  }
+  if (ms > stats.maxMs) {
+    stats.maxMs = ms;
+  }
+  stats.count++;
+  stats.lastMs = ms;
+  stats.totalMs += ms;
+}
+
+}  // namespace
+
+float jointTravelMs(const float from[3], const float to[3], const float limitsDegPerSec[3]) {
+  float slowest = 0.0f;
+  for (int j = 0; j < 3; ++j) {
+    const float limit = limitsDegPerSec[j];
+    if (limit <= 0.0f) {
+      continue;
+    }
+    const float ms = fabsf(to[j] - from[j]) * 1000.0f / limit;
+    if (ms > slowest) {
+      slowest = ms;
+    }
+  }
+  return slowest;
+}
+
+float pathTravelMs(const float angles[][3], int segments, const float limitsDegPerSec[3]) {
+  float slowest = 0.0f;
+  for (int s = 0; s < segments; ++s) {
+    const float ms = jointTravelMs(angles[s], angles[s + 1], limitsDegPerSec);
+    if (ms > slowest) {
+      slowest = ms;
+    }
+  }
+  return slowest * segments;
+}
+
+int durationMs(float travelMs, float speed, int minMs) {
+  const int period = hexapod::config::movementInterval;
+  if (speed <= 0.0f) {
+    speed = 1.0f;
+  }
+  int ms = static_cast<int>(ceilf(travelMs / speed));
+  if (ms < minMs) {
+    ms = minMs;
+  }
+  if (ms < period) {
+    ms = period;
+  }
+  const int r = ms % period;
+  return r == 0 ? ms : ms + (period - r);
+}
+
+void begin() {
+  if (!mutex) {
+    mutex = xSemaphoreCreateMutex();
+  }
+}
+
+void onTick(hexapod::MovementMode requested, bool transitioning, int elapsedMs, int gait) {
+  if (!validMode(requested)) {
+    return;
+  }
+
+  if (requested != current) {
+    if (pending && lock()) {
+      pairs[from][current].interrupted++;
+      gaits[pendingGait].interrupted++;
+      unlock();
+    }
+    from = current;
+    current = requested;
+    pending = true;
+    pendingMs = 0;
+    pendingGait = gait >= 0 && gait < kMaxGaits ? gait : 0;
+  }
+
+  if (!pending) {
+    return;
+  }
+  if (elapsedMs > 0) {
+    pendingMs += static_cast<uint32_t>(elapsedMs);
+  }
+  if (transitioning) {
+    return;
+  }
+
+  pending = false;
+  if (lock()) {
+    addSample(pairs[from][current], pendingMs);
+    addSample(gaits[pendingGait], pendingMs);
+    unlock();
+  }
+}
+
+bool pairStats(hexapod::MovementMode fromMode, hexapod::MovementMode toMode, PairStats& out) {
+  if (!validMode(fromMode) || !validMode(toMode) || !lock()) {
+    return false;
+  }
+  out = pairs[fromMode][toMode];
+  unlock();
+  return out.count > 0 || out.interrupted > 0;
+}
+
+bool gaitStats(int gait, PairStats& out) {
+  if (gait < 0 || gait >= kMaxGaits || !lock()) {
+    return false;
+  }
+  out = gaits[gait];
+  unlock();
+  return out.count > 0 || out.interrupted > 0;
+}
+
+void resetStats() {
+  if (!lock()) {
+    return;
+  }
+  for (int i = 0; i < kModeCount; ++i) {
+    for (int j = 0; j < kModeCount; ++j) {
+      pairs[i][j] = PairStats();
+    }
+  }
+  for (int i = 0; i < kMaxGaits; ++i) {
+    gaits[i] = PairStats();
+  }
+  unlock();
+}
+
+}  // namespace transition
@@ -0,0 +1,56 @@
+// 模式切换过渡的时长与延迟统计
+// - 过渡时长由关节空间距离决定：各腿各关节起止角度差除以该关节的限速（config::jointSpeedLimitDegPerSec，
+//   四足为 quadJointSpeedLimitDegPerSec），
+//   取最慢的一个，再按速度倍率缩放并向上取整到控制周期。小的切换不再等满固定时长，
+//   大的切换也不会要求舵机转得比它能跟上的更快
+// - 平滑插值（smoothstep）中段的角速度是平均值的 1.5 倍，按峰值计算
+// - 延迟统计：每个控制周期记录请求的模式与机器人是否仍在过渡，得到每个 (from, to) 模式对从请求到
+//   过渡结束的时长；过渡途中又切换到其他模式的记为 interrupted。另按步态（四足 trot/walk/gallop/creep，
+//   六足只有 0）汇总所有模式对，比较不同步态的切换延迟
+#pragma once
+
+#include <cstdint>
+
+#include "movement.h"
+
+namespace transition {
+
+// smoothstep 插值的峰值角速度 / 平均角速度
+static constexpr float kSmoothstepPeakRatio = 1.5f;
+
+// 单条腿从 from 转到 to（度）在关节限速 limitsDegPerSec 下的最短时长（ms，1.0 倍速）
+float jointTravelMs(const float from[3], const float to[3], const float limitsDegPerSec[3]);
+
+// 足端沿直线插值时关节角的变化并不均匀（只看起止角度差会低估中段的角速度）：
+// 调用方在路径上等分 kPathSegments 段取各点关节角（angles[0..segments]），按最慢一段计时
+static constexpr int kPathSegments = 4;
+float pathTravelMs(const float angles[][3], int segments, const float limitsDegPerSec[3]);
+
+// 过渡时长：travelMs 按速度倍率缩放，向上取整到控制周期，且不短于 minMs
+int durationMs(float travelMs, float speed, int minMs);
+
+struct PairStats {
+  uint32_t count = 0;        // 完成的过渡次数
+  uint32_t interrupted = 0;  // 过渡中被新的模式请求打断的次数
+  uint32_t lastMs = 0;
+  uint32_t minMs = 0;
+  uint32_t maxMs = 0;
+  uint32_t totalMs = 0;
+};
+
+static constexpr int kMaxGaits = 4;
+
+void begin();
+
+// 每个控制周期调用一次（cmddispatch::runTick），elapsedMs 为本周期时长，gait 为当前步态（计入请求时的步态）
+void onTick(hexapod::MovementMode requested, bool transitioning, int elapsedMs, int gait);
+
+// 取某个模式对的统计，没有记录时返回 false
+bool pairStats(hexapod::MovementMode from, hexapod::MovementMode to, PairStats& out);
+
+// 取某个步态下所有模式对的汇总，没有记录时返回 false
+bool gaitStats(int gait, PairStats& out);
+
+void resetStats();
+
+}  // namespace transition
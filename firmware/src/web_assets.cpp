@@ -0,0 +1,167 @@
+// Web UI 静态资源发送（预压缩 + ETag）
+
+#include "web_assets.h"
+
+#include "debug.h"
+#include "storage.h"
+
+#if WEB_ASSETS_EMBEDDED
+#include "generated/web_assets_data.h"
+#endif
+
+namespace webassets {
+
+namespace {
+
+static constexpr const char* kManifestPath = "/web_assets.idx";
+static constexpr const char* kCacheControl = "no-cache";  // 允许缓存，但每次用 ETag 重新验证
+static constexpr size_t kMaxAssets = 16;
+static constexpr size_t kMaxPathLength = 32;   // 文件名上限（LittleFS 配置 / 旧 SPIFFS 限制）
+static constexpr size_t kMaxEtagLength = 24;
+
+struct Asset {
+  char path[kMaxPathLength];
+  char etag[kMaxEtagLength];
+  uint32_t size;
+  const uint8_t* data;  // 内嵌模式下指向 flash 中的 gzip 内容，否则为 nullptr（从文件系统读取）
+};
+
+Asset assets[kMaxAssets];
+size_t assetTotal = 0;
+Stats stats;
+
+const Asset* findAsset(const char* path) {
+  for (size_t i = 0; i < assetTotal; ++i) {
+    if (strcmp(assets[i].path, path) == 0) {
+      return &assets[i];
+    }
+  }
+  return nullptr;
+}
+
+bool addAsset(const char* path, const char* etag, uint32_t size, const uint8_t* data) {
+  if (assetTotal >= kMaxAssets || strlen(path) >= kMaxPathLength || strlen(etag) >= kMaxEtagLength) {
+    return false;
+  }
+  Asset& asset = assets[assetTotal++];
+  strncpy(asset.path, path, sizeof(asset.path));
+  strncpy(asset.etag, etag, sizeof(asset.etag));
+  asset.size = size;
+  asset.data = data;
+  return true;
+}
+
+// 解析一行 "<path> <etag> <size>"
+bool parseLine(const String& line) {
+  const int first = line.indexOf(' ');
+  const int second = (first > 0) ? line.indexOf(' ', first + 1) : -1;
+  if (first <= 0 || second <= first + 1) {
+    return false;
+  }
+  const String path = line.substring(0, first);
+  const String etag = line.substring(first + 1, second);
+  const uint32_t size = static_cast<uint32_t>(line.substring(second + 1).toInt());
+  return addAsset(path.c_str(), etag.c_str(), size, nullptr);
+}
+
+#if !WEB_ASSETS_EMBEDDED
+void loadManifest() {
+  File file = storage::filesystem().open(kManifestPath, "r");
+  if (!file) {
+    LOG_INFO("[WebAssets] manifest not found, serving raw files");
+    return;
+  }
+
+  while (file.available() && assetTotal < kMaxAssets) {
+    String line = file.readStringUntil('\n');
+    line.trim();
+    if (line.length() > 0) {
+      parseLine(line);
+    }
+  }
+  file.close();
+}
+#endif
+
+bool etagMatches(AsyncWebServerRequest* request, const Asset& asset) {
+  AsyncWebHeader* header = request->getHeader("If-None-Match");
+  if (!header) {
+    return false;
+  }
+  const String& value = header->value();
+  // 可能是逗号分隔的多个 ETag（含 W/ 前缀），按子串匹配即可
+  return value == "*" || value.indexOf(asset.etag) >= 0;
+}
+
+}  // namespace
+
+void init() {
+  assetTotal = 0;
+#if WEB_ASSETS_EMBEDDED
+  for (size_t i = 0; i < embedded::kAssetCount; ++i) {
+    const embedded::EmbeddedAsset& asset = embedded::kAssets[i];
+    addAsset(asset.path, asset.etag, asset.size, asset.data);
+  }
+#else
+  loadManifest();
+#endif
+
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "[WebAssets] %u gzip assets loaded (%s)",
+           static_cast<unsigned>(assetTotal), WEB_ASSETS_EMBEDDED ? "flash" : "littlefs");
+  LOG_INFO(buffer);
+}
+
+size_t assetCount() {
+  return assetTotal;
+}
+
+bool send(AsyncWebServerRequest* request, const char* path, const char* contentType) {
+  const Asset* asset = findAsset(path);
+  if (!asset) {
+    return false;
+  }
+
+  if (etagMatches(request, *asset)) {
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", kCacheControl);
+    request->send(response);
+    ++stats.notModified;
+    return true;
+  }
+
+  if (asset->data) {
+    // 内嵌资源：按 TCP 窗口分块直接从映射的 flash 拷贝到发送缓冲区，不占用整页大小的 RAM
+    AsyncWebServerResponse* response = request->beginResponse_P(200, contentType, asset->data, asset->size);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset->etag);
+    response->addHeader("Cache-Control", kCacheControl);
+    request->send(response);
+    ++stats.served;
+    stats.bytesSent += asset->size;
+    return true;
+  }
+
+  // 直接打开 .gz（跳过 exists() 与库内的 .gz 探测），库根据文件名自动加 Content-Encoding: gzip
+  char gzPath[kMaxPathLength + 4];
+  snprintf(gzPath, sizeof(gzPath), "%s.gz", path);
+  File file = storage::filesystem().open(gzPath, "r");
+  if (!file) {
+    return false;
+  }
+
+  AsyncWebServerResponse* response = request->beginResponse(file, path, contentType);
+  response->addHeader("ETag", asset->etag);
+  response->addHeader("Cache-Control", kCacheControl);
+  request->send(response);
+  ++stats.served;
+  stats.bytesSent += asset->size;
+  return true;
+}
+
+Stats getStats() {
+  return stats;
+}
+
+}  // namespace webassets
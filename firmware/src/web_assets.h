@@ -0,0 +1,35 @@
+// Web UI 静态资源发送
+// - 构建时由 scripts/build_web_assets.py 压缩 + gzip，并生成 /web_assets.idx 清单（路径、ETag、字节数）
+// - 命中清单的资源以 Content-Encoding: gzip 发送，带强 ETag，If-None-Match 命中时返回 304
+// - 清单缺失（例如直接上传未处理的 data 目录）时调用方回退到原始文件
+// - WEB_ASSETS_EMBEDDED=1 时资源编译进固件（src/generated/web_assets_data.h，构建时生成），
+//   直接从映射的 flash 发送，请求路径上不访问文件系统
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+#ifndef WEB_ASSETS_EMBEDDED
+#define WEB_ASSETS_EMBEDDED 0
+#endif
+
+namespace webassets {
+
+struct Stats {
+  uint32_t served = 0;        // 完整响应次数
+  uint32_t notModified = 0;   // 304 次数
+  uint32_t bytesSent = 0;     // 完整响应的 gzip 字节数累计
+};
+
+// 加载清单（需在 storage::begin() 之后调用一次；内嵌模式下不读取文件系统）
+void init();
+
+// 清单中的资源数量（0 表示未启用预压缩资源）
+size_t assetCount();
+
+// 发送资源；返回 false 表示清单中没有该资源或文件缺失，由调用方回退处理
+bool send(AsyncWebServerRequest* request, const char* path, const char* contentType);
+
+Stats getStats();
+
+}  // namespace webassets